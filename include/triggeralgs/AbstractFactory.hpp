@@ -14,6 +14,7 @@
 #include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace triggeralgs {
 
@@ -33,6 +34,9 @@ class AbstractFactory
 
     static void register_creator(const std::string alg_name, maker_creator creator);
 
+    // Names of every registered algorithm, sorted alphabetically.
+    static std::vector<std::string> get_registered_algorithms();
+
     static std::shared_ptr<AbstractFactory<T>> get_instance();
 
   protected:
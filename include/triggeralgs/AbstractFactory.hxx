@@ -10,6 +10,12 @@
 
 #include "triggeralgs/Issues.hpp"
 
+#ifdef TRIGGERALGS_INSTRUMENTATION
+#include "triggeralgs/InstrumentedMaker.hpp"
+#endif
+
+#include <algorithm>
+
 namespace triggeralgs {
 
 template <typename T>
@@ -35,6 +41,19 @@ void AbstractFactory<T>::register_creator(const std::string alg_name, maker_crea
   return;
 }
 
+template <typename T>
+std::vector<std::string> AbstractFactory<T>::get_registered_algorithms()
+{
+  creation_map& makers = get_makers();
+  std::vector<std::string> alg_names;
+  alg_names.reserve(makers.size());
+  for (const auto& maker : makers) {
+    alg_names.push_back(maker.first);
+  }
+  std::sort(alg_names.begin(), alg_names.end());
+  return alg_names;
+}
+
 template <typename T>
 std::unique_ptr<T> AbstractFactory<T>::build_maker(const std::string& alg_name)
 {
@@ -43,7 +62,11 @@ std::unique_ptr<T> AbstractFactory<T>::build_maker(const std::string& alg_name)
 
   if (it != makers.end()) {
     TLOG() << "[AF] Factory building " << alg_name << ".";
+#ifdef TRIGGERALGS_INSTRUMENTATION
+    return instrument_maker(it->second());
+#else
     return it->second();
+#endif
   }
 
   throw FactoryNotFound(ERS_HERE, alg_name);
@@ -19,6 +19,7 @@ class TriggerActivityMakerBundleN : public TriggerActivityMaker
 {
   public:
     void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_tas);
+    void operator()(Span<const TriggerPrimitive> input_tps, std::vector<TriggerActivity>& output_tas);
     void configure(const nlohmann::json& config);
     bool bundle_condition();
 
@@ -26,6 +27,7 @@ class TriggerActivityMakerBundleN : public TriggerActivityMaker
       uint64_t m_bundle_size = 1;
       TriggerActivity m_current_ta;
       void set_ta_attributes();
+      void emit_ta(std::vector<TriggerActivity>& output_tas);
 };
 
 } // namespace triggeralgs
@@ -19,6 +19,7 @@ class TriggerCandidateMakerBundleN : public TriggerCandidateMaker
 {
   public:
     void operator()(const TriggerActivity& input_ta, std::vector<TriggerCandidate>& output_tcs);
+    void operator()(Span<const TriggerActivity> input_tas, std::vector<TriggerCandidate>& output_tcs);
     void configure(const nlohmann::json& config);
     bool bundle_condition();
 
@@ -26,6 +27,7 @@ class TriggerCandidateMakerBundleN : public TriggerCandidateMaker
       uint64_t m_bundle_size = 1;
       TriggerCandidate m_current_tc;
       void set_tc_attributes();
+      void emit_tc(std::vector<TriggerCandidate>& output_tcs);
 };
 
 } // namespace triggeralgs
@@ -11,7 +11,9 @@
 
 #include "triggeralgs/TPWindow.hpp"
 #include "triggeralgs/TriggerActivityFactory.hpp"
+#include <cstddef>
 #include <fstream>
+#include <utility>
 #include <vector>
 
 namespace triggeralgs {
@@ -19,15 +21,34 @@ class TriggerActivityMakerChannelAdjacency : public TriggerActivityMaker
 {
 public:
   void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta);
+  void operator()(Span<const TriggerPrimitive> input_tps, std::vector<TriggerActivity>& output_ta);
+  void flush(timestamp_t until, std::vector<TriggerActivity>& output_ta);
+  std::size_t window_occupancy() const { return m_current_window.size(); }
   void configure(const nlohmann::json& config);
 
 private:
-  TriggerActivity construct_ta(TPWindow) const;
+  // The TA of the track made of the hit channels from `first` to `last` in
+  // m_channels.
+  TriggerActivity construct_ta(std::size_t first, std::size_t last);
 
-  TPWindow check_adjacency();
+  void index_channels();
+  bool make_track_tas(std::vector<TriggerActivity>& output_ta);
 
   TPWindow m_current_window;
 
+  // The hit channels of the window, for make_track_tas().
+  struct ChannelHits
+  {
+    unsigned int channel;
+    std::size_t first_tp; // Positions in the window of its first and last TP
+    std::size_t last_tp;
+    std::size_t next;     // The next hit channel not yet taken by a track
+  };
+  std::vector<std::pair<channel_t, std::size_t>> m_sorted_tps; // Channel and position in the window
+  std::vector<ChannelHits> m_channels;                         // In order of channel
+  std::vector<std::pair<std::size_t, std::size_t>> m_runs;     // Starts of the runs passed, with the channel before
+  std::vector<TriggerPrimitive> m_track;
+
   // Configurable parameters.
   bool m_print_tp_info = false;        // Prints out some information on every TP received
   uint16_t m_adjacency_threshold = 15; // Default is 15 wire track for testing
@@ -37,7 +58,7 @@ private:
   uint16_t m_prescale = 1;             // Prescale value, defult is one, trigger every TA
 
   // For debugging and performance study purposes.
-  void add_window_to_record(TPWindow window);
+  void add_window_to_record(const TPWindow& window);
   std::vector<TPWindow> m_window_record;
 };
 } // namespace triggeralgs
@@ -17,6 +17,8 @@ namespace triggeralgs {
 class TriggerActivityMakerChannelDistance : public TriggerActivityMaker {
   public:
     void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_tas);
+    void flush(timestamp_t until, std::vector<TriggerActivity>& output_tas);
+    std::size_t window_occupancy() const { return m_current_ta.inputs.size(); }
     void configure(const nlohmann::json& config);
     void set_ta_attributes();
 
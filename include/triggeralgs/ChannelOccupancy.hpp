@@ -0,0 +1,134 @@
+/**
+ * @file ChannelOccupancy.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_INCLUDE_TRIGGERALGS_CHANNELOCCUPANCY_HPP_
+#define TRIGGERALGS_INCLUDE_TRIGGERALGS_CHANNELOCCUPANCY_HPP_
+
+#include "triggeralgs/Types.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief Hit counts per channel for the contents of a window.
+///
+/// Counts live in a flat array plus a bitmap of hit channels, both indexed by
+/// offset from the lowest channel seen (rounded down to a multiple of 64) and
+/// grown on demand. The number of hit channels is a running counter, and
+/// longest_adjacent_run() walks whole bitmap words instead of sorting the
+/// window's channels, and keeps its runs from one call to the next.
+class ChannelOccupancy
+{
+public:
+  void add(channel_t channel);
+
+  /// Remove one hit on a channel previously passed to add().
+  void remove(channel_t channel);
+
+  void clear();
+
+  std::size_t n_channels_hit() const { return m_n_channels_hit; }
+
+  /// Number of hits on this channel.
+  uint16_t hit_count(channel_t channel) const;
+
+  /// Length of the longest run of hit channels, stepping over gaps as the
+  /// adjacency checks of the TA makers do: a step of 1 channel always extends
+  /// the run; a step of 2 to max_step channels extends it only while the
+  /// accumulated step size of such jumps is below tolerance; any other step
+  /// ends the run.
+  ///
+  /// Matches the sort-and-scan adjacency of HorizontalMuon/PlaneCoincidence,
+  /// including returning 0 when a single channel (other than channel 0) is hit.
+  ///
+  /// A run never crosses a step longer than max_step, so the hit channels
+  /// split into segments at such steps that can be walked independently. The
+  /// longest run of each segment is kept, and a call only walks again the
+  /// segments around channels that gained their first hit or lost their last
+  /// one since the previous call with the same max_step and tolerance. A
+  /// window sliding over a track mostly adds and removes hits on channels that
+  /// stay hit, which leaves nothing to walk.
+  uint16_t longest_adjacent_run(channel_t max_step, uint16_t tolerance) const;
+
+  /// The same, walking all of the hit channels, without the kept segments.
+  uint16_t scan_adjacent_run(channel_t max_step, uint16_t tolerance) const;
+
+  /// A run of hit channels, from its first to its last.
+  struct AdjacentRun
+  {
+    channel_t first_channel = 0;
+    channel_t last_channel = 0;
+    uint16_t length = 0;
+  };
+
+  /// The run that longest_adjacent_run() measures: of those with its length,
+  /// the one on the lowest channels. A length of 0 means no run.
+  AdjacentRun longest_adjacent_span(channel_t max_step, uint16_t tolerance) const;
+
+  /// Number of hits on the channels from first to last.
+  std::size_t hit_count(channel_t first, channel_t last) const;
+
+  /// The lowest hit channel, if any channel is hit.
+  channel_t lowest_hit_channel() const { return m_channel_base + static_cast<channel_t>(next_hit_channel(0)); }
+
+private:
+  void cover_channel(channel_t channel);
+  std::size_t next_hit_channel(std::size_t offset) const;
+  std::size_t next_empty_channel(std::size_t offset) const;
+
+  // Segments, for longest_adjacent_run().
+  void note_changed(std::size_t offset);
+  void update_segments(channel_t max_step, uint16_t tolerance) const;
+  void rebuild_segments(channel_t max_step, uint16_t tolerance) const;
+  // Walk the segment starting at this hit channel, and return its last
+  // channel, with the length and span of its first longest run.
+  std::size_t walk_segment(std::size_t start,
+                           channel_t max_step,
+                           uint16_t tolerance,
+                           std::size_t& longest_run,
+                           std::pair<std::size_t, std::size_t>& longest_span) const;
+  // Walk the segments starting in [first, last], from `from` on.
+  std::size_t walk_segments(std::size_t first, std::size_t last, std::size_t from, channel_t max_step, uint16_t tolerance) const;
+  void add_segment(std::size_t start,
+                   std::size_t end,
+                   std::size_t longest_run,
+                   const std::pair<std::size_t, std::size_t>& longest_span) const;
+  void remove_segment(std::size_t start) const;
+  std::size_t previous_segment_start(std::size_t offset) const;
+
+  static constexpr std::size_t npos = static_cast<std::size_t>(-1);
+  // Past this many changes between calls, walk everything again.
+  static constexpr std::size_t max_changed = 1024;
+
+  channel_t m_channel_base = 0;
+  std::vector<uint16_t> m_counts;
+  std::vector<uint64_t> m_bitmap; // NOLINT(build/unsigned)
+  std::size_t m_n_channels_hit = 0;
+
+  // Only kept up to date once longest_adjacent_run() has been called, and
+  // only for the max_step and tolerance of its last call.
+  mutable bool m_segments_valid = false;
+  mutable channel_t m_segments_max_step = 0;
+  mutable uint16_t m_segments_tolerance = 0;
+  mutable std::vector<std::size_t> m_changed;                   // Channels hit or emptied since
+  mutable std::vector<std::pair<std::size_t, std::size_t>> m_stretches; // To walk again
+  mutable std::vector<uint64_t> m_segment_starts; // NOLINT(build/unsigned) Bitmap of first channels
+  mutable std::vector<std::size_t> m_segment_end; // Last channel, by first channel
+  mutable std::vector<std::size_t> m_segment_run; // Longest run, by first channel
+  mutable std::vector<std::pair<std::size_t, std::size_t>> m_segment_run_span; // First and last channel of that run
+  mutable std::vector<std::size_t> m_run_counts;  // Number of segments by their longest run
+  mutable std::size_t m_longest_run = 0;
+  mutable std::size_t m_longest_segment = npos; // First segment with the longest run, npos if to be found again
+};
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_INCLUDE_TRIGGERALGS_CHANNELOCCUPANCY_HPP_
@@ -0,0 +1,168 @@
+/**
+ * @file Histogram.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_INCLUDE_TRIGGERALGS_HISTOGRAM_HPP_
+#define TRIGGERALGS_INCLUDE_TRIGGERALGS_HISTOGRAM_HPP_
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace triggeralgs {
+
+/// @brief Fixed-size HDR-style histogram of unsigned 64-bit values, eg
+/// latencies in ns.
+///
+/// Values below 32 have a bucket each; above that, every power of two is split
+/// into 32 equal buckets, so any value is known to within about 3% over the
+/// whole 64-bit range, in 1920 buckets. Recording is a handful of
+/// instructions and never allocates.
+///
+/// Values are recorded by one thread, and may be read by any other at the
+/// same time, eg by a monitoring thread polling the maker thread's histograms.
+class Histogram
+{
+public:
+  static constexpr unsigned sub_bucket_bits = 5;
+  static constexpr std::size_t sub_buckets = std::size_t(1) << sub_bucket_bits;
+  static constexpr std::size_t n_buckets = (64 - sub_bucket_bits + 1) * sub_buckets;
+
+  struct Summary
+  {
+    uint64_t count = 0; // NOLINT(build/unsigned)
+    uint64_t min = 0;   // NOLINT(build/unsigned)
+    uint64_t max = 0;   // NOLINT(build/unsigned)
+    double mean = 0;
+    uint64_t p50 = 0;  // NOLINT(build/unsigned)
+    uint64_t p90 = 0;  // NOLINT(build/unsigned)
+    uint64_t p99 = 0;  // NOLINT(build/unsigned)
+    uint64_t p999 = 0; // NOLINT(build/unsigned)
+  };
+
+  Histogram() { reset(); }
+  Histogram(const Histogram&) = delete;
+  Histogram& operator=(const Histogram&) = delete;
+
+  /// Recording thread only.
+  void record(uint64_t value) // NOLINT(build/unsigned)
+  {
+    increment(m_counts[bucket_of(value)], 1);
+    increment(m_count, 1);
+    increment(m_sum, value);
+    if (value < m_min.load(std::memory_order_relaxed))
+      m_min.store(value, std::memory_order_relaxed);
+    if (value > m_max.load(std::memory_order_relaxed))
+      m_max.store(value, std::memory_order_relaxed);
+  }
+
+  /// Recording thread only, or while nothing is recorded.
+  void reset()
+  {
+    for (auto& count : m_counts)
+      count.store(0, std::memory_order_relaxed);
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_min.store(std::numeric_limits<uint64_t>::max(), std::memory_order_relaxed); // NOLINT(build/unsigned)
+    m_max.store(0, std::memory_order_relaxed);
+  }
+
+  uint64_t count() const { return m_count.load(std::memory_order_relaxed); } // NOLINT(build/unsigned)
+  uint64_t min() const { return count() == 0 ? 0 : m_min.load(std::memory_order_relaxed); } // NOLINT(build/unsigned)
+  uint64_t max() const { return m_max.load(std::memory_order_relaxed); } // NOLINT(build/unsigned)
+  double mean() const
+  {
+    uint64_t n = count(); // NOLINT(build/unsigned)
+    return n == 0 ? 0 : static_cast<double>(m_sum.load(std::memory_order_relaxed)) / n;
+  }
+
+  /// The smallest value that at least a fraction q of the recorded values do
+  /// not exceed, to within the bucket width.
+  uint64_t value_at_quantile(double q) const; // NOLINT(build/unsigned)
+
+  Summary summary() const;
+
+  static std::size_t bucket_of(uint64_t value) // NOLINT(build/unsigned)
+  {
+    if (value < sub_buckets)
+      return value;
+    const unsigned exponent = 63 - __builtin_clzll(value);
+    const unsigned shift = exponent - sub_bucket_bits;
+    return (shift + 1) * sub_buckets + ((value >> shift) - sub_buckets);
+  }
+
+  static uint64_t lowest_in_bucket(std::size_t bucket) // NOLINT(build/unsigned)
+  {
+    if (bucket < sub_buckets)
+      return bucket;
+    const unsigned shift = bucket / sub_buckets - 1;
+    return static_cast<uint64_t>(bucket % sub_buckets + sub_buckets) << shift; // NOLINT(build/unsigned)
+  }
+
+  static uint64_t highest_in_bucket(std::size_t bucket) // NOLINT(build/unsigned)
+  {
+    if (bucket < sub_buckets)
+      return bucket;
+    const unsigned shift = bucket / sub_buckets - 1;
+    return lowest_in_bucket(bucket) + ((uint64_t(1) << shift) - 1); // NOLINT(build/unsigned)
+  }
+
+private:
+  using Counter = std::atomic<uint64_t>; // NOLINT(build/unsigned)
+
+  // Only one thread writes, so a plain load and store will do.
+  static void increment(Counter& counter, uint64_t by) // NOLINT(build/unsigned)
+  {
+    counter.store(counter.load(std::memory_order_relaxed) + by, std::memory_order_relaxed);
+  }
+
+  std::array<Counter, n_buckets> m_counts;
+  Counter m_count;
+  Counter m_sum;
+  Counter m_min;
+  Counter m_max;
+};
+
+inline uint64_t // NOLINT(build/unsigned)
+Histogram::value_at_quantile(double q) const
+{
+  const uint64_t n = count(); // NOLINT(build/unsigned)
+  if (n == 0)
+    return 0;
+  const uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(q * n))); // NOLINT(build/unsigned)
+
+  uint64_t seen = 0; // NOLINT(build/unsigned)
+  for (std::size_t bucket = 0; bucket < n_buckets; ++bucket) {
+    seen += m_counts[bucket].load(std::memory_order_relaxed);
+    if (seen >= rank)
+      return std::min(highest_in_bucket(bucket), max());
+  }
+  return max();
+}
+
+inline Histogram::Summary
+Histogram::summary() const
+{
+  Summary summary;
+  summary.count = count();
+  summary.min = min();
+  summary.max = max();
+  summary.mean = mean();
+  summary.p50 = value_at_quantile(0.5);
+  summary.p90 = value_at_quantile(0.9);
+  summary.p99 = value_at_quantile(0.99);
+  summary.p999 = value_at_quantile(0.999);
+  return summary;
+}
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_INCLUDE_TRIGGERALGS_HISTOGRAM_HPP_
@@ -19,10 +19,16 @@ class TriggerActivityMakerHorizontalMuon : public TriggerActivityMaker
 {
 public:
   void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta);
+  void operator()(Span<const TriggerPrimitive> input_tps, std::vector<TriggerActivity>& output_ta);
+  void flush(timestamp_t until, std::vector<TriggerActivity>& output_ta);
+  std::size_t window_occupancy() const { return m_current_window.size(); }
   void configure(const nlohmann::json& config);
 
+  /// The TA that HorizontalMuon makes from a window, also used by
+  /// TriggerActivityMakerHorizontalMuonMulti.
+  static TriggerActivity construct_ta(const TPWindow& window);
+
 private:
-  TriggerActivity construct_ta() const;
   uint16_t check_adjacency() const; // Returns longest string of adjacent collection hits in window
 
   TPWindow m_current_window; // Holds collection hits only
@@ -48,7 +54,7 @@ private:
   uint16_t m_prescale = 1;            // Prescale value, defult is one, trigger every TA
 
   // For debugging and performance study purposes.
-  void add_window_to_record(TPWindow window);
+  void add_window_to_record(const TPWindow& window);
   void dump_window_record();
   void dump_tp(TriggerPrimitive const& input_tp);
   std::vector<TPWindow> m_window_record;
@@ -0,0 +1,121 @@
+/**
+ * @file TriggerActivityMakerHorizontalMuonMulti.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_HORIZONTALMUON_TRIGGERACTIVITYMAKERHORIZONTALMUONMULTI_HPP_
+#define TRIGGERALGS_HORIZONTALMUON_TRIGGERACTIVITYMAKERHORIZONTALMUONMULTI_HPP_
+
+#include "triggeralgs/TPWindow.hpp"
+#include "triggeralgs/TriggerActivityFactory.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief HorizontalMuon with several sets of trigger parameters at once.
+///
+/// Each parameter set makes exactly the TAs that a HorizontalMuon maker
+/// configured with it would. Instead of a window per set, the sets whose
+/// windows hold the same TPs share one, with its aggregates and adjacency
+/// worked out once per TP for all of them. Windows only part when some sets
+/// trigger (and restart their window) and others do not, and they come
+/// together again as soon as both have slid on past the TP that parted them,
+/// at most a window length later. So most of the time there is one window,
+/// and each extra set costs a few comparisons per TP.
+///
+/// Configuration: "window_length", "adj_tolerance" and "print_tp_info" are
+/// shared. "parameter_sets" is a list of objects with any of the other
+/// HorizontalMuon parameters ("trigger_on_adc", "adc_threshold",
+/// "trigger_on_n_channels", "n_channels_threshold", "trigger_on_adjacency",
+/// "adjacency_threshold", "trigger_on_tot", "tot_threshold", "prescale"),
+/// which default to those given at the top level. Without "parameter_sets",
+/// the top level is the only set.
+class TriggerActivityMakerHorizontalMuonMulti : public TriggerActivityMaker
+{
+public:
+  TriggerActivityMakerHorizontalMuonMulti();
+
+  /// The TAs of every set go to output_ta; output_sets() tells which set made
+  /// each of them.
+  void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta);
+  void operator()(Span<const TriggerPrimitive> input_tps, std::vector<TriggerActivity>& output_ta);
+  void flush(timestamp_t until, std::vector<TriggerActivity>& output_ta);
+
+  /// The same, with the TAs of parameter set k appended to output_ta[k],
+  /// which is resized to the number of sets if needed.
+  void operator()(const TriggerPrimitive& input_tp, std::vector<std::vector<TriggerActivity>>& output_ta);
+  void flush(timestamp_t until, std::vector<std::vector<TriggerActivity>>& output_ta);
+
+  /// For each TA appended to a single output vector by the last call, the
+  /// index of the parameter set that made it.
+  const std::vector<std::size_t>& output_sets() const { return m_output_sets; }
+
+  std::size_t n_parameter_sets() const { return m_sets.size(); }
+  std::size_t n_windows() const { return m_windows.size(); }
+  std::size_t window_occupancy() const;
+  void configure(const nlohmann::json& config);
+
+private:
+  struct ParameterSet
+  {
+    bool trigger_on_adc = false;
+    bool trigger_on_n_channels = false;
+    bool trigger_on_adjacency = true;
+    bool trigger_on_tot = false;
+    uint16_t tot_threshold = 5000;
+    uint16_t adjacency_threshold = 15;
+    uint32_t adc_threshold = 3000000;
+    uint16_t n_channels_threshold = 400;
+    uint16_t prescale = 1;
+
+    uint16_t ta_count = 0;  // Use for prescaling
+    int max_adjacency = 0; // The maximum adjacency seen so far in any window
+  };
+
+  // A window, and the parameter sets whose windows hold exactly its TPs.
+  struct SharedWindow
+  {
+    TPWindow window;
+    std::vector<std::size_t> sets;
+    bool changed = false; // Slid on or restarted by the current TP
+  };
+
+  static ParameterSet parse_parameter_set(const nlohmann::json& config, const ParameterSet& defaults);
+
+  template<class Emit>
+  void process(const TriggerPrimitive& input_tp, Emit&& emit);
+  template<class Emit>
+  void process_flush(timestamp_t until, Emit&& emit);
+  // Give the sets a window of their own, holding `window`'s TPs.
+  void split(const TPWindow& window, const std::vector<std::size_t>& sets, bool changed);
+  // Put together the windows that hold the same TPs.
+  void merge_windows();
+  static bool same_tps(const TPWindow& a, const TPWindow& b);
+
+  uint16_t adjacency(const TPWindow& window) const { return window.longest_adjacent_run(5, m_adj_tolerance); }
+
+  std::vector<ParameterSet> m_sets;
+  std::vector<SharedWindow> m_windows;
+  std::vector<SharedWindow> m_new_windows;
+  std::vector<std::size_t> m_output_sets;
+  // The sets of a window that trigger, that drop a prescaled trigger, and
+  // that slide on, for the current TP.
+  std::vector<std::size_t> m_emitting;
+  std::vector<std::size_t> m_dropping;
+  std::vector<std::size_t> m_moving;
+
+  // Configurable parameters shared by all of the sets.
+  timestamp_t m_window_length = 8000;
+  uint16_t m_adj_tolerance = 3;
+  bool m_print_tp_info = false;
+};
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_HORIZONTALMUON_TRIGGERACTIVITYMAKERHORIZONTALMUONMULTI_HPP_
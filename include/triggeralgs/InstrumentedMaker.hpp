@@ -0,0 +1,146 @@
+/**
+ * @file InstrumentedMaker.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_INCLUDE_TRIGGERALGS_INSTRUMENTEDMAKER_HPP_
+#define TRIGGERALGS_INCLUDE_TRIGGERALGS_INSTRUMENTEDMAKER_HPP_
+
+#include "triggeralgs/MakerStats.hpp"
+#include "triggeralgs/TriggerActivityMaker.hpp"
+#include "triggeralgs/TriggerCandidateMaker.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <utility>
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief Times every call of a TA or TC maker and records its outputs in a
+/// MakerStats, to be polled through stats().
+///
+/// With TRIGGERALGS_INSTRUMENTATION defined, the factories wrap every maker
+/// they build in one of these; without it nothing is wrapped and the makers
+/// run exactly as before.
+///
+/// Configured with "clock_frequency_hz", the data clock used to compare the
+/// start of each output with the system time (62.5 MHz by default); the whole
+/// configuration is also passed on to the wrapped maker.
+///
+/// @tparam Maker TriggerActivityMaker or TriggerCandidateMaker
+/// @tparam Input the maker's input, TriggerPrimitive or TriggerActivity
+/// @tparam Output the maker's output, TriggerActivity or TriggerCandidate
+template<class Maker, class Input, class Output>
+class InstrumentedMaker : public Maker
+{
+public:
+  explicit InstrumentedMaker(std::unique_ptr<Maker> maker)
+    : m_maker(std::move(maker))
+  {
+  }
+
+  void operator()(const Input& input, std::vector<Output>& output)
+  {
+    const std::size_t first = output.size();
+    const auto start = std::chrono::steady_clock::now();
+    (*m_maker)(input, output);
+    finish_call(start, 1, input.time_start, output, first);
+  }
+
+  void operator()(Span<const Input> inputs, std::vector<Output>& output)
+  {
+    if (inputs.empty())
+      return;
+    const std::size_t first = output.size();
+    const auto start = std::chrono::steady_clock::now();
+    (*m_maker)(inputs, output);
+    finish_call(start, inputs.size(), inputs.back().time_start, output, first);
+  }
+
+  void flush(timestamp_t until, std::vector<Output>& output)
+  {
+    const std::size_t first = output.size();
+    const auto start = std::chrono::steady_clock::now();
+    m_maker->flush(until, output);
+    finish_call(start, 0, until, output, first);
+  }
+
+  void configure(const nlohmann::json& config)
+  {
+    if (config.is_object() && config.contains("clock_frequency_hz"))
+      m_clock_frequency_hz = config["clock_frequency_hz"];
+    m_maker->configure(config);
+  }
+
+  std::size_t window_occupancy() const { return m_maker->window_occupancy(); }
+  MakerStats* stats() { return &m_stats; }
+  Maker& maker() { return *m_maker; }
+
+private:
+  void finish_call(std::chrono::steady_clock::time_point start,
+                   std::size_t n_inputs,
+                   timestamp_t data_time,
+                   const std::vector<Output>& output,
+                   std::size_t first)
+  {
+    const auto end = std::chrono::steady_clock::now();
+    m_stats.record_call(std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count(),
+                        n_inputs,
+                        m_maker->window_occupancy());
+
+    m_data_time = std::max(m_data_time, data_time);
+    if (first == output.size())
+      return;
+
+    // The data clock counts from the Unix epoch.
+    const double now_ns =
+      std::chrono::duration<double, std::nano>(std::chrono::system_clock::now().time_since_epoch()).count();
+    const double ns_per_tick = 1e9 / m_clock_frequency_hz;
+    for (std::size_t i = first; i < output.size(); ++i) {
+      const timestamp_t time_start = output[i].time_start;
+      const double delay_ns = now_ns - time_start * ns_per_tick;
+      m_stats.record_output(m_data_time > time_start ? m_data_time - time_start : 0,
+                            delay_ns > 0 ? static_cast<uint64_t>(delay_ns) : 0); // NOLINT(build/unsigned)
+    }
+  }
+
+  std::unique_ptr<Maker> m_maker;
+  MakerStats m_stats;
+  timestamp_t m_data_time = 0; // Latest input time_start, or flush time, seen
+
+  // Configurable parameters.
+  double m_clock_frequency_hz = 62.5e6;
+};
+
+using InstrumentedTriggerActivityMaker = InstrumentedMaker<TriggerActivityMaker, TriggerPrimitive, TriggerActivity>;
+using InstrumentedTriggerCandidateMaker = InstrumentedMaker<TriggerCandidateMaker, TriggerActivity, TriggerCandidate>;
+
+/// Used by the factories when built with TRIGGERALGS_INSTRUMENTATION: wraps
+/// TA and TC makers, and leaves anything else alone.
+template<class T>
+std::unique_ptr<T>
+instrument_maker(std::unique_ptr<T> maker)
+{
+  return maker;
+}
+
+inline std::unique_ptr<TriggerActivityMaker>
+instrument_maker(std::unique_ptr<TriggerActivityMaker> maker)
+{
+  return std::make_unique<InstrumentedTriggerActivityMaker>(std::move(maker));
+}
+
+inline std::unique_ptr<TriggerCandidateMaker>
+instrument_maker(std::unique_ptr<TriggerCandidateMaker> maker)
+{
+  return std::make_unique<InstrumentedTriggerCandidateMaker>(std::move(maker));
+}
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_INCLUDE_TRIGGERALGS_INSTRUMENTEDMAKER_HPP_
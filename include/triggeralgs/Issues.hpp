@@ -28,4 +28,9 @@ ERS_DECLARE_ISSUE(triggeralgs,
                   "Bad configuration in " << alg_name,
                   ((std::string)alg_name))
 
+ERS_DECLARE_ISSUE(triggeralgs,
+                  TPFileError,
+                  "TP file " << path << ": " << reason,
+                  ((std::string)path)((std::string)reason))
+
 #endif // TRIGGERALGS_INCLUDE_TRIGGERALGS_ISSUES_HPP_
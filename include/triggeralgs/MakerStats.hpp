@@ -0,0 +1,106 @@
+/**
+ * @file MakerStats.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_INCLUDE_TRIGGERALGS_MAKERSTATS_HPP_
+#define TRIGGERALGS_INCLUDE_TRIGGERALGS_MAKERSTATS_HPP_
+
+#include "triggeralgs/Histogram.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+namespace triggeralgs {
+
+/// @brief Processing time, throughput, window occupancy and emission latency
+/// of one TA or TC maker.
+///
+/// Filled in by InstrumentedMaker on the maker's thread, and read with poll()
+/// from any one other thread, eg by the application's monitoring.
+class MakerStats
+{
+public:
+  struct Report
+  {
+    uint64_t n_calls = 0;   // NOLINT(build/unsigned)
+    uint64_t n_inputs = 0;  // NOLINT(build/unsigned)
+    uint64_t n_outputs = 0; // NOLINT(build/unsigned)
+    // Since the previous poll.
+    double input_rate_hz = 0;
+    double output_rate_hz = 0;
+
+    Histogram::Summary call_time_ns;       // Time spent in each call of the maker
+    Histogram::Summary window_occupancy;   // Inputs held by the maker after each call
+    Histogram::Summary emission_lag_ticks; // Data time between the start of each output and the latest input
+    Histogram::Summary emission_delay_ns;  // System time between the start of each output and its emission
+  };
+
+  /// Recording thread only.
+  void record_call(uint64_t call_time_ns, std::size_t n_inputs, std::size_t window_occupancy) // NOLINT(build/unsigned)
+  {
+    m_call_time_ns.record(call_time_ns);
+    m_window_occupancy.record(window_occupancy);
+    m_n_inputs.store(m_n_inputs.load(std::memory_order_relaxed) + n_inputs, std::memory_order_relaxed);
+  }
+
+  /// Recording thread only.
+  void record_output(uint64_t lag_ticks, uint64_t delay_ns) // NOLINT(build/unsigned)
+  {
+    m_emission_lag_ticks.record(lag_ticks);
+    m_emission_delay_ns.record(delay_ns);
+  }
+
+  /// The totals and distributions so far, and the rates since the previous poll.
+  Report poll();
+
+  const Histogram& call_time_ns() const { return m_call_time_ns; }
+  const Histogram& window_occupancy() const { return m_window_occupancy; }
+  const Histogram& emission_lag_ticks() const { return m_emission_lag_ticks; }
+  const Histogram& emission_delay_ns() const { return m_emission_delay_ns; }
+
+private:
+  Histogram m_call_time_ns;
+  Histogram m_window_occupancy;
+  Histogram m_emission_lag_ticks;
+  Histogram m_emission_delay_ns;
+  std::atomic<uint64_t> m_n_inputs{ 0 }; // NOLINT(build/unsigned)
+
+  // Polling thread only.
+  std::chrono::steady_clock::time_point m_last_poll = std::chrono::steady_clock::now();
+  uint64_t m_last_n_inputs = 0;  // NOLINT(build/unsigned)
+  uint64_t m_last_n_outputs = 0; // NOLINT(build/unsigned)
+};
+
+inline MakerStats::Report
+MakerStats::poll()
+{
+  Report report;
+  report.n_calls = m_call_time_ns.count();
+  report.n_inputs = m_n_inputs.load(std::memory_order_relaxed);
+  report.n_outputs = m_emission_lag_ticks.count();
+  report.call_time_ns = m_call_time_ns.summary();
+  report.window_occupancy = m_window_occupancy.summary();
+  report.emission_lag_ticks = m_emission_lag_ticks.summary();
+  report.emission_delay_ns = m_emission_delay_ns.summary();
+
+  const auto now = std::chrono::steady_clock::now();
+  const double seconds = std::chrono::duration<double>(now - m_last_poll).count();
+  if (seconds > 0) {
+    report.input_rate_hz = (report.n_inputs - m_last_n_inputs) / seconds;
+    report.output_rate_hz = (report.n_outputs - m_last_n_outputs) / seconds;
+  }
+  m_last_poll = now;
+  m_last_n_inputs = report.n_inputs;
+  m_last_n_outputs = report.n_outputs;
+  return report;
+}
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_INCLUDE_TRIGGERALGS_MAKERSTATS_HPP_
@@ -0,0 +1,56 @@
+/**
+ * @file MichelTrackChecks.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_MICHELELECTRON_MICHELTRACKCHECKS_HPP_
+#define TRIGGERALGS_MICHELELECTRON_MICHELTRACKCHECKS_HPP_
+
+#include "triggeralgs/TriggerPrimitive.hpp"
+#include "triggeralgs/Types.hpp"
+
+#include <cstdint>
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief The shape checks MichelElectron makes on the TPs of a track, in
+/// order of channel.
+///
+/// Each check copies the fields it reads into flat arrays, then runs
+/// branch-free loops over them that the compiler can vectorise. The arrays are
+/// kept from one call to the next, so that checks stop allocating once they
+/// have seen the longest track. The results are the same, to the bit, as
+/// those of the loops over TPs the maker had at first.
+class MichelTrackChecks
+{
+public:
+  /// Whether the charge of the track peaks at one of its ends: the ADC
+  /// integrals are averaged over every 6 consecutive TPs (wrapping around at
+  /// the end), and of the clusters of averages above their mean, the first or
+  /// the last has the most charge. False without any such cluster.
+  bool has_bragg_peak(const std::vector<TriggerPrimitive>& track);
+
+  /// Whether the gradient of the track, between TPs two apart that are close
+  /// in channel and time, is far from its mean at the first or last TP.
+  bool has_kinks(const std::vector<TriggerPrimitive>& track);
+
+private:
+  template<class Offset>
+  void compute_gradients(const std::vector<Offset>& times);
+
+  std::vector<float> m_adc;   // ADC integrals, then the first 5 again
+  std::vector<float> m_means; // Moving averages of m_adc
+  std::vector<int32_t> m_channels;
+  std::vector<int32_t> m_times;      // Time offsets from the first TP, if they fit
+  std::vector<int64_t> m_long_times; // The same offsets in full
+  std::vector<float> m_gradients;
+  std::vector<int32_t> m_gradient_kept; // 1 for the gradients the check uses
+};
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_MICHELELECTRON_MICHELTRACKCHECKS_HPP_
@@ -9,7 +9,11 @@
 #ifndef TRIGGERALGS_MICHELELECTRON_TRIGGERACTIVITYMAKERMICHELELECTRON_HPP_
 #define TRIGGERALGS_MICHELELECTRON_TRIGGERACTIVITYMAKERMICHELELECTRON_HPP_
 
+#include "triggeralgs/ChannelOccupancy.hpp"
+#include "triggeralgs/MichelElectron/MichelTrackChecks.hpp"
+#include "triggeralgs/TPWindow.hpp"
 #include "triggeralgs/TriggerActivityFactory.hpp"
+#include <cstddef>
 #include <fstream>
 #include <vector>
 
@@ -19,96 +23,34 @@ class TriggerActivityMakerMichelElectron : public TriggerActivityMaker
 
 public:
   void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta);
+  void operator()(Span<const TriggerPrimitive> input_tps, std::vector<TriggerActivity>& output_ta);
+  void flush(timestamp_t until, std::vector<TriggerActivity>& output_ta);
+  std::size_t window_occupancy() const { return m_current_window.size(); }
 
   void configure(const nlohmann::json& config);
 
 private:
-  class Window
-  {
-  public:
-    bool is_empty() const { return inputs.empty(); };
-    void add(TriggerPrimitive const& input_tp)
-    {
-      // Add the input TP's contribution to the total ADC, increase hit channel's hit count and add it to the TP list.
-      adc_integral += input_tp.adc_integral;
-      channel_states[input_tp.channel]++;
-      inputs.push_back(input_tp);
-    };
-    void clear() { inputs.clear(); };
-    uint16_t n_channels_hit() { return channel_states.size(); };
-    void move(TriggerPrimitive const& input_tp, timestamp_t const& window_length)
-    {
-      // Find all of the TPs in the window that need to be removed
-      // if the input_tp is to be added and the size of the window
-      // is to be conserved.
-      // Substract those TPs' contribution from the total window ADC and remove their
-      // contributions to the hit counts.
-      uint32_t n_tps_to_erase = 0;
-      for (auto tp : inputs) {
-        if (!(input_tp.time_start - tp.time_start < window_length)) {
-          n_tps_to_erase++;
-          adc_integral -= tp.adc_integral;
-          channel_states[tp.channel]--;
-          // If a TP being removed from the window results in a channel no longer having
-          // any hits, remove from the states map so map.size() can be used for number
-          // channels hit.
-          if (channel_states[tp.channel] == 0)
-            channel_states.erase(tp.channel);
-        } else
-          break;
-      }
-      // Erase the TPs from the window.
-      inputs.erase(inputs.begin(), inputs.begin() + n_tps_to_erase);
-      // Make the window start time the start time of what is now the first TP.
-
-      if (!(inputs.size() == 0)) {
-        time_start = inputs.front().time_start;
-        add(input_tp);
-      } else {
-        // std::cout << "Resetting window." << std::endl;
-        reset(input_tp);
-      }
-    };
-    void reset(TriggerPrimitive const& input_tp)
-    {
+  TriggerActivity construct_ta() const;
+  std::vector<TriggerPrimitive> longest_activity() const;
 
-      // Empty the channel and TP lists.
-      channel_states.clear();
-      inputs.clear();
-      // Set the start time of the window to be the start time of theinput_tp.
-      time_start = input_tp.time_start;
-      // Start the total ADC integral.
-      adc_integral = input_tp.adc_integral;
-      // Start hit count for the hit channel.
-      channel_states[input_tp.channel]++;
-      // Add the input TP to the TP list.
-      inputs.push_back(input_tp);
-      // std::cout << "Number of channels hit: " << n_channels_hit() << std::endl;
-    };
-    friend std::ostream& operator<<(std::ostream& os, const Window& window)
-    {
-      if (window.is_empty())
-        os << "Window is empty!\n";
-      else {
-        os << "Window start: " << window.time_start << ", end: " << window.inputs.back().time_start;
-        os << ". Total of: " << window.adc_integral << " ADC counts with " << window.inputs.size() << " TPs.\n";
-        os << window.channel_states.size() << " independent channels have hits.\n";
-      }
-      return os;
-    };
+  // The number of TPs in the longest activity of the window, and whether that
+  // activity passes the Bragg peak and kink checks. Both are kept until the
+  // window changes, and the checks only run when asked for.
+  std::size_t track_size();
+  bool track_is_michel();
+  void window_changed() { m_track_valid = false; }
 
-    timestamp_t time_start;
-    uint32_t adc_integral;
-    std::unordered_map<channel_t, uint16_t> channel_states;
-    std::vector<TriggerPrimitive> inputs;
-  };
+  TPWindow m_current_window;
 
-  TriggerActivity construct_ta() const;
-  std::vector<TriggerPrimitive> longest_activity() const;
-  bool check_bragg_peak(std::vector<TriggerPrimitive> trackHits);
-  bool check_kinks(std::vector<TriggerPrimitive> trackHits);
+  bool m_track_valid = false;
+  std::size_t m_track_size = 0;
+  ChannelOccupancy::AdjacentRun m_track_run;
+  bool m_track_gathered = false; // Whether m_track_hits holds the TPs of the activity
+  bool m_track_checked = false;  // Whether m_track_is_michel is worked out
+  bool m_track_is_michel = false;
+  std::vector<TriggerPrimitive> m_track_hits;
+  MichelTrackChecks m_track_checks;
 
-  Window m_current_window;
   uint64_t m_primitive_count = 0;
 
   // Configurable parameters.
@@ -128,10 +70,10 @@ private:
   timestamp_t m_window_length = 50000;
 
   // For debugging purposes.
-  void add_window_to_record(Window window);
+  void add_window_to_record(const TPWindow& window);
   void dump_window_record();
   void dump_tp(TriggerPrimitive const& input_tp);
-  std::vector<Window> m_window_record;
+  std::vector<TPWindow> m_window_record;
 };
 } // namespace triggeralgs
 
@@ -27,15 +27,23 @@ class TriggerActivityMakerPlaneCoincidence : public TriggerActivityMaker
 {
 public:
   void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta);
+  void operator()(Span<const TriggerPrimitive> input_tps, std::vector<TriggerActivity>& output_ta);
+  void flush(timestamp_t until, std::vector<TriggerActivity>& output_ta);
+  std::size_t window_occupancy() const
+  {
+    return m_collection_window.size() + m_induction1_window.size() + m_induction2_window.size();
+  }
   void configure(const nlohmann::json& config);
 
 private:
-  TriggerActivity construct_ta(TPWindow m_current_window) const;
-  uint16_t check_adjacency(TPWindow window) const; // Returns longest string of adjacent collection hits in window
+  TriggerActivity construct_ta(const TPWindow& m_current_window) const;
+  uint16_t check_adjacency(const TPWindow& window) const; // Returns longest string of adjacent collection hits in window
+  bool passes_trigger() const;                            // ADC and adjacency conditions on the current windows
+  void emit_ta(std::vector<TriggerActivity>& output_ta);  // Construct a TA from the collection window
 
   TPWindow m_current_window;             // Possibly redundant for this alg?
   uint64_t m_primitive_count = 0;
-  int check_tot(TPWindow m_current_window) const;
+  int check_tot(const TPWindow& m_current_window) const;
   //void clearWindows(TriggerPrimitive const input_tp); // Function to clear or reset all windows, according to TP channel 
  
   // Make 3 instances of the Window class. One for each view plane.
@@ -58,12 +66,13 @@ private:
   uint16_t ta_adc = 0;
   uint16_t ta_channels = 0;
   timestamp_t m_window_length = 3000;    // Shouldn't exceed the max drift
+  bool m_dump_triggering_tps = true;     // Append the windows and TPs of each TA to files in the working directory
 
   // Channel map object, for separating TPs by the plane view they come from
   std::shared_ptr<dunedaq::detchannelmaps::TPCChannelMap> channelMap = dunedaq::detchannelmaps::make_map(m_channel_map_name);
 
   // For debugging and performance study purposes.
-  void add_window_to_record(TPWindow window);
+  void add_window_to_record(const TPWindow& window);
   void dump_window_record();
   void dump_tp(TriggerPrimitive const& input_tp);
   std::vector<TPWindow> m_window_record;
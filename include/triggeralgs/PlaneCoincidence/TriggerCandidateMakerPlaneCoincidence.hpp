@@ -21,6 +21,9 @@ class TriggerCandidateMakerPlaneCoincidence : public TriggerCandidateMaker
 public:
   // The function that gets called when there is a new activity
   void operator()(const TriggerActivity&, std::vector<TriggerCandidate>&);
+  void operator()(Span<const TriggerActivity>, std::vector<TriggerCandidate>&);
+  void flush(timestamp_t until, std::vector<TriggerCandidate>& output_tc);
+  std::size_t window_occupancy() const { return m_current_window.size(); }
   void configure(const nlohmann::json& config);
 
 private:
@@ -42,7 +45,7 @@ private:
   int tc_number = 0;
 
   // For debugging and performance study purposes.
-  void add_window_to_record(TAWindow window);
+  void add_window_to_record(const TAWindow& window);
   void dump_window_record();
   std::vector<TAWindow> m_window_record;
 };
@@ -19,10 +19,13 @@ class TriggerActivityMakerPrescale : public TriggerActivityMaker
 
 public:
   void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta);
+  void operator()(Span<const TriggerPrimitive> input_tps, std::vector<TriggerActivity>& output_ta);
   
   void configure(const nlohmann::json &config);
   
 private:  
+  void emit_ta(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta) const;
+
   uint64_t m_primitive_count = 0;   // NOLINT(build/unsigned)
   uint64_t m_prescale = 1;          // NOLINT(build/unsigned)
 };
@@ -20,10 +20,12 @@ class TriggerCandidateMakerPrescale : public TriggerCandidateMaker
 public:
   /// The function that gets call when there is a new activity
   void operator()(const TriggerActivity&, std::vector<TriggerCandidate>&);
+  void operator()(Span<const TriggerActivity>, std::vector<TriggerCandidate>&);
   
   void configure(const nlohmann::json &config);
   
 private:
+  void emit_tc(const TriggerActivity& activity, std::vector<TriggerCandidate>& cand) const;
 
   uint64_t m_activity_count = 0;    // NOLINT(build/unsigned)
   uint64_t m_prescale = 1;          // NOLINT(build/unsigned)
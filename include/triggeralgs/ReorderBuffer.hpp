@@ -0,0 +1,203 @@
+/**
+ * @file ReorderBuffer.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_INCLUDE_TRIGGERALGS_REORDERBUFFER_HPP_
+#define TRIGGERALGS_INCLUDE_TRIGGERALGS_REORDERBUFFER_HPP_
+
+#include "triggeralgs/Types.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief Puts a slightly out-of-order stream of TPs or TAs back in time_start order.
+///
+/// An item is held until the latest time_start seen is max_lateness ticks past
+/// its own, so no item is held for longer than max_lateness ticks of stream
+/// time, and at most capacity items are held at once: beyond that the earliest
+/// is released early. An item that starts before one already released can no
+/// longer be put in order and is dropped. Items with equal time_start are
+/// released in the order they came in.
+///
+/// The items stay put in a fixed pool while a binary heap of small keys orders
+/// them, so that sifting moves 16 bytes rather than whole items.
+///
+/// @tparam T TriggerPrimitive or TriggerActivity
+template<class T>
+class ReorderBuffer
+{
+public:
+  struct Counters
+  {
+    uint64_t n_received = 0; // NOLINT(build/unsigned)
+    uint64_t n_released = 0; // NOLINT(build/unsigned)
+    uint64_t n_late = 0;     // NOLINT(build/unsigned) Dropped: started before an item already released
+    uint64_t n_overflow = 0; // NOLINT(build/unsigned) Released early because the buffer was full
+    std::size_t max_buffered = 0;
+  };
+
+  explicit ReorderBuffer(timestamp_t max_lateness = 0, std::size_t capacity = 1 << 16)
+  {
+    configure(max_lateness, capacity);
+  }
+
+  /// Set the limits, emptying the buffer without releasing anything, and
+  /// start again as if nothing had been seen: no input is late and the
+  /// counters are zero.
+  void configure(timestamp_t max_lateness, std::size_t capacity);
+
+  /// Add an item, then pass each item that can no longer be overtaken to
+  /// release(item), in time order. Returns false if the item was dropped as late.
+  template<class Release>
+  bool push(const T& input, Release&& release);
+
+  /// Release, in time order, every item that starts before `until`, on the
+  /// promise that every later input starts at or after it. Inputs breaking
+  /// that promise are dropped as late.
+  template<class Release>
+  void release_until(timestamp_t until, Release&& release);
+
+  /// Release everything, in time order.
+  template<class Release>
+  void drain(Release&& release);
+
+  bool is_empty() const { return m_heap.empty(); }
+  std::size_t size() const { return m_heap.size(); }
+  timestamp_t max_lateness() const { return m_max_lateness; }
+  std::size_t capacity() const { return m_capacity; }
+  const Counters& counters() const { return m_counters; }
+
+private:
+  struct Key
+  {
+    timestamp_t time_start;
+    uint32_t sequence; // NOLINT(build/unsigned) Wraps, but far fewer items than 2^31 are ever held
+    uint32_t slot;     // NOLINT(build/unsigned) Index in m_items
+  };
+
+  // Heap order, earliest item on top.
+  static bool later(const Key& a, const Key& b)
+  {
+    return a.time_start > b.time_start ||
+           (a.time_start == b.time_start && static_cast<int32_t>(a.sequence - b.sequence) > 0);
+  }
+
+  template<class Release>
+  void release_earliest(Release& release);
+
+  std::vector<Key> m_heap;
+  std::vector<T> m_items;
+  std::vector<uint32_t> m_free_slots; // NOLINT(build/unsigned)
+  timestamp_t m_max_lateness = 0;
+  std::size_t m_capacity = 0;
+  timestamp_t m_latest_time = 0;   // Latest time_start seen
+  timestamp_t m_released_time = 0; // time_start of the last item released, or the last watermark
+  uint32_t m_sequence = 0;         // NOLINT(build/unsigned)
+  Counters m_counters;
+};
+
+template<class T>
+void
+ReorderBuffer<T>::configure(timestamp_t max_lateness, std::size_t capacity)
+{
+  m_max_lateness = max_lateness;
+  m_capacity = std::max<std::size_t>(capacity, 1);
+  m_latest_time = 0;
+  m_released_time = 0;
+  m_sequence = 0;
+  m_counters = Counters();
+
+  // All of the memory is taken here, none while running.
+  m_heap.clear();
+  m_heap.reserve(m_capacity);
+  m_items.assign(m_capacity, T());
+  m_free_slots.resize(m_capacity);
+  for (std::size_t i = 0; i < m_capacity; ++i)
+    m_free_slots[i] = static_cast<uint32_t>(m_capacity - 1 - i); // NOLINT(build/unsigned)
+}
+
+template<class T>
+template<class Release>
+bool
+ReorderBuffer<T>::push(const T& input, Release&& release)
+{
+  ++m_counters.n_received;
+  if (input.time_start < m_released_time) {
+    ++m_counters.n_late;
+    return false;
+  }
+
+  // When full, release the earliest item, which may be the input itself.
+  if (m_free_slots.empty()) {
+    ++m_counters.n_overflow;
+    if (input.time_start < m_heap.front().time_start) {
+      m_released_time = input.time_start;
+      ++m_counters.n_released;
+      release(input);
+      return true;
+    }
+    release_earliest(release);
+  }
+  uint32_t slot = m_free_slots.back(); // NOLINT(build/unsigned)
+  m_free_slots.pop_back();
+  m_items[slot] = input;
+  m_heap.push_back(Key{ input.time_start, m_sequence++, slot });
+  std::push_heap(m_heap.begin(), m_heap.end(), later);
+  m_latest_time = std::max(m_latest_time, input.time_start);
+  m_counters.max_buffered = std::max(m_counters.max_buffered, m_heap.size());
+
+  if (m_latest_time < m_max_lateness)
+    return true;
+  const timestamp_t release_before = m_latest_time - m_max_lateness;
+  while (!m_heap.empty() && m_heap.front().time_start <= release_before)
+    release_earliest(release);
+
+  return true;
+}
+
+template<class T>
+template<class Release>
+void
+ReorderBuffer<T>::release_until(timestamp_t until, Release&& release)
+{
+  while (!m_heap.empty() && m_heap.front().time_start < until)
+    release_earliest(release);
+  m_released_time = std::max(m_released_time, until);
+  m_latest_time = std::max(m_latest_time, until);
+}
+
+template<class T>
+template<class Release>
+void
+ReorderBuffer<T>::drain(Release&& release)
+{
+  while (!m_heap.empty())
+    release_earliest(release);
+}
+
+template<class T>
+template<class Release>
+void
+ReorderBuffer<T>::release_earliest(Release& release)
+{
+  std::pop_heap(m_heap.begin(), m_heap.end(), later);
+  uint32_t slot = m_heap.back().slot; // NOLINT(build/unsigned)
+  m_heap.pop_back();
+  m_free_slots.push_back(slot);
+  m_released_time = m_items[slot].time_start;
+  ++m_counters.n_released;
+  release(m_items[slot]);
+}
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_INCLUDE_TRIGGERALGS_REORDERBUFFER_HPP_
@@ -0,0 +1,61 @@
+/**
+ * @file ReorderingTriggerActivityMaker.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_INCLUDE_TRIGGERALGS_REORDERINGTRIGGERACTIVITYMAKER_HPP_
+#define TRIGGERALGS_INCLUDE_TRIGGERALGS_REORDERINGTRIGGERACTIVITYMAKER_HPP_
+
+#include "triggeralgs/ReorderBuffer.hpp"
+#include "triggeralgs/TriggerActivityMaker.hpp"
+
+#include <memory>
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief Puts TPs back in time order in front of any TA maker.
+///
+/// TPs from several links arrive slightly out of order, while the makers
+/// assume time order. This maker holds each TP for up to max_lateness ticks
+/// of stream time in a ReorderBuffer and passes them on in order; TPs later
+/// than that are dropped and counted.
+///
+/// Configured with "max_lateness" (ticks) and "max_buffered_tps"; the whole
+/// configuration is also passed on to the wrapped maker.
+class ReorderingTriggerActivityMaker : public TriggerActivityMaker
+{
+public:
+  explicit ReorderingTriggerActivityMaker(std::unique_ptr<TriggerActivityMaker> maker);
+
+  void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta);
+  void operator()(Span<const TriggerPrimitive> input_tps, std::vector<TriggerActivity>& output_ta);
+
+  /// Pass on every held TP before `until`, then flush the wrapped maker.
+  void flush(timestamp_t until, std::vector<TriggerActivity>& output_ta);
+
+  void configure(const nlohmann::json& config);
+
+  /// TPs held for reordering plus those held by the wrapped maker.
+  std::size_t window_occupancy() const { return m_buffer.size() + m_maker->window_occupancy(); }
+
+  const ReorderBuffer<TriggerPrimitive>::Counters& counters() const { return m_buffer.counters(); }
+  TriggerActivityMaker& maker() { return *m_maker; }
+
+private:
+  std::unique_ptr<TriggerActivityMaker> m_maker;
+
+  // Configurable parameters.
+  timestamp_t m_max_lateness = 0;
+  uint32_t m_max_buffered_tps = 1 << 16; // NOLINT(build/unsigned)
+
+  // Built from the parameters above, so declared after them.
+  ReorderBuffer<TriggerPrimitive> m_buffer;
+};
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_INCLUDE_TRIGGERALGS_REORDERINGTRIGGERACTIVITYMAKER_HPP_
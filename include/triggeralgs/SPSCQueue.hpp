@@ -0,0 +1,97 @@
+/**
+ * @file SPSCQueue.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_INCLUDE_TRIGGERALGS_SPSCQUEUE_HPP_
+#define TRIGGERALGS_INCLUDE_TRIGGERALGS_SPSCQUEUE_HPP_
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief Bounded lock-free queue between exactly one producer thread and one
+/// consumer thread.
+///
+/// A power-of-two ring of slots with the write and read positions on separate
+/// cache lines. Each side also keeps a cached copy of the other side's
+/// position, so that it only reads the shared one when the queue looks full
+/// (producer) or empty (consumer).
+template<class T>
+class SPSCQueue
+{
+public:
+  /// Capacity is rounded up to a power of two.
+  explicit SPSCQueue(std::size_t capacity)
+  {
+    std::size_t size = 2;
+    while (size < capacity)
+      size <<= 1;
+    m_slots.resize(size);
+    m_mask = size - 1;
+  }
+
+  SPSCQueue(const SPSCQueue&) = delete;
+  SPSCQueue& operator=(const SPSCQueue&) = delete;
+
+  /// Producer side. Returns false, leaving the item alone, if the queue is full.
+  template<class U>
+  bool try_push(U&& item)
+  {
+    const std::size_t write = m_write.load(std::memory_order_relaxed);
+    if (write - m_read_cache > m_mask) {
+      m_read_cache = m_read.load(std::memory_order_acquire);
+      if (write - m_read_cache > m_mask)
+        return false;
+    }
+    m_slots[write & m_mask] = std::forward<U>(item);
+    m_write.store(write + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Consumer side. Returns false if the queue is empty.
+  bool try_pop(T& item)
+  {
+    const std::size_t read = m_read.load(std::memory_order_relaxed);
+    if (read == m_write_cache) {
+      m_write_cache = m_write.load(std::memory_order_acquire);
+      if (read == m_write_cache)
+        return false;
+    }
+    item = std::move(m_slots[read & m_mask]);
+    m_read.store(read + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Either side; exact only when the other side is idle.
+  bool is_empty() const
+  {
+    return m_read.load(std::memory_order_acquire) == m_write.load(std::memory_order_acquire);
+  }
+
+  std::size_t capacity() const { return m_mask + 1; }
+
+private:
+  static constexpr std::size_t cache_line = 64;
+
+  std::vector<T> m_slots;
+  std::size_t m_mask = 0;
+
+  // Written by the producer.
+  alignas(cache_line) std::atomic<std::size_t> m_write{ 0 };
+  std::size_t m_read_cache = 0;
+
+  // Written by the consumer.
+  alignas(cache_line) std::atomic<std::size_t> m_read{ 0 };
+  std::size_t m_write_cache = 0;
+};
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_INCLUDE_TRIGGERALGS_SPSCQUEUE_HPP_
@@ -0,0 +1,117 @@
+/**
+ * @file ShardedTriggerActivityMaker.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_INCLUDE_TRIGGERALGS_SHARDEDTRIGGERACTIVITYMAKER_HPP_
+#define TRIGGERALGS_INCLUDE_TRIGGERALGS_SHARDEDTRIGGERACTIVITYMAKER_HPP_
+
+#include "triggeralgs/SPSCQueue.hpp"
+#include "triggeralgs/TriggerActivityMaker.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief Runs N instances of a registered TA maker on their own threads.
+///
+/// The instances are built through TriggerActivityFactory and each is fed the
+/// TPs of its own detids or channel ranges, through a lock-free SPSC queue, by
+/// a worker thread that can be pinned to a core. The TAs come back through a
+/// second SPSC queue per shard and are handed out by the calls on the caller's
+/// thread. Each shard's TAs keep their order, but TAs of different shards are
+/// interleaved as they come.
+///
+/// Configured with:
+///  - "algorithm": the registered name of the maker to run, eg
+///    "TriggerActivityMakerHorizontalMuonPlugin";
+///  - "n_shards";
+///  - "shard_by": "detid" (default) or "channel", with "channel_range" the
+///    number of consecutive channels that go to the same shard;
+///  - "queue_size": the capacity of each queue, in TPs or TAs;
+///  - "pin_threads" and "first_cpu": pin shard i to core first_cpu + i.
+/// The whole configuration is also passed on to each instance.
+class ShardedTriggerActivityMaker : public TriggerActivityMaker
+{
+public:
+  ShardedTriggerActivityMaker() = default;
+  ~ShardedTriggerActivityMaker();
+
+  void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta);
+  void operator()(Span<const TriggerPrimitive> input_tps, std::vector<TriggerActivity>& output_ta);
+
+  /// Flush every instance, and wait for all of the TAs made up to then.
+  void flush(timestamp_t until, std::vector<TriggerActivity>& output_ta);
+
+  /// Wait until every shard has processed the TPs given so far, and collect the TAs.
+  void drain(std::vector<TriggerActivity>& output_ta);
+
+  void configure(const nlohmann::json& config);
+
+  std::size_t n_shards() const { return m_shards.size(); }
+  /// Throws BadConfiguration until configure() has started the shards.
+  std::size_t shard_of(const TriggerPrimitive& input_tp) const;
+
+private:
+  struct Message
+  {
+    enum class Kind : uint8_t // NOLINT(build/unsigned)
+    {
+      kTP,
+      kFlush,
+      kSync,
+      kStop
+    };
+    Kind kind = Kind::kTP;
+    timestamp_t until = 0;
+    uint64_t sync_number = 0; // NOLINT(build/unsigned)
+    TriggerPrimitive tp;
+  };
+
+  struct Shard
+  {
+    Shard(std::unique_ptr<TriggerActivityMaker> shard_maker, std::size_t queue_size)
+      : maker(std::move(shard_maker))
+      , input(queue_size)
+      , output(queue_size)
+    {}
+
+    std::unique_ptr<TriggerActivityMaker> maker;
+    SPSCQueue<Message> input;
+    SPSCQueue<TriggerActivity> output;
+    std::atomic<uint64_t> synced{ 0 }; // NOLINT(build/unsigned) Last sync_number done
+    std::thread thread;
+  };
+
+  static void run_shard(Shard& shard);
+  void send(Shard& shard, const Message& message, std::vector<TriggerActivity>& output_ta);
+  void collect(std::vector<TriggerActivity>& output_ta);
+  void synchronise(Message message, std::vector<TriggerActivity>& output_ta);
+  void stop();
+
+  std::vector<std::unique_ptr<Shard>> m_shards;
+  uint64_t m_sync_number = 0; // NOLINT(build/unsigned)
+  uint32_t m_since_collect = 0; // NOLINT(build/unsigned)
+
+  // Configurable parameters.
+  std::string m_algorithm;
+  uint16_t m_n_shards = 1;      // NOLINT(build/unsigned)
+  bool m_shard_by_channel = false;
+  channel_t m_channel_range = 256;
+  uint32_t m_queue_size = 8192; // NOLINT(build/unsigned)
+  bool m_pin_threads = false;
+  int m_first_cpu = 0;
+};
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_INCLUDE_TRIGGERALGS_SHARDEDTRIGGERACTIVITYMAKER_HPP_
@@ -0,0 +1,298 @@
+/**
+ * @file SlidingWindow.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_INCLUDE_TRIGGERALGS_SLIDINGWINDOW_HPP_
+#define TRIGGERALGS_INCLUDE_TRIGGERALGS_SLIDINGWINDOW_HPP_
+
+#include "triggeralgs/TriggerActivity.hpp"
+#include "triggeralgs/TriggerPrimitive.hpp"
+#include "triggeralgs/Types.hpp"
+
+#include <cstddef>
+#include <ostream>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace triggeralgs {
+
+/// Whether SlidingWindow::add() keeps the items ordered by time_start, placing
+/// a late item after those that start no later than it, or simply appends.
+/// TAs can reach the TC makers out of order, TPs are taken as they come.
+template<class T>
+struct SlidingWindowKeepsTimeOrder : std::false_type
+{};
+
+template<>
+struct SlidingWindowKeepsTimeOrder<TriggerActivity> : std::true_type
+{};
+
+/// Per-item state of aggregators that do not need any.
+struct NoItemState
+{};
+
+/// @brief Base of the running aggregates of a SlidingWindow.
+///
+/// An aggregator is mixed into the window, so its public members and functions
+/// (eg ADCSum::adc_integral) are those of the window. It overrides the hooks it
+/// needs; the default ones are empty and compile away:
+///  - on_add(item, state) when an item enters the window,
+///  - on_remove(item, state) when it leaves, oldest first,
+///  - on_clear() when the window is emptied,
+///  - describe(os) for the window's operator<<.
+/// ItemState is stored next to each item, for data worked out once on the way
+/// in and needed again on the way out.
+struct WindowAggregator
+{
+  using ItemState = NoItemState;
+
+protected:
+  template<class T>
+  void on_add(const T&, ItemState&)
+  {}
+  template<class T>
+  void on_remove(const T&, const ItemState&)
+  {}
+  void on_clear() {}
+  void describe(std::ostream&) const {}
+};
+
+/// @brief Time window over TPs or TAs with compile-time selected aggregates.
+///
+/// Items are held in a power-of-two ring buffer that doubles when full, so
+/// sliding the window costs O(k) in the items that leave it. Index 0 is always
+/// the oldest item.
+///
+/// @tparam T TriggerPrimitive or TriggerActivity
+/// @tparam Aggregators Running aggregates to keep, see WindowAggregator
+template<class T, class... Aggregators>
+class SlidingWindow : public Aggregators...
+{
+public:
+  bool is_empty() const { return m_size == 0; }
+
+  std::size_t size() const { return m_size; }
+
+  /// Add an item without checking the window length.
+  void add(const T& input);
+
+  /// Empty the window, keeping its storage.
+  void clear();
+
+  /// Remove all of the items that would make the window longer than
+  /// window_length with the input added, then add it. If that empties the
+  /// window, start a new one on the input.
+  void move(const T& input, timestamp_t const& window_length);
+
+  /// Empty the window and start it again on the input.
+  void reset(const T& input);
+
+  /// Whether no input at or after `until` can be added without moving the
+  /// window, ie whether a maker can evaluate the window now rather than wait
+  /// for that input.
+  bool is_complete(timestamp_t until, timestamp_t const& window_length) const
+  {
+    return m_size != 0 && until >= time_start && until - time_start >= window_length;
+  }
+
+  /// Remove the items that move() would remove for any input at or after
+  /// `until`, ahead of that input.
+  void expire(timestamp_t until, timestamp_t const& window_length);
+
+  const T& at(std::size_t i) const { return m_slots[slot(i)].item; }
+  const T& front() const { return at(0); }
+  const T& back() const { return at(m_size - 1); }
+
+  /// Copy of the items in the window, oldest first, eg for TriggerActivity::inputs.
+  std::vector<T> inputs() const;
+
+  /// Write each aggregate's summary, for operator<<.
+  void describe(std::ostream& os) const { (this->Aggregators::describe(os), ...); }
+
+  timestamp_t time_start = 0;
+
+private:
+  struct Slot
+  {
+    T item;
+    std::tuple<typename Aggregators::ItemState...> states;
+  };
+
+  using AggregatorIndices = std::index_sequence_for<Aggregators...>;
+
+  // Capacity is always a power of two, so wrapping is a mask.
+  std::size_t slot(std::size_t i) const { return (m_head + i) & (m_slots.size() - 1); }
+
+  std::size_t insert_position(const T& input) const;
+  void pop_front();
+  void grow();
+
+  template<std::size_t... I>
+  void aggregate_add(Slot& entry, std::index_sequence<I...>)
+  {
+    (this->Aggregators::on_add(entry.item, std::get<I>(entry.states)), ...);
+  }
+  template<std::size_t... I>
+  void aggregate_remove(const Slot& entry, std::index_sequence<I...>)
+  {
+    (this->Aggregators::on_remove(entry.item, std::get<I>(entry.states)), ...);
+  }
+
+  std::vector<Slot> m_slots;
+  std::size_t m_head = 0;
+  std::size_t m_size = 0;
+};
+
+template<class T, class... Aggregators>
+void
+SlidingWindow<T, Aggregators...>::add(const T& input)
+{
+  if (m_size == m_slots.size())
+    grow();
+
+  // Rotate the spare slot past the later items, rather than moving onto it,
+  // so the vectors in the slots keep their capacity.
+  std::size_t position = insert_position(input);
+  for (std::size_t i = m_size; i > position; --i)
+    std::swap(m_slots[slot(i)], m_slots[slot(i - 1)]);
+  ++m_size;
+
+  Slot& entry = m_slots[slot(position)];
+  entry.item = input;
+  aggregate_add(entry, AggregatorIndices{});
+}
+
+template<class T, class... Aggregators>
+void
+SlidingWindow<T, Aggregators...>::clear()
+{
+  (this->Aggregators::on_clear(), ...);
+  m_head = 0;
+  m_size = 0;
+  time_start = 0;
+}
+
+template<class T, class... Aggregators>
+void
+SlidingWindow<T, Aggregators...>::move(const T& input, timestamp_t const& window_length)
+{
+  while (m_size != 0 && !(input.time_start - front().time_start < window_length))
+    pop_front();
+
+  // Make the window start time the start time of what is now the first item.
+  if (m_size != 0) {
+    time_start = front().time_start;
+    add(input);
+  } else {
+    reset(input);
+  }
+}
+
+template<class T, class... Aggregators>
+void
+SlidingWindow<T, Aggregators...>::reset(const T& input)
+{
+  clear();
+  time_start = input.time_start;
+  add(input);
+}
+
+template<class T, class... Aggregators>
+void
+SlidingWindow<T, Aggregators...>::expire(timestamp_t until, timestamp_t const& window_length)
+{
+  std::size_t old_size = m_size;
+  while (m_size != 0 && front().time_start <= until && !(until - front().time_start < window_length))
+    pop_front();
+
+  // As in move(), the window now starts at what is now the first item.
+  if (m_size == old_size)
+    return;
+  if (m_size != 0)
+    time_start = front().time_start;
+  else
+    clear();
+}
+
+template<class T, class... Aggregators>
+std::vector<T>
+SlidingWindow<T, Aggregators...>::inputs() const
+{
+  std::vector<T> items;
+  items.reserve(m_size);
+  for (std::size_t i = 0; i < m_size; ++i)
+    items.push_back(at(i));
+  return items;
+}
+
+template<class T, class... Aggregators>
+std::size_t
+SlidingWindow<T, Aggregators...>::insert_position(const T& input) const
+{
+  if constexpr (SlidingWindowKeepsTimeOrder<T>::value) {
+    // Items normally arrive in order, so check the back first.
+    if (m_size == 0 || !(input.time_start < back().time_start))
+      return m_size;
+
+    // Otherwise, after every item that does not start later than the input.
+    std::size_t first = 0;
+    std::size_t count = m_size;
+    while (count > 0) {
+      std::size_t step = count / 2;
+      if (!(input.time_start < at(first + step).time_start)) {
+        first += step + 1;
+        count -= step + 1;
+      } else {
+        count = step;
+      }
+    }
+    return first;
+  } else {
+    return m_size;
+  }
+}
+
+template<class T, class... Aggregators>
+void
+SlidingWindow<T, Aggregators...>::pop_front()
+{
+  aggregate_remove(m_slots[m_head], AggregatorIndices{});
+  m_head = (m_head + 1) & (m_slots.size() - 1);
+  --m_size;
+}
+
+template<class T, class... Aggregators>
+void
+SlidingWindow<T, Aggregators...>::grow()
+{
+  // Double the capacity and unwrap the ring so the oldest item is at slot 0.
+  std::vector<Slot> grown(m_slots.empty() ? 64 : 2 * m_slots.size());
+  for (std::size_t i = 0; i < m_size; ++i)
+    grown[i] = std::move(m_slots[slot(i)]);
+  m_slots.swap(grown);
+  m_head = 0;
+}
+
+template<class T, class... Aggregators>
+std::ostream&
+operator<<(std::ostream& os, const SlidingWindow<T, Aggregators...>& window)
+{
+  if (window.is_empty()) {
+    os << "Window is empty!\n";
+  } else {
+    os << "Window start: " << window.time_start << ", end: " << window.back().time_start << ", with "
+       << window.size() << " inputs.\n";
+    window.describe(os);
+  }
+  return os;
+}
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_INCLUDE_TRIGGERALGS_SLIDINGWINDOW_HPP_
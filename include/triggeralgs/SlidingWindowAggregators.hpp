@@ -0,0 +1,180 @@
+/**
+ * @file SlidingWindowAggregators.hpp
+ *
+ * Running aggregates to mix into a SlidingWindow.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_INCLUDE_TRIGGERALGS_SLIDINGWINDOWAGGREGATORS_HPP_
+#define TRIGGERALGS_INCLUDE_TRIGGERALGS_SLIDINGWINDOWAGGREGATORS_HPP_
+
+#include "triggeralgs/ChannelOccupancy.hpp"
+#include "triggeralgs/SlidingWindow.hpp"
+#include "triggeralgs/TriggerActivity.hpp"
+#include "triggeralgs/TriggerPrimitive.hpp"
+#include "triggeralgs/Types.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <ostream>
+#include <vector>
+
+namespace triggeralgs {
+
+/// Total adc_integral of the window.
+template<class Sum>
+class ADCSum : public WindowAggregator
+{
+public:
+  Sum adc_integral = 0;
+
+protected:
+  template<class T>
+  void on_add(const T& item, ItemState&)
+  {
+    adc_integral += item.adc_integral;
+  }
+  template<class T>
+  void on_remove(const T& item, const ItemState&)
+  {
+    adc_integral -= item.adc_integral;
+  }
+  void on_clear() { adc_integral = 0; }
+  void describe(std::ostream& os) const { os << "Total of: " << adc_integral << " ADC counts.\n"; }
+};
+
+/// Total time_over_threshold of the TPs in the window.
+class TOTSum : public WindowAggregator
+{
+public:
+  timestamp_t time_over_threshold = 0;
+
+protected:
+  void on_add(const TriggerPrimitive& tp, ItemState&) { time_over_threshold += tp.time_over_threshold; }
+  void on_remove(const TriggerPrimitive& tp, const ItemState&) { time_over_threshold -= tp.time_over_threshold; }
+  void on_clear() { time_over_threshold = 0; }
+  void describe(std::ostream& os) const { os << "Total of: " << time_over_threshold << " ticks over threshold.\n"; }
+};
+
+/// Largest adc_peak in the window, from a queue of the items that could still
+/// become the peak (each is larger than all those after it). Relies on items
+/// leaving the window in the order they entered, so only for windows that do
+/// not keep time order.
+class PeakADC : public WindowAggregator
+{
+public:
+  uint16_t adc_peak() const { return m_candidates.empty() ? 0 : m_candidates.front().adc_peak; }
+  timestamp_t time_peak() const { return m_candidates.empty() ? 0 : m_candidates.front().time_peak; }
+  channel_t channel_peak() const { return m_candidates.empty() ? 0 : m_candidates.front().channel; }
+
+protected:
+  void on_add(const TriggerPrimitive& tp, ItemState&)
+  {
+    // Ties go to the earlier TP, as in the TA makers' peak finding.
+    while (!m_candidates.empty() && m_candidates.back().adc_peak < tp.adc_peak)
+      m_candidates.pop_back();
+    m_candidates.push_back({ m_n_added++, tp.adc_peak, tp.time_peak, tp.channel });
+  }
+  void on_remove(const TriggerPrimitive&, const ItemState&)
+  {
+    if (!m_candidates.empty() && m_candidates.front().sequence == m_n_removed)
+      m_candidates.pop_front();
+    ++m_n_removed;
+  }
+  void on_clear()
+  {
+    m_candidates.clear();
+    m_n_added = 0;
+    m_n_removed = 0;
+  }
+  void describe(std::ostream& os) const
+  {
+    os << "Peak of: " << adc_peak() << " ADC counts on channel " << channel_peak() << ".\n";
+  }
+
+private:
+  struct Candidate
+  {
+    uint64_t sequence; // NOLINT(build/unsigned)
+    uint16_t adc_peak;
+    timestamp_t time_peak;
+    channel_t channel;
+  };
+
+  std::deque<Candidate> m_candidates;
+  uint64_t m_n_added = 0;   // NOLINT(build/unsigned)
+  uint64_t m_n_removed = 0; // NOLINT(build/unsigned)
+};
+
+/// Channels hit by the items in the window, see ChannelOccupancy.
+template<class T>
+class DistinctChannels;
+
+/// Counts a hit per TP.
+template<>
+class DistinctChannels<TriggerPrimitive> : public WindowAggregator
+{
+public:
+  uint16_t n_channels_hit() const { return m_channel_occupancy.n_channels_hit(); }
+
+  const ChannelOccupancy& channel_occupancy() const { return m_channel_occupancy; }
+
+  /// Shorthand for channel_occupancy().longest_adjacent_run().
+  uint16_t longest_adjacent_run(channel_t max_step, uint16_t tolerance) const
+  {
+    return m_channel_occupancy.longest_adjacent_run(max_step, tolerance);
+  }
+
+protected:
+  void on_add(const TriggerPrimitive& tp, ItemState&) { m_channel_occupancy.add(tp.channel); }
+  void on_remove(const TriggerPrimitive& tp, const ItemState&) { m_channel_occupancy.remove(tp.channel); }
+  void on_clear() { m_channel_occupancy.clear(); }
+  void describe(std::ostream& os) const { os << n_channels_hit() << " independent channels have hits.\n"; }
+
+private:
+  ChannelOccupancy m_channel_occupancy;
+};
+
+/// Counts a hit per TA with TPs on the channel, however many TPs that is. The
+/// TA's distinct channels are worked out once on the way in and kept with it,
+/// so eviction does not walk its TPs again.
+template<>
+class DistinctChannels<TriggerActivity> : public WindowAggregator
+{
+public:
+  using ItemState = std::vector<channel_t>;
+
+  uint16_t n_channels_hit() const { return m_channel_occupancy.n_channels_hit(); }
+
+  const ChannelOccupancy& channel_occupancy() const { return m_channel_occupancy; }
+
+protected:
+  void on_add(const TriggerActivity& ta, ItemState& channels)
+  {
+    channels.clear();
+    for (const TriggerPrimitive& tp : ta.inputs)
+      channels.push_back(tp.channel);
+    std::sort(channels.begin(), channels.end());
+    channels.erase(std::unique(channels.begin(), channels.end()), channels.end());
+    for (channel_t channel : channels)
+      m_channel_occupancy.add(channel);
+  }
+  void on_remove(const TriggerActivity&, const ItemState& channels)
+  {
+    for (channel_t channel : channels)
+      m_channel_occupancy.remove(channel);
+  }
+  void on_clear() { m_channel_occupancy.clear(); }
+  void describe(std::ostream& os) const { os << n_channels_hit() << " independent channels have hits.\n"; }
+
+private:
+  ChannelOccupancy m_channel_occupancy;
+};
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_INCLUDE_TRIGGERALGS_SLIDINGWINDOWAGGREGATORS_HPP_
@@ -0,0 +1,74 @@
+/**
+ * @file Span.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_INCLUDE_TRIGGERALGS_SPAN_HPP_
+#define TRIGGERALGS_INCLUDE_TRIGGERALGS_SPAN_HPP_
+
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+namespace triggeralgs {
+
+/// @brief Non-owning view of a contiguous sequence of trigger objects.
+///
+/// Used by the batch entry points of the makers, so that a caller holding a
+/// buffer of TPs (or TAs/TCs) can hand the whole buffer over in one call. To be
+/// replaced with std::span once we move to C++20.
+template<class T>
+class Span
+{
+public:
+  using element_type = T;
+  using value_type = std::remove_cv_t<T>;
+  using iterator = T*;
+
+  constexpr Span() = default;
+  constexpr Span(T* data, std::size_t size)
+    : m_data(data)
+    , m_size(size)
+  {}
+
+  /// Construct from any contiguous container with data() and size(), e.g.
+  /// std::vector or std::array.
+  template<class Container,
+           class = std::enable_if_t<std::is_convertible_v<decltype(std::declval<Container&>().data()), T*>>>
+  constexpr Span(Container& container)
+    : m_data(container.data())
+    , m_size(container.size())
+  {}
+
+  constexpr T* data() const { return m_data; }
+  constexpr std::size_t size() const { return m_size; }
+  constexpr bool empty() const { return m_size == 0; }
+
+  constexpr iterator begin() const { return m_data; }
+  constexpr iterator end() const { return m_data + m_size; }
+
+  constexpr T& operator[](std::size_t idx) const { return m_data[idx]; }
+  constexpr T& front() const { return m_data[0]; }
+  constexpr T& back() const { return m_data[m_size - 1]; }
+
+  /// View of `count` elements starting at `offset`. Clamped to the end.
+  constexpr Span subspan(std::size_t offset, std::size_t count) const
+  {
+    if (offset > m_size)
+      offset = m_size;
+    if (count > m_size - offset)
+      count = m_size - offset;
+    return Span(m_data + offset, count);
+  }
+
+private:
+  T* m_data = nullptr;
+  std::size_t m_size = 0;
+};
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_INCLUDE_TRIGGERALGS_SPAN_HPP_
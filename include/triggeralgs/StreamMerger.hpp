@@ -0,0 +1,228 @@
+/**
+ * @file StreamMerger.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_INCLUDE_TRIGGERALGS_STREAMMERGER_HPP_
+#define TRIGGERALGS_INCLUDE_TRIGGERALGS_STREAMMERGER_HPP_
+
+#include "triggeralgs/Types.hpp"
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief Merges several time-ordered TA or TC streams into one.
+///
+/// Each input is a producer, eg a TA maker, whose items come in time_start
+/// order, along with a watermark: the promise that none of its later items
+/// starts before it. An item is released once no input can still produce an
+/// earlier one, ie once it starts no later than the watermark of every input
+/// with nothing queued, so the merge holds items back only as long as the
+/// slowest producer's watermark requires.
+///
+/// The inputs meet in a tournament tree keyed by the time_start of their
+/// first queued item, or their watermark when they have none, so releasing an
+/// item costs O(log k) in the number of inputs. Items that start before their
+/// producer's watermark are dropped.
+///
+/// @tparam T TriggerActivity or TriggerCandidate
+template<class T>
+class StreamMerger
+{
+public:
+  struct Counters
+  {
+    uint64_t n_released = 0; // NOLINT(build/unsigned)
+    uint64_t n_late = 0;     // NOLINT(build/unsigned) Dropped: started before their input's watermark
+    std::size_t max_buffered = 0;
+  };
+
+  explicit StreamMerger(std::size_t n_inputs = 0) { reset(n_inputs); }
+
+  /// Empty the merger and start again with n_inputs inputs, all with watermark 0.
+  void reset(std::size_t n_inputs);
+
+  /// Queue an item from the given input. The input's watermark moves up to the
+  /// item's time_start. Returns false if the item was dropped as late.
+  bool push(std::size_t input, T item);
+
+  /// Move the given input's watermark up to `until`.
+  void advance(std::size_t input, timestamp_t until);
+
+  /// The given input will produce nothing more.
+  void close(std::size_t input) { advance(input, std::numeric_limits<timestamp_t>::max()); }
+
+  /// Pass each item that no input can overtake to release(item), in time order.
+  template<class Release>
+  void release(Release&& release);
+
+  /// Close every input and pass everything queued to release(item), in time
+  /// order, eg at the end of a run.
+  template<class Release>
+  void drain(Release&& release);
+
+  std::size_t n_inputs() const { return m_inputs.size(); }
+  std::size_t size() const { return m_size; }
+  timestamp_t watermark(std::size_t input) const { return m_inputs[input].watermark; }
+  const Counters& counters() const { return m_counters; }
+
+private:
+  struct Input
+  {
+    std::deque<T> queue;
+    timestamp_t watermark = 0;
+  };
+
+  // Whether input a goes before input b: earlier first item or watermark,
+  // then a queued item before a watermark, then the lower input.
+  bool goes_before(std::size_t a, std::size_t b) const;
+
+  // Replay the matches on the path from the input's leaf to the root.
+  void update(std::size_t input);
+
+  template<class Release>
+  void release_winner(Release& release);
+
+  std::vector<Input> m_inputs;
+  // m_tree[1] is the overall winner and m_tree[i] the winner of the match
+  // between m_tree[2i] and m_tree[2i+1]; input j plays from leaf m_leaves + j.
+  std::vector<std::size_t> m_tree;
+  std::size_t m_leaves = 1;
+  std::size_t m_size = 0;
+  Counters m_counters;
+};
+
+template<class T>
+void
+StreamMerger<T>::reset(std::size_t n_inputs)
+{
+  m_inputs.assign(n_inputs, Input());
+  m_leaves = 1;
+  while (m_leaves < n_inputs)
+    m_leaves <<= 1;
+  // Unused leaves hold n_inputs, which loses every match.
+  m_tree.assign(2 * m_leaves, n_inputs);
+  for (std::size_t i = 0; i < n_inputs; ++i)
+    m_tree[m_leaves + i] = i;
+  for (std::size_t node = m_leaves - 1; node >= 1; --node) {
+    std::size_t a = m_tree[2 * node], b = m_tree[2 * node + 1];
+    m_tree[node] = goes_before(a, b) ? a : b;
+  }
+  m_size = 0;
+  m_counters = Counters();
+}
+
+template<class T>
+bool
+StreamMerger<T>::goes_before(std::size_t a, std::size_t b) const
+{
+  if (b >= m_inputs.size())
+    return true;
+  if (a >= m_inputs.size())
+    return false;
+
+  const Input& input_a = m_inputs[a];
+  const Input& input_b = m_inputs[b];
+  timestamp_t time_a = input_a.queue.empty() ? input_a.watermark : input_a.queue.front().time_start;
+  timestamp_t time_b = input_b.queue.empty() ? input_b.watermark : input_b.queue.front().time_start;
+  if (time_a != time_b)
+    return time_a < time_b;
+  if (input_a.queue.empty() != input_b.queue.empty())
+    return !input_a.queue.empty();
+  return a < b;
+}
+
+template<class T>
+void
+StreamMerger<T>::update(std::size_t input)
+{
+  for (std::size_t node = (m_leaves + input) / 2; node >= 1; node /= 2) {
+    std::size_t a = m_tree[2 * node], b = m_tree[2 * node + 1];
+    m_tree[node] = goes_before(a, b) ? a : b;
+  }
+}
+
+template<class T>
+bool
+StreamMerger<T>::push(std::size_t input, T item)
+{
+  // Nothing has been released past any input's watermark, so this also keeps
+  // the released stream in order.
+  Input& in = m_inputs[input];
+  if (item.time_start < in.watermark) {
+    ++m_counters.n_late;
+    return false;
+  }
+
+  in.watermark = item.time_start;
+  in.queue.push_back(std::move(item));
+  ++m_size;
+  m_counters.max_buffered = std::max(m_counters.max_buffered, m_size);
+  // Only a first item changes the input's key.
+  if (in.queue.size() == 1)
+    update(input);
+  return true;
+}
+
+template<class T>
+void
+StreamMerger<T>::advance(std::size_t input, timestamp_t until)
+{
+  Input& in = m_inputs[input];
+  if (until <= in.watermark)
+    return;
+  in.watermark = until;
+  if (in.queue.empty())
+    update(input);
+}
+
+template<class T>
+template<class Release>
+void
+StreamMerger<T>::release(Release&& release)
+{
+  // The winner is an item as long as it starts no later than every watermark
+  // of an input with nothing queued.
+  while (m_size != 0 && !m_inputs[m_tree[1]].queue.empty())
+    release_winner(release);
+}
+
+template<class T>
+template<class Release>
+void
+StreamMerger<T>::drain(Release&& release)
+{
+  for (std::size_t i = 0; i < m_inputs.size(); ++i)
+    close(i);
+  this->release(release);
+}
+
+template<class T>
+template<class Release>
+void
+StreamMerger<T>::release_winner(Release& release)
+{
+  const std::size_t input = m_tree[1];
+  Input& in = m_inputs[input];
+  T item = std::move(in.queue.front());
+  in.queue.pop_front();
+  --m_size;
+  update(input);
+
+  ++m_counters.n_released;
+  release(std::move(item));
+}
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_INCLUDE_TRIGGERALGS_STREAMMERGER_HPP_
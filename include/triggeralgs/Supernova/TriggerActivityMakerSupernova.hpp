@@ -49,7 +49,16 @@ class TriggerActivityMakerSupernova : public TriggerActivityMaker
 public:
   void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta) override;
 
-  void flush(timestamp_t, std::vector<TriggerActivity>& tas) override { tas.push_back(MakeTriggerActivity()); }
+  /// Send out the current activity once no TP from `until` on can be time consistent with it.
+  void flush(timestamp_t until, std::vector<TriggerActivity>& tas) override
+  {
+    if (m_time_start == 0 || until <= m_time_end + m_time_tolerance)
+      return;
+    tas.push_back(MakeTriggerActivity());
+    // The next TP starts a new activity.
+    m_time_start = 0;
+    m_tp_list.clear();
+  }
 
 protected:
   timestamp_diff_t m_time_tolerance =
@@ -27,6 +27,10 @@ public:
   /// The function that gets call when there is a new activity
   void operator()(const TriggerActivity&, std::vector<TriggerCandidate>&);
 
+  /// Candidates are sent out as soon as the threshold is reached, so there is nothing
+  /// to emit here; only drop the activities that no TA from `until` on can count.
+  void flush(timestamp_t until, std::vector<TriggerCandidate>&) override { FlushOldActivity(until); }
+
 protected:
   std::vector<TriggerActivity::TriggerActivityData> m_activity;
   /// Slinding time window to count activities
@@ -0,0 +1,124 @@
+/**
+ * @file TPFile.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_INCLUDE_TRIGGERALGS_TPFILE_HPP_
+#define TRIGGERALGS_INCLUDE_TRIGGERALGS_TPFILE_HPP_
+
+#include "triggeralgs/Span.hpp"
+#include "triggeralgs/TriggerPrimitive.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <string>
+
+namespace triggeralgs {
+
+/// Binary TP files are a 64-byte header followed by the TPs exactly as they
+/// are laid out in memory, so that they can be mapped and used in place. The
+/// header records the TP layout, and a file written with another layout is
+/// refused rather than misread.
+struct TPFileHeader
+{
+  static constexpr char expected_magic[8] = { 'T', 'R', 'G', 'T', 'P', 'B', 'I', 'N' };
+  static constexpr uint32_t current_format_version = 1; // NOLINT(build/unsigned)
+
+  char magic[8] = { 'T', 'R', 'G', 'T', 'P', 'B', 'I', 'N' };
+  uint32_t format_version = current_format_version;                 // NOLINT(build/unsigned)
+  uint32_t record_size = sizeof(TriggerPrimitive);                   // NOLINT(build/unsigned)
+  uint16_t tp_version = TriggerPrimitive().version;                  // NOLINT(build/unsigned)
+  uint16_t byte_order = 0x0102;                                      // NOLINT(build/unsigned) As written by this host
+  char reserved[44] = {};
+};
+static_assert(sizeof(TPFileHeader) == 64, "TP file header must stay 64 bytes");
+
+/// @brief Maps a binary TP file into memory and hands out its TPs as spans,
+/// without copying or parsing them.
+///
+/// Pages are read in by the kernel as the TPs are touched; the access advice
+/// and prefetch() let it read ahead. The spans stay valid as long as the
+/// reader is open.
+class TPFileReader
+{
+public:
+  enum class Access
+  {
+    kNormal,
+    kSequential, // Read ahead aggressively, and drop pages once passed
+    kRandom,     // Do not read ahead
+    kPopulate    // Read the whole file in when it is opened
+  };
+
+  TPFileReader() = default;
+  explicit TPFileReader(const std::string& path, Access access = Access::kSequential) { open(path, access); }
+  ~TPFileReader() { close(); }
+
+  TPFileReader(const TPFileReader&) = delete;
+  TPFileReader& operator=(const TPFileReader&) = delete;
+
+  /// Throws TPFileError if the file cannot be mapped or is not a TP file with
+  /// this build's TP layout.
+  void open(const std::string& path, Access access = Access::kSequential);
+  void close();
+
+  bool is_open() const { return m_mapping != nullptr; }
+  std::size_t size() const { return m_n_tps; }
+
+  /// All of the TPs in the file.
+  Span<const TriggerPrimitive> tps() const { return Span<const TriggerPrimitive>(m_tps, m_n_tps); }
+
+  /// Up to `count` TPs from `first`, eg successive batches for a maker.
+  Span<const TriggerPrimitive> tps(std::size_t first, std::size_t count) const { return tps().subspan(first, count); }
+
+  /// Ask the kernel to start reading these TPs in, eg a few batches ahead.
+  void prefetch(std::size_t first, std::size_t count) const;
+
+private:
+  void* m_mapping = nullptr;
+  std::size_t m_mapping_size = 0;
+  const TriggerPrimitive* m_tps = nullptr;
+  std::size_t m_n_tps = 0;
+};
+
+/// @brief Writes binary TP files for TPFileReader.
+class TPFileWriter
+{
+public:
+  TPFileWriter() = default;
+  explicit TPFileWriter(const std::string& path) { open(path); }
+  /// Closes the file as close() does, but logs an error instead of throwing.
+  ~TPFileWriter();
+
+  TPFileWriter(const TPFileWriter&) = delete;
+  TPFileWriter& operator=(const TPFileWriter&) = delete;
+
+  /// Create or truncate the file and write the header. Throws TPFileError.
+  void open(const std::string& path);
+  void write(Span<const TriggerPrimitive> tps);
+  /// Throws TPFileError if what was written cannot be flushed out.
+  void close();
+  /// Close the file, if still open, and remove it, eg after an error part way
+  /// through, so that a partial file is not left behind. Does not throw.
+  void discard();
+
+private:
+  std::FILE* m_file = nullptr;
+  std::string m_path;
+};
+
+/// Convert a text dump, one TP per line as "time_start time_over_threshold
+/// time_peak channel adc_integral adc_peak detid type" as written by the
+/// makers' dump_tp(), into a binary TP file, keeping the TPs in file order.
+/// Returns the number of TPs; throws TPFileError, with the line, on a
+/// malformed one, and then leaves no binary file behind.
+std::size_t
+convert_tp_text_file(const std::string& text_path, const std::string& binary_path);
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_INCLUDE_TRIGGERALGS_TPFILE_HPP_
@@ -0,0 +1,182 @@
+/**
+ * @file TPGenerator.hpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#ifndef TRIGGERALGS_INCLUDE_TRIGGERALGS_TPGENERATOR_HPP_
+#define TRIGGERALGS_INCLUDE_TRIGGERALGS_TPGENERATOR_HPP_
+
+#include "triggeralgs/TriggerPrimitive.hpp"
+#include "triggeralgs/Types.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace triggeralgs {
+
+/// @brief Seeded generator of time-ordered synthetic TP streams for one
+/// detector element.
+///
+/// The stream overlays several kinds of activity, each arriving as a Poisson
+/// process in data time:
+///  - noise: lone TPs, at a given rate on every channel;
+///  - tracks: straight lines across many adjacent channels at one of the
+///    chosen angles, 0 degrees being a horizontal muon that crosses all of its
+///    channels at once;
+///  - Michel electrons: a track whose charge rises towards its end, followed
+///    after a muon lifetime by a short electron track at another angle;
+///  - supernova-like events: a few low-energy TPs on neighbouring channels,
+///    all the time or only in periodic bursts;
+///  - showers: hundreds of TPs, several per channel, over a few hundred
+///    channels in a short time.
+///
+/// The same seed and configuration always give the same stream: the
+/// generator has its own random number generator and distributions, rather
+/// than the standard library's, which differ between implementations. Noise is
+/// drawn directly in time order and activities are merged in through a small
+/// heap, so that generating a TP costs a few tens of ns.
+///
+/// Rates are in Hz of the data clock ("clock_frequency_hz", 62.5 MHz by
+/// default), and times in its ticks.
+class TPGenerator
+{
+public:
+  struct Counters
+  {
+    uint64_t n_tps = 0;              // NOLINT(build/unsigned)
+    uint64_t n_noise = 0;            // NOLINT(build/unsigned)
+    uint64_t n_tracks = 0;           // NOLINT(build/unsigned)
+    uint64_t n_michels = 0;          // NOLINT(build/unsigned)
+    uint64_t n_supernova_events = 0; // NOLINT(build/unsigned)
+    uint64_t n_showers = 0;          // NOLINT(build/unsigned)
+  };
+
+  TPGenerator() { restart(); }
+
+  /// Set the parameters present in `config` and start the stream again from
+  /// "start_time" with "seed". The parameters, with their defaults below, are:
+  ///  - "seed", "clock_frequency_hz", "start_time";
+  ///  - "detid", "first_channel", "n_channels": the channels of the element;
+  ///  - "noise_rate_hz": per channel;
+  ///  - "track_rate_hz", "track_angles_deg", "track_min_channels",
+  ///    "track_max_channels", and "ticks_per_channel", the time a 45 degree
+  ///    track takes to cross one channel;
+  ///  - "michel_rate_hz", "muon_lifetime_ticks";
+  ///  - "supernova_rate_hz", and "supernova_burst_interval" and
+  ///    "supernova_burst_length" to make events only in the first
+  ///    burst_length ticks of every burst_interval;
+  ///  - "shower_rate_hz", "shower_tps", "shower_channels", "shower_ticks".
+  void configure(const nlohmann::json& config);
+
+  /// Append the next n_tps TPs of the stream to `output`.
+  void generate(std::size_t n_tps, std::vector<TriggerPrimitive>& output);
+
+  /// Append the TPs of the stream that start before `until` to `output`.
+  void generate_until(timestamp_t until, std::vector<TriggerPrimitive>& output);
+
+  const Counters& counters() const { return m_counters; }
+
+private:
+  // xoshiro256**, seeded through splitmix64.
+  class Random
+  {
+  public:
+    void seed(uint64_t seed); // NOLINT(build/unsigned)
+    uint64_t next();          // NOLINT(build/unsigned)
+    // Uniform in [0, 1).
+    double uniform() { return (next() >> 11) * 0x1.0p-53; }
+    // Uniform in [0, n).
+    uint32_t below(uint32_t n) // NOLINT(build/unsigned)
+    {
+      return static_cast<uint32_t>(((next() >> 32) * n) >> 32); // NOLINT(build/unsigned)
+    }
+    // Exponential with the given mean.
+    double exponential(double mean);
+    // Roughly normal with mean 0 and standard deviation 1 (sum of uniforms).
+    double normal();
+
+  private:
+    uint64_t m_state[4]; // NOLINT(build/unsigned)
+  };
+
+  static constexpr double never = 1e300;
+
+  void restart();
+
+  // Queue every activity that starts no later than the next TP, and return the
+  // time of that TP, or `never` if the stream is empty.
+  double next_time();
+  // Take the next TP out of the stream, once next_time() has found one.
+  void take(TriggerPrimitive& tp);
+
+  // The time of the next arrival after `time` of a process with this rate.
+  double next_arrival(double time, double rate_hz);
+  double next_supernova_arrival(double time);
+
+  void make_noise(double time, TriggerPrimitive& tp);
+  void add_track(double time);
+  void add_michel(double time);
+  void add_supernova_event(double time);
+  void add_shower(double time);
+
+  // Queue the TPs of a straight line of n_channels channels from
+  // (channel, time), one channel further in `direction` and ticks_per_channel
+  // later each time, with charge scaled up by `bragg` towards the end.
+  // Returns the time of its last TP and sets `channel` to its last channel.
+  double add_line(channel_t& channel,
+                  int direction,
+                  double time,
+                  double ticks_per_channel,
+                  int n_channels,
+                  double bragg);
+  void queue_tp(channel_t channel, double time, double adc_peak, double time_over_threshold);
+  void fill_tp(TriggerPrimitive& tp, channel_t channel, double time, double adc_peak, double time_over_threshold) const;
+
+  bool in_range(channel_t channel) const
+  {
+    return channel >= m_first_channel && channel < m_first_channel + m_n_channels;
+  }
+  double track_ticks_per_channel();
+
+  Random m_random;
+  Counters m_counters;
+  std::vector<TriggerPrimitive> m_pending; // Activity TPs, a min-heap on time_start
+  double m_next_noise = never;
+  double m_next_track = never;
+  double m_next_michel = never;
+  double m_next_supernova = never;
+  double m_next_shower = never;
+
+  // Configurable parameters.
+  uint64_t m_seed = 1; // NOLINT(build/unsigned)
+  double m_clock_frequency_hz = 62.5e6;
+  timestamp_t m_start_time = 1'000'000'000;
+  detid_t m_detid = 0;
+  channel_t m_first_channel = 0;
+  channel_t m_n_channels = 2560;
+  double m_noise_rate_hz = 1000; // Per channel
+  double m_track_rate_hz = 10;
+  std::vector<double> m_track_angles_deg = { 0, 10, 30, 60 };
+  double m_ticks_per_channel = 195; // Drift time across one wire pitch, ie a 45 degree track
+  int m_track_min_channels = 50;
+  int m_track_max_channels = 300;
+  double m_michel_rate_hz = 1;
+  double m_muon_lifetime_ticks = 137; // 2.2 us
+  double m_supernova_rate_hz = 0;
+  timestamp_t m_supernova_burst_interval = 0; // 0: events all the time
+  timestamp_t m_supernova_burst_length = 0;
+  double m_shower_rate_hz = 0.5;
+  int m_shower_tps = 500;
+  int m_shower_channels = 200;
+  double m_shower_ticks = 2000;
+};
+
+} // namespace triggeralgs
+
+#endif // TRIGGERALGS_INCLUDE_TRIGGERALGS_TPGENERATOR_HPP_
@@ -8,37 +8,22 @@
 #ifndef TRIGGERALGS_TPWINDOW_HPP_
 #define TRIGGERALGS_TPWINDOW_HPP_
 
+#include "triggeralgs/SlidingWindow.hpp"
+#include "triggeralgs/SlidingWindowAggregators.hpp"
 #include "triggeralgs/TriggerPrimitive.hpp"
-#include "triggeralgs/Types.hpp"
 
-#include <ostream>
-#include <unordered_map>
-#include <vector>
+#include <cstdint>
 
 namespace triggeralgs {
 
-class TPWindow
-{
-public:
-  bool is_empty() const;
+/// @brief Time window of TPs, with their total ADC and per-channel hit counts.
+///
+/// Index 0 is always the oldest TP in the window. The TPs are not also kept
+/// in packed per-field columns: at the window lengths the makers use, the TPs
+/// of a window fit in cache, and a scan over one field of them was faster
+/// whole than through its column.
+using TPWindow = SlidingWindow<TriggerPrimitive, ADCSum<uint32_t>, DistinctChannels<TriggerPrimitive>>;
 
-  void add(TriggerPrimitive const& input_tp);
-
-  void clear();
-
-  uint16_t n_channels_hit();
-
-  void move(TriggerPrimitive const& input_tp, timestamp_t const& window_length);
-
-  void reset(TriggerPrimitive const& input_tp);
-
-  friend std::ostream& operator<<(std::ostream& os, const TPWindow& window);
-
-  timestamp_t time_start;
-  uint32_t adc_integral;
-  std::unordered_map<channel_t, uint16_t> channel_states;
-  std::vector<TriggerPrimitive> inputs;
-};
 } // namespace triggeralgs
 
 #endif // TRIGGERALGS_TPWINDOW_HPP_
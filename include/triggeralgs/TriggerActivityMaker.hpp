@@ -11,24 +11,46 @@
 
 #include "triggeralgs/Issues.hpp"
 #include "triggeralgs/Logging.hpp"
+#include "triggeralgs/Span.hpp"
 #include "triggeralgs/TriggerActivity.hpp"
 #include "triggeralgs/TriggerPrimitive.hpp"
 #include "triggeralgs/Types.hpp"
 
 #include <atomic>
 #include <chrono>
+#include <cstddef>
 #include <nlohmann/json.hpp>
 #include <vector>
 
 namespace triggeralgs {
 
+class MakerStats;
+
 class TriggerActivityMaker
 {
 public:
   virtual ~TriggerActivityMaker() = default;
   virtual void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta) = 0;
+
+  /// Batch entry point: process a contiguous, time-ordered run of TPs in a
+  /// single call. The default forwards each TP to the virtual single-TP
+  /// operator(); makers override it with a loop over their own (statically
+  /// bound, so inlinable) single-TP operator() or a native batch version.
+  virtual void operator()(Span<const TriggerPrimitive> input_tps, std::vector<TriggerActivity>& output_ta)
+  {
+    for (const TriggerPrimitive& input_tp : input_tps)
+      (*this)(input_tp, output_ta);
+  }
+
   virtual void flush(timestamp_t /* until */, std::vector<TriggerActivity>&) {}
   virtual void configure(const nlohmann::json&) {}
+
+  /// Number of inputs the maker currently holds, eg in its window. Only read
+  /// by the instrumentation.
+  virtual std::size_t window_occupancy() const { return 0; }
+
+  /// The maker's statistics, if it is instrumented (see InstrumentedMaker).
+  virtual MakerStats* stats() { return nullptr; }
 };
 
 } // namespace triggeralgs
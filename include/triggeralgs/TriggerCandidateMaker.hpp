@@ -11,24 +11,44 @@
 
 #include "triggeralgs/Issues.hpp"
 #include "triggeralgs/Logging.hpp"
+#include "triggeralgs/Span.hpp"
 #include "triggeralgs/TriggerActivity.hpp"
 #include "triggeralgs/TriggerCandidate.hpp"
 #include "triggeralgs/Types.hpp"
 
 #include <atomic>
 #include <chrono>
+#include <cstddef>
 #include <nlohmann/json.hpp>
 #include <vector>
 
 namespace triggeralgs {
 
+class MakerStats;
+
 class TriggerCandidateMaker
 {
 public:
   virtual ~TriggerCandidateMaker() = default;
   virtual void operator()(const TriggerActivity& input_ta, std::vector<TriggerCandidate>& output_tc) = 0;
+
+  /// Batch entry point: process a contiguous, time-ordered run of TAs in a
+  /// single call. The default forwards each TA to the single-TA operator().
+  virtual void operator()(Span<const TriggerActivity> input_tas, std::vector<TriggerCandidate>& output_tc)
+  {
+    for (const TriggerActivity& input_ta : input_tas)
+      (*this)(input_ta, output_tc);
+  }
+
   virtual void flush(timestamp_t /* until */, std::vector<TriggerCandidate>& /* output_tc */) {}
   virtual void configure(const nlohmann::json&) {}
+
+  /// Number of inputs the maker currently holds, eg in its window. Only read
+  /// by the instrumentation.
+  virtual std::size_t window_occupancy() const { return 0; }
+
+  /// The maker's statistics, if it is instrumented (see InstrumentedMaker).
+  virtual MakerStats* stats() { return nullptr; }
 };
 
 } // namespace triggeralgs
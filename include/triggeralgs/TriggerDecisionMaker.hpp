@@ -11,6 +11,7 @@
 
 #include "triggeralgs/Issues.hpp"
 #include "triggeralgs/Logging.hpp"
+#include "triggeralgs/Span.hpp"
 #include "triggeralgs/TriggerCandidate.hpp"
 #include "triggeralgs/TriggerDecision.hpp"
 
@@ -26,6 +27,15 @@ class TriggerDecisionMaker
 public:
   virtual ~TriggerDecisionMaker() = default;
   virtual void operator()(const TriggerCandidate& input_tc, std::vector<TriggerDecision>& output_tds) = 0;
+
+  /// Batch entry point: process a contiguous, time-ordered run of TCs in a
+  /// single call. The default forwards each TC to the single-TC operator().
+  virtual void operator()(Span<const TriggerCandidate> input_tcs, std::vector<TriggerDecision>& output_tds)
+  {
+    for (const TriggerCandidate& input_tc : input_tcs)
+      (*this)(input_tc, output_tds);
+  }
+
   virtual void flush(std::vector<TriggerDecision>&) {}
   virtual void configure(const nlohmann::json&) {}
 };
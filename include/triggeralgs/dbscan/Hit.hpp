@@ -2,6 +2,7 @@
 
 #include "triggeralgs/TriggerActivity.hpp"
 #include "triggeralgs/TriggerPrimitive.hpp"
+#include <cstdint>
 #include <vector>
 #include <cmath>
 #include <list>
@@ -44,29 +45,48 @@ class Hit;
 
 //======================================================================
 
-// An array of unique hits, sorted by time. The actual container
-// implementation is a std::vector, which seems to be faster than a
-// std::set (needs rechecking)
+// An array of unique hits, sorted by time. The first kInlineHits are
+// stored in the set itself, which is room for the neighbours of most
+// hits: they are read without following a pointer, and a hit reused
+// from the pool needs no allocation. Past that, the hits move to an
+// array on the heap, which clear() keeps
 class HitSet
 {
 public:
-    HitSet();
+    static constexpr uint32_t kInlineHits = 10;
+
+    HitSet() = default;
+    HitSet(const HitSet& other);
+    HitSet(HitSet&& other) noexcept;
+    HitSet& operator=(const HitSet& other);
+    HitSet& operator=(HitSet&& other) noexcept;
+    ~HitSet();
 
     // Insert a hit in the set, if not already present. Keeps the
     // array sorted by time
     void insert(Hit* h);
 
-    std::vector<Hit*>::iterator begin() { return hits.begin(); }
-    std::vector<Hit*>::iterator end() { return hits.end(); }
+    Hit** begin() { return m_hits; }
+    Hit** end() { return m_hits + m_size; }
+
+    Hit* const* begin() const { return m_hits; }
+    Hit* const* end() const { return m_hits + m_size; }
+
+    void clear() { m_size = 0; }
 
-    std::vector<Hit*>::const_iterator begin() const { return hits.cbegin(); }
-    std::vector<Hit*>::const_iterator end() const { return hits.cend(); }
+    size_t size() const { return m_size; }
 
-    void clear() { hits.clear(); }
+private:
+    // Make room for at least `capacity` hits
+    void reserve(uint32_t capacity);
 
-    size_t size() const { return hits.size(); }
+    // Give back the heap array, if any, and go back to the inline one
+    void release();
 
-    std::vector<Hit*> hits;
+    Hit** m_hits{ m_inline };
+    uint32_t m_size{ 0 };
+    uint32_t m_capacity{ kInlineHits };
+    Hit* m_inline[kInlineHits];
 };
 
 //======================================================================
@@ -84,6 +104,9 @@ struct Hit
     Connectedness connectedness;
     HitSet neighbours;
     triggeralgs::TriggerPrimitive primitive;
+    // Set by the HitPool the hit came from, to tell it from the hits
+    // that took its place before and after
+    uint64_t generation{ 0 };
 };
 
 //======================================================================
@@ -0,0 +1,96 @@
+#pragma once
+
+#include "triggeralgs/dbscan/Hit.hpp"
+#include "triggeralgs/TriggerPrimitive.hpp"
+
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace triggeralgs {
+namespace dbscan {
+//======================================================================
+//
+// The hits of an IncrementalDBSCAN, oldest first, stored in chunks of
+// a fixed number of hits. New hits go at the back, taking a new chunk
+// when the last one is full, and release() drops the oldest ones,
+// giving up each chunk once none of its hits is left. Hits never move,
+// so pointers to them stay good until they are released. One chunk
+// given up is kept to take the next new hits; the others are freed,
+// so that the memory held follows the number of hits kept
+//
+// Each hit is stamped with its generation, the count of hits allocated
+// before it. The hits of a generation before first_generation() are
+// released, and a pointer to one is stale, even if its chunk has not
+// been reused yet. Built with TRIGGERALGS_HITPOOL_CHECK_STALE, chunks
+// given up are set aside instead, neither reused nor freed, so that a
+// stale pointer still reaches the hit it was to, with its old
+// generation, and is_kept() can tell. The memory held then grows with
+// every hit allocated, so this is only for tests, and the macro must
+// be the same for everything built with this header
+class HitPool
+{
+public:
+    explicit HitPool(size_t chunk_size = 1024);
+
+    // Take a hit for a new point. Its time must be >= the time of all
+    // hits previously allocated, for count_before() to work
+    Hit& allocate(float time, int chan, const triggeralgs::TriggerPrimitive* prim = nullptr);
+
+    // Release the `n` oldest hits
+    void release(size_t n);
+
+    // The number of hits, from the oldest, with time < `time`
+    size_t count_before(float time) const;
+
+    // The `i`th hit kept, counting from the oldest
+    Hit& operator[](size_t i) { return at_generation(m_first_generation + i); }
+    const Hit& operator[](size_t i) const { return at_generation(m_first_generation + i); }
+
+    size_t size() const { return m_next_generation - m_first_generation; }
+    bool empty() const { return size() == 0; }
+
+    // The number of chunks allocated, including the spare one, but not
+    // those set aside with TRIGGERALGS_HITPOOL_CHECK_STALE
+    size_t n_chunks() const { return m_chunks.size() + (m_spare.empty() ? 0 : 1); }
+    size_t chunk_size() const { return m_chunk_size; }
+
+    uint64_t first_generation() const { return m_first_generation; }
+
+    // Whether `hit` has not been released. Only exact with
+    // TRIGGERALGS_HITPOOL_CHECK_STALE: without it, a stale pointer may
+    // reach a newer hit in a reused chunk, or a freed chunk
+    bool is_kept(const Hit& hit) const
+    {
+        return hit.generation >= m_first_generation && hit.generation < m_next_generation;
+    }
+
+private:
+    Hit& at_generation(uint64_t generation);
+    const Hit& at_generation(uint64_t generation) const;
+
+    size_t m_chunk_size;
+    // The chunks holding hits that are kept, oldest first. Each vector
+    // is reserved to m_chunk_size up front, so never reallocates
+    std::deque<std::vector<Hit>> m_chunks;
+    // A chunk given up by release(), with all of its hits, to reuse
+    std::vector<Hit> m_spare;
+#ifdef TRIGGERALGS_HITPOOL_CHECK_STALE
+    // Every chunk given up by release()
+    std::vector<std::vector<Hit>> m_set_aside;
+#endif
+    // The number of hits in use in the last chunk
+    size_t m_back_used{ 0 };
+    uint64_t m_front_generation{ 0 }; // Generation of the first hit of the first chunk
+    uint64_t m_first_generation{ 0 }; // Generation of the oldest hit kept
+    uint64_t m_next_generation{ 0 };
+};
+
+}
+}
+
+// Local Variables:
+// mode: c++
+// c-basic-offset: 4
+// c-file-style: "linux"
+// End:
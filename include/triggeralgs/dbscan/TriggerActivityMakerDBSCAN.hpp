@@ -21,10 +21,15 @@ class TriggerActivityMakerDBSCAN : public TriggerActivityMaker
 
 public:
   void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta);
+  void flush(timestamp_t until, std::vector<TriggerActivity>& output_ta);
+  std::size_t window_occupancy() const { return m_dbscan ? m_dbscan->n_hits() : 0; }
   
   void configure(const nlohmann::json &config);
   
 private:  
+  // Make a TA of each of the clusters in m_dbscan_clusters
+  void make_tas(std::vector<TriggerActivity>& output_ta) const;
+
   int m_eps{10};
   int m_min_pts{3}; // Minimum number of points to form a cluster
   timestamp_t m_first_timestamp{0};
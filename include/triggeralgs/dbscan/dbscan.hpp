@@ -1,14 +1,18 @@
 #pragma once
 
+#include <functional>
 #include <vector>
 #include <map>
 #include <iostream>
 #include <algorithm> // For std::lower_bound
+#include <queue>
 #include <set>
 #include <list>
 
 #include "triggeralgs/dbscan/Hit.hpp"
+#include "triggeralgs/dbscan/HitPool.hpp"
 #include "triggeralgs/TriggerPrimitive.hpp"
+#include "triggeralgs/Types.hpp"
 
 namespace triggeralgs {
 namespace dbscan {
@@ -18,6 +22,52 @@ namespace dbscan {
 int
 neighbours_sorted(const std::vector<Hit*>& hits, Hit& q, float eps, int minPts);
 
+//======================================================================
+//
+// The hits of an IncrementalDBSCAN bucketed by channel into columns at
+// least eps channels wide, each column in time order. A hit can only
+// neighbour hits in its own column and the two either side, so a search
+// walks back through those three instead of every hit within eps in
+// time, whatever its channel
+class HitIndex
+{
+public:
+    explicit HitIndex(float eps);
+
+    // Add a hit. Its time must be >= the time of all hits previously
+    // added
+    void add(Hit* hit);
+
+    // Find the eps-neighbours of hit q among the hits added, as
+    // neighbours_sorted() does over the same hits: they are tried in the
+    // same order, latest first, so that ties in time come out in the same
+    // order in the neighbour lists
+    int neighbours(Hit& q, int minPts);
+
+    // Forget the `n` hits added first that are not forgotten yet
+    void drop_oldest(size_t n) { m_first_kept += n; }
+
+private:
+    struct Entry
+    {
+        Hit* hit;
+        uint64_t index; // Count of hits added before this one
+    };
+
+    int column_index(int chan) const;
+
+    // The column of that index, added if `create`, else nullptr if there
+    // is none
+    std::vector<Entry>* column(int index, bool create);
+
+    float m_eps;
+    int m_width;
+    int m_first_column{ 0 };
+    std::vector<std::vector<Entry>> m_columns;
+    uint64_t m_n_added{ 0 };
+    uint64_t m_first_kept{ 0 };
+};
+
 //======================================================================
 struct Cluster
 {
@@ -54,52 +104,97 @@ struct Cluster
 //
 // Modified DBSCAN algorithm that takes one hit at a time, with the requirement
 // that the hits are passed in time order
+//
+// The hits are kept in a HitPool of chunks of `chunk_size` hits, which
+// grows with the number of hits kept and shrinks again as trim_hits()
+// drops them. Completed clusters point to hits in the pool, which stay
+// good until the next call to trim_hits()
+//
+// All of the state is in the instance, so separate instances can run on
+// separate threads, one per stream of hits, with no locking
 class IncrementalDBSCAN
 {
 public:
-    IncrementalDBSCAN(float eps, unsigned int minPts, size_t pool_size=100000)
+    IncrementalDBSCAN(float eps, unsigned int minPts, size_t chunk_size=1024)
         : m_eps(eps)
         , m_minPts(minPts)
-        , m_pool_begin(0)
-        , m_pool_end(0)
-    {
-        for(size_t i=0; i<pool_size; ++i){
-            m_hit_pool.emplace_back(0,0);
-        }
-    }
+        , m_pool(chunk_size)
+        , m_index(eps)
+    {}
 
     void add_primitive(const triggeralgs::TriggerPrimitive& prim, std::vector<Cluster>* completed_clusters=nullptr);
     
     void add_point(float time, float channel, std::vector<Cluster>* completed_clusters=nullptr);
-    
-    // Add a new hit. The hit time *must* be >= the time of all hits
-    // previously added
-    void add_hit(Hit* new_hit, std::vector<Cluster>* completed_clusters=nullptr);
 
+    // Declare complete, and pass out, the clusters that no primitive
+    // with time_start at or after `until` could still change. Used to
+    // send out clusters on a quiet input without waiting for the next
+    // primitive
+    void flush(triggeralgs::timestamp_t until, std::vector<Cluster>* completed_clusters=nullptr);
+
+    // Release the hits too old to be in or next to any cluster to come
     void trim_hits();
 
-    std::vector<Hit*> get_hits() const { return m_hits; }
+    std::vector<Hit*> get_hits();
 
     std::map<int, Cluster> get_clusters() const { return m_clusters; }
 
     uint64_t get_first_prim_time() const { return m_first_prim_time; }
-    
+    std::size_t n_hits() const { return m_pool.size(); }
+    const HitPool& get_pool() const { return m_pool; }
+
 private:
+    // Add a new hit from the pool. The hit time *must* be >= the time of
+    // all hits previously added
+    void add_hit(Hit* new_hit, std::vector<Cluster>* completed_clusters);
+
     //======================================================================
     //
     // Starting from `seed_hit`, find all the reachable hits and add them
     // to `cluster`
     void cluster_reachable(Hit* seed_hit, Cluster& cluster);
 
+    // Mark the clusters whose latest hit is before `time` as complete,
+    // and move all of the complete clusters to `completed_clusters`
+    void complete_clusters(float time, std::vector<Cluster>* completed_clusters);
+
+    // Put a new cluster in the queues below
+    void queue_cluster(const Cluster& cluster);
+
+    struct ClusterTime
+    {
+        float time;
+        int index;
+
+        bool operator>(const ClusterTime& other) const
+        {
+            return time > other.time || (time == other.time && index > other.index);
+        }
+    };
+    using ClusterQueue =
+        std::priority_queue<ClusterTime, std::vector<ClusterTime>, std::greater<ClusterTime>>;
+
     float m_eps;
     float m_minPts;
-    std::vector<Hit> m_hit_pool;
-    size_t m_pool_begin, m_pool_end;
-    std::vector<Hit*> m_hits; // All the hits we've seen so far, in time order
-    float m_latest_time{ 0 }; // The latest time of a hit in the vector of hits
+    HitPool m_pool; // All the hits we've kept so far, in time order
+    HitIndex m_index; // The same hits, by channel
+    float m_latest_time{ 0 }; // The latest time of a hit in the pool
     uint64_t m_first_prim_time{0};
     std::map<int, Cluster>
         m_clusters; // All of the currently-active (ie, kIncomplete) clusters
+    int m_next_cluster_index{ 0 }; // The index of the next cluster made
+    // The active clusters, earliest first, by their latest time as it
+    // was when queued, which can only be earlier than it is now, for
+    // complete_clusters() to only look at those that may be complete
+    ClusterQueue m_by_latest_time;
+    // The same by the time of their first hit, which can only come
+    // earlier, and is queued again when it does, for trim_hits()
+    ClusterQueue m_by_first_time;
+    // Scratch space for add_hit(), complete_clusters() and
+    // cluster_reachable(), kept to save allocating it for every hit
+    std::vector<int> m_neighbouring_clusters;
+    std::vector<int> m_completed_clusters;
+    std::vector<Hit*> m_seeds;
 };
 
 }
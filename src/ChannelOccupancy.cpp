@@ -0,0 +1,390 @@
+/**
+ * @file ChannelOccupancy.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "triggeralgs/ChannelOccupancy.hpp"
+
+#include <algorithm>
+
+namespace triggeralgs {
+
+void
+ChannelOccupancy::add(channel_t channel)
+{
+  cover_channel(channel);
+  std::size_t offset = channel - m_channel_base;
+  if (m_counts[offset]++ == 0) {
+    m_bitmap[offset / 64] |= uint64_t(1) << (offset % 64); // NOLINT(build/unsigned)
+    ++m_n_channels_hit;
+    note_changed(offset);
+  }
+}
+
+void
+ChannelOccupancy::remove(channel_t channel)
+{
+  std::size_t offset = channel - m_channel_base;
+  if (--m_counts[offset] == 0) {
+    m_bitmap[offset / 64] &= ~(uint64_t(1) << (offset % 64)); // NOLINT(build/unsigned)
+    --m_n_channels_hit;
+    note_changed(offset);
+  }
+}
+
+void
+ChannelOccupancy::clear()
+{
+  if (m_n_channels_hit == 0)
+    return;
+  std::fill(m_counts.begin(), m_counts.end(), 0);
+  std::fill(m_bitmap.begin(), m_bitmap.end(), 0);
+  m_n_channels_hit = 0;
+
+  if (m_segments_valid) {
+    m_changed.clear();
+    std::fill(m_segment_starts.begin(), m_segment_starts.end(), 0);
+    std::fill(m_run_counts.begin(), m_run_counts.end(), 0);
+    m_longest_run = 0;
+    m_longest_segment = npos;
+  }
+}
+
+uint16_t
+ChannelOccupancy::hit_count(channel_t channel) const
+{
+  if (channel < m_channel_base || channel - m_channel_base >= static_cast<channel_t>(m_counts.size()))
+    return 0;
+  return m_counts[channel - m_channel_base];
+}
+
+uint16_t
+ChannelOccupancy::longest_adjacent_run(channel_t max_step, uint16_t tolerance) const
+{
+  // The sort-and-scan version only commits a run when it meets a step it
+  // cannot take, which never happens with a single hit channel; except on
+  // channel 0, where its end-of-list check kicks in.
+  if (m_n_channels_hit < 2)
+    return m_n_channels_hit == 1 && hit_count(0) > 0 ? 1 : 0;
+
+  update_segments(max_step, tolerance);
+  return m_longest_run;
+}
+
+ChannelOccupancy::AdjacentRun
+ChannelOccupancy::longest_adjacent_span(channel_t max_step, uint16_t tolerance) const
+{
+  AdjacentRun run;
+  if (m_n_channels_hit < 2) {
+    if (m_n_channels_hit == 1 && hit_count(0) > 0)
+      run.length = 1;
+    return run;
+  }
+
+  update_segments(max_step, tolerance);
+  if (m_longest_segment == npos) {
+    // The segment starts are in order of channel: take the first with the
+    // longest run.
+    for (std::size_t word = 0; word < m_segment_starts.size() && m_longest_segment == npos; ++word) {
+      for (uint64_t bits = m_segment_starts[word]; bits != 0; bits &= bits - 1) { // NOLINT(build/unsigned)
+        std::size_t start = word * 64 + __builtin_ctzll(bits);
+        if (m_segment_run[start] == m_longest_run) {
+          m_longest_segment = start;
+          break;
+        }
+      }
+    }
+  }
+
+  run.first_channel = m_channel_base + static_cast<channel_t>(m_segment_run_span[m_longest_segment].first);
+  run.last_channel = m_channel_base + static_cast<channel_t>(m_segment_run_span[m_longest_segment].second);
+  run.length = m_longest_run;
+  return run;
+}
+
+std::size_t
+ChannelOccupancy::hit_count(channel_t first, channel_t last) const
+{
+  first = std::max(first, m_channel_base);
+  last = std::min(last, m_channel_base + static_cast<channel_t>(m_counts.size()) - 1);
+  std::size_t n_hits = 0;
+  for (channel_t channel = first; channel <= last; ++channel)
+    n_hits += m_counts[channel - m_channel_base];
+  return n_hits;
+}
+
+uint16_t
+ChannelOccupancy::scan_adjacent_run(channel_t max_step, uint16_t tolerance) const
+{
+  // The sort-and-scan version only commits a run when it meets a step it
+  // cannot take, which never happens with a single hit channel; except on
+  // channel 0, where its end-of-list check kicks in.
+  if (m_n_channels_hit < 2)
+    return m_n_channels_hit == 1 && hit_count(0) > 0 ? 1 : 0;
+
+  std::size_t max = 0;       // Longest run so far
+  std::size_t adj = 1;       // Length of the current run, 1 for the first channel
+  std::size_t tol_count = 0; // Summed size of the steps over gaps in the current run
+
+  // Take whole blocks of consecutive hit channels at once, and only look at the
+  // steps over gaps between them individually.
+  std::size_t end = m_counts.size();
+  std::size_t block_start = next_hit_channel(0);
+  while (true) {
+    std::size_t block_end = next_empty_channel(block_start);
+    adj += block_end - 1 - block_start;
+
+    std::size_t next = next_hit_channel(block_end);
+    if (next == end)
+      break;
+
+    std::size_t step = next - (block_end - 1);
+    if (step <= static_cast<std::size_t>(max_step) && tol_count < tolerance) {
+      ++adj;
+      tol_count += step;
+    } else {
+      max = std::max(max, adj);
+      adj = 1;
+      tol_count = 0;
+    }
+    block_start = next;
+  }
+
+  return std::max(max, adj);
+}
+
+void
+ChannelOccupancy::note_changed(std::size_t offset)
+{
+  if (!m_segments_valid)
+    return;
+  if (m_changed.size() == max_changed) {
+    // Cheaper to walk everything again than to take out and walk again the
+    // segments around every change.
+    m_segments_valid = false;
+    m_changed.clear();
+    return;
+  }
+  m_changed.push_back(offset);
+}
+
+void
+ChannelOccupancy::update_segments(channel_t max_step, uint16_t tolerance) const
+{
+  if (!m_segments_valid || max_step != m_segments_max_step || tolerance != m_segments_tolerance) {
+    rebuild_segments(max_step, tolerance);
+    return;
+  }
+  if (m_changed.empty())
+    return;
+  m_longest_segment = npos;
+
+  // Take out the segments that a changed channel was in, or could have joined,
+  // ie any within max_step of it, and note the stretch of channels they
+  // covered. Other segments are unchanged: they are still more than max_step
+  // away from any hit channel outside them.
+  std::sort(m_changed.begin(), m_changed.end());
+  m_changed.erase(std::unique(m_changed.begin(), m_changed.end()), m_changed.end());
+  m_stretches.clear();
+  const std::size_t reach = static_cast<std::size_t>(max_step);
+  for (std::size_t changed : m_changed) {
+    std::size_t first = changed;
+    std::size_t last = changed;
+    std::size_t low = changed > reach ? changed - reach : 0;
+    std::size_t start = previous_segment_start(std::min(changed + reach, m_counts.size() - 1));
+    while (start != npos && m_segment_end[start] >= low) {
+      first = std::min(first, start);
+      last = std::max(last, m_segment_end[start]);
+      remove_segment(start);
+      start = start == 0 ? npos : previous_segment_start(start - 1);
+    }
+    m_stretches.emplace_back(first, last);
+  }
+  m_changed.clear();
+
+  // Walk the segments in those stretches as they are now. A segment can run on
+  // from one stretch into the next, but not into a segment that was kept.
+  std::sort(m_stretches.begin(), m_stretches.end());
+  std::size_t walked = 0;
+  for (const auto& [first, last] : m_stretches)
+    walked = walk_segments(first, last, walked, max_step, tolerance);
+
+  while (m_longest_run > 0 && m_run_counts[m_longest_run] == 0)
+    --m_longest_run;
+}
+
+void
+ChannelOccupancy::rebuild_segments(channel_t max_step, uint16_t tolerance) const
+{
+  m_segments_valid = true;
+  m_segments_max_step = max_step;
+  m_segments_tolerance = tolerance;
+  m_changed.clear();
+  m_segment_starts.assign(m_bitmap.size(), 0);
+  m_segment_end.resize(m_counts.size());
+  m_segment_run.resize(m_counts.size());
+  m_segment_run_span.resize(m_counts.size());
+  m_run_counts.assign(m_run_counts.size(), 0);
+  m_longest_run = 0;
+  m_longest_segment = npos;
+  if (!m_counts.empty())
+    walk_segments(0, m_counts.size() - 1, 0, max_step, tolerance);
+}
+
+std::size_t
+ChannelOccupancy::walk_segments(std::size_t first,
+                                std::size_t last,
+                                std::size_t from,
+                                channel_t max_step,
+                                uint16_t tolerance) const
+{
+  std::size_t start = next_hit_channel(std::max(first, from));
+  while (start <= last && start < m_counts.size()) {
+    std::size_t longest_run = 0;
+    std::pair<std::size_t, std::size_t> longest_span;
+    std::size_t end = walk_segment(start, max_step, tolerance, longest_run, longest_span);
+    add_segment(start, end, longest_run, longest_span);
+    from = end + 1;
+    start = next_hit_channel(from);
+  }
+  return from;
+}
+
+std::size_t
+ChannelOccupancy::walk_segment(std::size_t start,
+                               channel_t max_step,
+                               uint16_t tolerance,
+                               std::size_t& longest_run,
+                               std::pair<std::size_t, std::size_t>& longest_span) const
+{
+  // As scan_adjacent_run(), stopping at the first step longer than max_step,
+  // and noting where the first longest run is.
+  std::size_t adj = 1;
+  std::size_t tol_count = 0;
+  std::size_t end = m_counts.size();
+  std::size_t block_start = start;
+  std::size_t run_start = start;
+  longest_run = 0;
+  while (true) {
+    std::size_t block_end = next_empty_channel(block_start);
+    adj += block_end - 1 - block_start;
+
+    std::size_t next = next_hit_channel(block_end);
+    std::size_t step = next - (block_end - 1);
+    bool segment_ends = next == end || step > static_cast<std::size_t>(max_step);
+    if (segment_ends || tol_count >= tolerance) {
+      if (adj > longest_run) {
+        longest_run = adj;
+        longest_span = { run_start, block_end - 1 };
+      }
+      if (segment_ends)
+        return block_end - 1;
+      adj = 1;
+      tol_count = 0;
+      run_start = next;
+    } else {
+      ++adj;
+      tol_count += step;
+    }
+    block_start = next;
+  }
+}
+
+void
+ChannelOccupancy::add_segment(std::size_t start,
+                              std::size_t end,
+                              std::size_t longest_run,
+                              const std::pair<std::size_t, std::size_t>& longest_span) const
+{
+  m_segment_starts[start / 64] |= uint64_t(1) << (start % 64); // NOLINT(build/unsigned)
+  m_segment_end[start] = end;
+  m_segment_run[start] = longest_run;
+  m_segment_run_span[start] = longest_span;
+  if (longest_run >= m_run_counts.size())
+    m_run_counts.resize(longest_run + 1, 0);
+  ++m_run_counts[longest_run];
+  m_longest_run = std::max(m_longest_run, longest_run);
+}
+
+void
+ChannelOccupancy::remove_segment(std::size_t start) const
+{
+  m_segment_starts[start / 64] &= ~(uint64_t(1) << (start % 64)); // NOLINT(build/unsigned)
+  --m_run_counts[m_segment_run[start]];
+}
+
+std::size_t
+ChannelOccupancy::previous_segment_start(std::size_t offset) const
+{
+  std::size_t word = offset / 64;
+  uint64_t bits = m_segment_starts[word] & (~uint64_t(0) >> (63 - offset % 64)); // NOLINT(build/unsigned)
+  while (bits == 0) {
+    if (word == 0)
+      return npos;
+    bits = m_segment_starts[--word];
+  }
+  return word * 64 + 63 - __builtin_clzll(bits);
+}
+
+void
+ChannelOccupancy::cover_channel(channel_t channel)
+{
+  // The base is kept a multiple of 64, so that channel offsets line up with
+  // the bitmap words.
+  channel_t word_start = channel - ((channel % 64) + 64) % 64;
+  if (m_counts.empty()) {
+    m_channel_base = word_start;
+  } else if (word_start < m_channel_base) {
+    std::size_t n_new_words = (m_channel_base - word_start) / 64;
+    m_counts.insert(m_counts.begin(), n_new_words * 64, 0);
+    m_bitmap.insert(m_bitmap.begin(), n_new_words, 0);
+    m_channel_base = word_start;
+    // The segments are by offset. Growing is rare, so just walk them again.
+    m_segments_valid = false;
+    return;
+  }
+
+  std::size_t n_words = (word_start - m_channel_base) / 64 + 1;
+  if (n_words > m_bitmap.size()) {
+    m_counts.resize(n_words * 64, 0);
+    m_bitmap.resize(n_words, 0);
+    m_segments_valid = false;
+  }
+}
+
+std::size_t
+ChannelOccupancy::next_hit_channel(std::size_t offset) const
+{
+  std::size_t word = offset / 64;
+  if (word >= m_bitmap.size())
+    return m_counts.size();
+
+  uint64_t bits = m_bitmap[word] & (~uint64_t(0) << (offset % 64)); // NOLINT(build/unsigned)
+  while (bits == 0) {
+    if (++word == m_bitmap.size())
+      return m_counts.size();
+    bits = m_bitmap[word];
+  }
+  return word * 64 + __builtin_ctzll(bits);
+}
+
+std::size_t
+ChannelOccupancy::next_empty_channel(std::size_t offset) const
+{
+  std::size_t word = offset / 64;
+  if (word >= m_bitmap.size())
+    return m_counts.size();
+
+  uint64_t bits = ~m_bitmap[word] & (~uint64_t(0) << (offset % 64)); // NOLINT(build/unsigned)
+  while (bits == 0) {
+    if (++word == m_bitmap.size())
+      return m_counts.size();
+    bits = ~m_bitmap[word];
+  }
+  return word * 64 + __builtin_ctzll(bits);
+}
+
+} // namespace triggeralgs
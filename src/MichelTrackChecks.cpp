@@ -0,0 +1,155 @@
+/**
+ * @file MichelTrackChecks.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "triggeralgs/MichelElectron/MichelTrackChecks.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+
+namespace triggeralgs {
+
+bool
+MichelTrackChecks::has_bragg_peak(const std::vector<TriggerPrimitive>& track)
+{
+  const std::size_t n = track.size();
+  if (n == 0)
+    return false;
+
+  // The running mean of the ADC integrals over 6 TPs, which is less
+  // susceptible to spikes of activity than the integrals themselves, wrapping
+  // around at the end: repeating the first 5 after the last makes every window contiguous.
+  // The 6 terms are added in the same order as before, so that the means are
+  // the same floats; a prefix sum would round differently.
+  // The integrals go through int64_t, which converts to the same float with
+  // a single instruction where uint32_t does not.
+  m_adc.resize(n + 5);
+  for (std::size_t i = 0; i < n; ++i)
+    m_adc[i] = static_cast<int64_t>(track[i].adc_integral);
+  for (std::size_t i = n; i < n + 5; ++i)
+    m_adc[i] = m_adc[i - n];
+
+  m_means.resize(n);
+  const float* adc = m_adc.data();
+  float* means = m_means.data();
+  for (std::size_t i = 0; i < n; ++i)
+    means[i] = (adc[i] + adc[i + 1] + adc[i + 2] + adc[i + 3] + adc[i + 4] + adc[i + 5]) / 6;
+
+  // The baseline is the mean of the running means, summed in order in double.
+  double total = 0.0;
+  for (std::size_t i = 0; i < n; ++i)
+    total += means[i];
+  const float ped = total / n;
+
+  // Pick up clusters of charge above the baseline. Only the first, the last
+  // and the largest matter; a cluster still open at the end is not counted.
+  float charge = 0;
+  bool any_cluster = false;
+  float first_cluster = 0;
+  float last_cluster = 0;
+  float max_cluster = 0;
+  for (std::size_t i = 0; i < n; ++i) {
+    if (means[i] > ped) {
+      charge += means[i];
+    } else if (means[i] < ped && charge != 0) {
+      if (!any_cluster) {
+        first_cluster = charge;
+        max_cluster = charge;
+        any_cluster = true;
+      }
+      last_cluster = charge;
+      max_cluster = std::max(max_cluster, charge);
+      charge = 0;
+    }
+  }
+
+  // The Bragg peak is at the start or the end of the track.
+  return any_cluster && (max_cluster == first_cluster || max_cluster == last_cluster);
+}
+
+template<class Offset>
+void
+MichelTrackChecks::compute_gradients(const std::vector<Offset>& times)
+{
+  // The gradient between each TP and the one two further along, which evens
+  // out small scale fluctuations, in mm of collection wire over mm of drift.
+  // It is kept for TPs on different channels and at different times that are
+  // close in both: within 6 channels and 1000 ticks, the time difference being
+  // taken as an int as before. Every gradient is computed and the kept ones
+  // picked out afterwards, so that the loop has no branches.
+  const int32_t* channels = m_channels.data();
+  const Offset* offsets = times.data();
+  float* gradients = m_gradients.data();
+  int32_t* kept = m_gradient_kept.data();
+  const std::size_t n = m_channels.size() - 2;
+  for (std::size_t i = 0; i < n; ++i) {
+    const int32_t dc = channels[i + 2] - channels[i];
+    const Offset dt = offsets[i + 2] - offsets[i];
+    const int diff = static_cast<int>(dt);
+    kept[i] = (dc != 0) & (dt != 0) & (std::abs(diff) <= 1000) & (std::abs(dc) <= 6);
+    const float dz = dc * 4.67; // Collection wire pitch
+    const float dx = dt * 0.028; // Drift distance per tick
+    gradients[i] = dz / dx;
+  }
+}
+
+bool
+MichelTrackChecks::has_kinks(const std::vector<TriggerPrimitive>& track)
+{
+  const std::size_t n = track.size();
+  if (n < 3)
+    return false;
+
+  // Times go in as offsets from the first TP, in 32 bits if they are all
+  // within 2^30 ticks of it, as in any window, so that differences fit too.
+  const timestamp_t first_time = track[0].time_start;
+  const int64_t limit = int64_t(1) << 30;
+  bool short_times = true;
+  m_channels.resize(n);
+  m_times.resize(n);
+  m_long_times.resize(n);
+  for (std::size_t i = 0; i < n; ++i) {
+    const int64_t offset = track[i].time_start - first_time;
+    m_channels[i] = track[i].channel;
+    m_times[i] = static_cast<int32_t>(offset);
+    m_long_times[i] = offset;
+    short_times &= (offset > -limit) & (offset < limit);
+  }
+  m_gradients.resize(n - 2);
+  m_gradient_kept.resize(n - 2);
+  if (short_times)
+    compute_gradients(m_times);
+  else
+    compute_gradients(m_long_times);
+
+  std::size_t n_gradients = 0;
+  for (std::size_t i = 0; i < n - 2; ++i) {
+    if (m_gradient_kept[i])
+      m_gradients[n_gradients++] = m_gradients[i];
+  }
+
+  // Require a decent number of gradients, as some confidence that the activity
+  // is track-like rather than shower-like: more than 10 running means of two
+  // gradients each, which smooth out deltas.
+  if (n_gradients <= 11)
+    return false;
+  const float* gradients = m_gradients.data();
+  double total = 0.0;
+  for (std::size_t i = 0; i + 1 < n_gradients; ++i)
+    total += (gradients[i] + gradients[i + 1]) / 2;
+  const float mean = std::abs(total) / (n_gradients - 1);
+  const float front = (gradients[0] + gradients[1]) / 2;
+  const float back = (gradients[n_gradients - 2] + gradients[n_gradients - 1]) / 2;
+
+  // Either end differs significantly from the mean: the coldbox had both the
+  // Michel kink and the wes kink, but simulation only shows one of them.
+  return (std::abs(front) + mean > 2.5 * mean) || (std::abs(back + mean) > 2.5 * mean);
+}
+
+} // namespace triggeralgs
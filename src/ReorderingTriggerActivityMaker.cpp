@@ -0,0 +1,70 @@
+/**
+ * @file ReorderingTriggerActivityMaker.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "triggeralgs/ReorderingTriggerActivityMaker.hpp"
+
+#include "TRACE/trace.h"
+#define TRACE_NAME "ReorderingTriggerActivityMaker"
+
+#include <utility>
+#include <vector>
+
+using namespace triggeralgs;
+
+using Logging::TLVL_DEBUG_MEDIUM;
+using Logging::TLVL_IMPORTANT;
+
+ReorderingTriggerActivityMaker::ReorderingTriggerActivityMaker(std::unique_ptr<TriggerActivityMaker> maker)
+  : m_maker(std::move(maker))
+  , m_buffer(m_max_lateness, m_max_buffered_tps)
+{
+}
+
+void
+ReorderingTriggerActivityMaker::operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta)
+{
+  TriggerActivityMaker& maker = *m_maker;
+  bool accepted = m_buffer.push(input_tp, [&](const TriggerPrimitive& tp) { maker(tp, output_ta); });
+  if (!accepted) {
+    TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:Reorder] Dropping TP at " << input_tp.time_start << " on channel "
+                                  << input_tp.channel << ", later than the maximum lateness of " << m_max_lateness
+                                  << " ticks.";
+  }
+}
+
+void
+ReorderingTriggerActivityMaker::operator()(Span<const TriggerPrimitive> input_tps,
+                                           std::vector<TriggerActivity>& output_ta)
+{
+  for (const TriggerPrimitive& input_tp : input_tps)
+    ReorderingTriggerActivityMaker::operator()(input_tp, output_ta);
+}
+
+void
+ReorderingTriggerActivityMaker::flush(timestamp_t until, std::vector<TriggerActivity>& output_ta)
+{
+  TriggerActivityMaker& maker = *m_maker;
+  m_buffer.release_until(until, [&](const TriggerPrimitive& tp) { maker(tp, output_ta); });
+  maker.flush(until, output_ta);
+}
+
+void
+ReorderingTriggerActivityMaker::configure(const nlohmann::json& config)
+{
+  if (config.is_object()) {
+    if (config.contains("max_lateness"))
+      m_max_lateness = config["max_lateness"];
+    if (config.contains("max_buffered_tps"))
+      m_max_buffered_tps = config["max_buffered_tps"];
+  }
+  m_buffer.configure(m_max_lateness, m_max_buffered_tps);
+  TLOG_DEBUG(TLVL_IMPORTANT) << "[TAM:Reorder] Holding up to " << m_max_buffered_tps << " TPs for up to "
+                             << m_max_lateness << " ticks to put them in time order.";
+
+  m_maker->configure(config);
+}
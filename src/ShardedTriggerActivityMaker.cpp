@@ -0,0 +1,256 @@
+/**
+ * @file ShardedTriggerActivityMaker.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "triggeralgs/ShardedTriggerActivityMaker.hpp"
+#include "triggeralgs/TriggerActivityFactory.hpp"
+
+#include "TRACE/trace.h"
+#define TRACE_NAME "ShardedTriggerActivityMaker"
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+using namespace triggeralgs;
+
+using Logging::TLVL_IMPORTANT;
+using Logging::TLVL_VERY_IMPORTANT;
+
+namespace {
+
+// Collect the TAs every this many TPs, rather than poll every shard on every TP.
+const uint32_t collect_interval = 256; // NOLINT(build/unsigned)
+
+// Spin briefly, then give the core away, then sleep, while a queue is empty or
+// full, so that idle shards do not starve busy ones of cores.
+void
+back_off(unsigned& spins)
+{
+  ++spins;
+  if (spins < 64)
+    return;
+  if (spins < 128)
+    std::this_thread::yield();
+  else
+    std::this_thread::sleep_for(std::chrono::microseconds(20));
+}
+
+} // namespace
+
+ShardedTriggerActivityMaker::~ShardedTriggerActivityMaker()
+{
+  stop();
+}
+
+std::size_t
+ShardedTriggerActivityMaker::shard_of(const TriggerPrimitive& input_tp) const
+{
+  if (m_shards.empty()) {
+    TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TAM:Sharded] No shards: not configured, or the configuration was rejected.";
+    throw BadConfiguration(ERS_HERE, TRACE_NAME);
+  }
+  if (m_shard_by_channel)
+    return static_cast<std::size_t>(input_tp.channel / m_channel_range) % m_shards.size();
+  return input_tp.detid % m_shards.size();
+}
+
+void
+ShardedTriggerActivityMaker::operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta)
+{
+  Message message;
+  message.tp = input_tp;
+  send(*m_shards[shard_of(input_tp)], message, output_ta);
+
+  if (++m_since_collect >= collect_interval)
+    collect(output_ta);
+}
+
+void
+ShardedTriggerActivityMaker::operator()(Span<const TriggerPrimitive> input_tps,
+                                        std::vector<TriggerActivity>& output_ta)
+{
+  for (const TriggerPrimitive& input_tp : input_tps)
+    ShardedTriggerActivityMaker::operator()(input_tp, output_ta);
+}
+
+void
+ShardedTriggerActivityMaker::flush(timestamp_t until, std::vector<TriggerActivity>& output_ta)
+{
+  Message message;
+  message.kind = Message::Kind::kFlush;
+  message.until = until;
+  synchronise(message, output_ta);
+}
+
+void
+ShardedTriggerActivityMaker::drain(std::vector<TriggerActivity>& output_ta)
+{
+  Message message;
+  message.kind = Message::Kind::kSync;
+  synchronise(message, output_ta);
+}
+
+void
+ShardedTriggerActivityMaker::configure(const nlohmann::json& config)
+{
+  stop();
+
+  if (config.is_object()) {
+    if (config.contains("algorithm"))
+      m_algorithm = config["algorithm"].get<std::string>();
+    if (config.contains("n_shards"))
+      m_n_shards = config["n_shards"];
+    if (config.contains("shard_by"))
+      m_shard_by_channel = config["shard_by"].get<std::string>() == "channel";
+    if (config.contains("channel_range"))
+      m_channel_range = config["channel_range"];
+    if (config.contains("queue_size"))
+      m_queue_size = config["queue_size"];
+    if (config.contains("pin_threads"))
+      m_pin_threads = config["pin_threads"];
+    if (config.contains("first_cpu"))
+      m_first_cpu = config["first_cpu"];
+  }
+  if (m_algorithm.empty() || m_n_shards == 0 || m_channel_range <= 0) {
+    TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TAM:Sharded] Need an algorithm, and at least one shard and channel per shard.";
+    throw BadConfiguration(ERS_HERE, TRACE_NAME);
+  }
+
+  const unsigned n_cpus = std::max(1u, std::thread::hardware_concurrency());
+  for (uint16_t i = 0; i < m_n_shards; ++i) { // NOLINT(build/unsigned)
+    std::unique_ptr<TriggerActivityMaker> maker = TriggerActivityFactory::get_instance()->build_maker(m_algorithm);
+    maker->configure(config);
+    auto shard = std::make_unique<Shard>(std::move(maker), m_queue_size);
+    shard->thread = std::thread(run_shard, std::ref(*shard));
+
+#ifdef __linux__
+    if (m_pin_threads) {
+      cpu_set_t cpus;
+      CPU_ZERO(&cpus);
+      CPU_SET((m_first_cpu + i) % n_cpus, &cpus);
+      if (pthread_setaffinity_np(shard->thread.native_handle(), sizeof(cpu_set_t), &cpus) != 0)
+        TLOG_DEBUG(TLVL_IMPORTANT) << "[TAM:Sharded] Could not pin shard " << i << " to CPU "
+                                   << (m_first_cpu + i) % n_cpus << ".";
+    }
+#endif
+
+    m_shards.push_back(std::move(shard));
+  }
+
+  TLOG_DEBUG(TLVL_IMPORTANT) << "[TAM:Sharded] Running " << m_n_shards << " " << m_algorithm << " instances, sharded by "
+                             << (m_shard_by_channel ? "channel" : "detid") << ".";
+}
+
+void
+ShardedTriggerActivityMaker::run_shard(Shard& shard)
+{
+  std::vector<TriggerActivity> output_ta;
+  Message message;
+  unsigned spins = 0;
+
+  while (true) {
+    if (!shard.input.try_pop(message)) {
+      back_off(spins);
+      continue;
+    }
+    spins = 0;
+
+    switch (message.kind) {
+      case Message::Kind::kTP:
+        (*shard.maker)(message.tp, output_ta);
+        break;
+      case Message::Kind::kFlush:
+        shard.maker->flush(message.until, output_ta);
+        break;
+      case Message::Kind::kSync:
+        break;
+      case Message::Kind::kStop:
+        return;
+    }
+
+    for (TriggerActivity& ta : output_ta) {
+      unsigned push_spins = 0;
+      while (!shard.output.try_push(std::move(ta)))
+        back_off(push_spins);
+    }
+    output_ta.clear();
+
+    if (message.kind != Message::Kind::kTP)
+      shard.synced.store(message.sync_number, std::memory_order_release);
+  }
+}
+
+void
+ShardedTriggerActivityMaker::send(Shard& shard, const Message& message, std::vector<TriggerActivity>& output_ta)
+{
+  // While the shard is behind, take its TAs (and the others') so it cannot
+  // stall on a full output queue.
+  unsigned spins = 0;
+  while (!shard.input.try_push(message)) {
+    collect(output_ta);
+    back_off(spins);
+  }
+}
+
+void
+ShardedTriggerActivityMaker::collect(std::vector<TriggerActivity>& output_ta)
+{
+  m_since_collect = 0;
+  TriggerActivity ta;
+  for (auto& shard : m_shards)
+    while (shard->output.try_pop(ta))
+      output_ta.push_back(std::move(ta));
+}
+
+void
+ShardedTriggerActivityMaker::synchronise(Message message, std::vector<TriggerActivity>& output_ta)
+{
+  message.sync_number = ++m_sync_number;
+  for (auto& shard : m_shards)
+    send(*shard, message, output_ta);
+
+  for (auto& shard : m_shards) {
+    unsigned spins = 0;
+    while (shard->synced.load(std::memory_order_acquire) != m_sync_number) {
+      collect(output_ta);
+      back_off(spins);
+    }
+  }
+  // The TAs a shard made before signalling are already in its queue.
+  collect(output_ta);
+}
+
+void
+ShardedTriggerActivityMaker::stop()
+{
+  Message message;
+  message.kind = Message::Kind::kStop;
+  std::vector<TriggerActivity> discarded;
+  for (auto& shard : m_shards) {
+    send(*shard, message, discarded);
+    // Keep its output queue moving until the shard has seen the stop.
+    while (shard->thread.joinable() && !shard->input.is_empty()) {
+      collect(discarded);
+      std::this_thread::yield();
+    }
+  }
+  for (auto& shard : m_shards) {
+    if (shard->thread.joinable())
+      shard->thread.join();
+  }
+  m_shards.clear();
+}
@@ -0,0 +1,303 @@
+/**
+ * @file TPFile.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "triggeralgs/TPFile.hpp"
+#include "triggeralgs/Issues.hpp"
+#include "triggeralgs/Logging.hpp"
+
+#include "TRACE/trace.h"
+#define TRACE_NAME "TPFile"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <charconv>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace triggeralgs;
+
+using Logging::TLVL_DEBUG_INFO;
+using Logging::TLVL_VERY_IMPORTANT;
+
+namespace {
+
+std::string
+system_error(const std::string& what)
+{
+  return what + ": " + std::strerror(errno);
+}
+
+// A read-only mapping of a whole file.
+class Mapping
+{
+public:
+  Mapping(const std::string& path, int flags)
+  {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+      throw TPFileError(ERS_HERE, path, system_error("cannot open"));
+    struct stat status;
+    if (::fstat(fd, &status) != 0) {
+      std::string reason = system_error("cannot stat");
+      ::close(fd);
+      throw TPFileError(ERS_HERE, path, reason);
+    }
+    m_size = static_cast<std::size_t>(status.st_size);
+    if (m_size > 0) {
+      m_data = ::mmap(nullptr, m_size, PROT_READ, MAP_PRIVATE | flags, fd, 0);
+      if (m_data == MAP_FAILED) {
+        m_data = nullptr;
+        std::string reason = system_error("cannot map");
+        ::close(fd);
+        throw TPFileError(ERS_HERE, path, reason);
+      }
+    }
+    // The mapping keeps the file open.
+    ::close(fd);
+  }
+
+  void* release()
+  {
+    void* data = m_data;
+    m_data = nullptr;
+    return data;
+  }
+
+  ~Mapping()
+  {
+    if (m_data)
+      ::munmap(m_data, m_size);
+  }
+
+  void* data() const { return m_data; }
+  std::size_t size() const { return m_size; }
+
+private:
+  void* m_data = nullptr;
+  std::size_t m_size = 0;
+};
+
+bool
+is_blank(char c)
+{
+  return c == ' ' || c == '\t' || c == '\r';
+}
+
+// Parse one whitespace-separated field into `value`, returning the end of the
+// field or nullptr if there is no number of the right type there.
+template<typename T>
+const char*
+parse_field(const char* p, const char* end, T& value)
+{
+  while (p != end && is_blank(*p))
+    ++p;
+  std::from_chars_result result = std::from_chars(p, end, value);
+  if (result.ec != std::errc() || (result.ptr != end && !is_blank(*result.ptr) && *result.ptr != '\n'))
+    return nullptr;
+  return result.ptr;
+}
+
+// Parse the TP on the line at `p`, returning the start of the next line, or
+// nullptr if the line is malformed.
+const char*
+parse_tp(const char* p, const char* end, TriggerPrimitive& tp)
+{
+  int type = 0;
+  (p = parse_field(p, end, tp.time_start)) && (p = parse_field(p, end, tp.time_over_threshold)) &&
+    (p = parse_field(p, end, tp.time_peak)) && (p = parse_field(p, end, tp.channel)) &&
+    (p = parse_field(p, end, tp.adc_integral)) && (p = parse_field(p, end, tp.adc_peak)) &&
+    (p = parse_field(p, end, tp.detid)) && (p = parse_field(p, end, type));
+  if (!p)
+    return nullptr;
+  tp.type = static_cast<TriggerPrimitive::Type>(type);
+
+  while (p != end && is_blank(*p))
+    ++p;
+  if (p == end)
+    return p;
+  return *p == '\n' ? p + 1 : nullptr;
+}
+
+} // namespace
+
+void
+TPFileReader::open(const std::string& path, Access access)
+{
+  close();
+
+  Mapping mapping(path, access == Access::kPopulate ? MAP_POPULATE : 0);
+  TPFileHeader header;
+  if (mapping.size() < sizeof(header))
+    throw TPFileError(ERS_HERE, path, "too short for a header");
+  std::memcpy(&header, mapping.data(), sizeof(header));
+  if (std::memcmp(header.magic, TPFileHeader::expected_magic, sizeof(header.magic)) != 0)
+    throw TPFileError(ERS_HERE, path, "not a binary TP file");
+  if (header.byte_order != TPFileHeader().byte_order)
+    throw TPFileError(ERS_HERE, path, "written with the other byte order");
+  if (header.format_version != TPFileHeader::current_format_version || header.record_size != sizeof(TriggerPrimitive) ||
+      header.tp_version != TPFileHeader().tp_version)
+    throw TPFileError(ERS_HERE,
+                      path,
+                      "format version " + std::to_string(header.format_version) + ", TP version " +
+                        std::to_string(header.tp_version) + " of " + std::to_string(header.record_size) +
+                        " bytes does not match this build");
+  if ((mapping.size() - sizeof(header)) % sizeof(TriggerPrimitive) != 0)
+    throw TPFileError(ERS_HERE, path, "truncated in the middle of a TP");
+
+  if (access == Access::kSequential)
+    ::madvise(mapping.data(), mapping.size(), MADV_SEQUENTIAL);
+  else if (access == Access::kRandom)
+    ::madvise(mapping.data(), mapping.size(), MADV_RANDOM);
+
+  m_mapping_size = mapping.size();
+  m_mapping = mapping.release();
+  m_tps = reinterpret_cast<const TriggerPrimitive*>(static_cast<const char*>(m_mapping) + sizeof(header));
+  m_n_tps = (m_mapping_size - sizeof(header)) / sizeof(TriggerPrimitive);
+
+  TLOG_DEBUG(TLVL_DEBUG_INFO) << "[TPFile] Mapped " << m_n_tps << " TPs from " << path;
+}
+
+void
+TPFileReader::close()
+{
+  if (m_mapping)
+    ::munmap(m_mapping, m_mapping_size);
+  m_mapping = nullptr;
+  m_mapping_size = 0;
+  m_tps = nullptr;
+  m_n_tps = 0;
+}
+
+void
+TPFileReader::prefetch(std::size_t first, std::size_t count) const
+{
+  Span<const TriggerPrimitive> range = tps(first, count);
+  if (range.empty())
+    return;
+
+  // madvise() takes whole pages.
+  const std::size_t page_size = static_cast<std::size_t>(::sysconf(_SC_PAGESIZE));
+  const char* base = static_cast<const char*>(m_mapping);
+  std::size_t begin = reinterpret_cast<const char*>(range.data()) - base;
+  std::size_t end = begin + range.size() * sizeof(TriggerPrimitive);
+  begin -= begin % page_size;
+  ::madvise(const_cast<char*>(base) + begin, end - begin, MADV_WILLNEED);
+}
+
+TPFileWriter::~TPFileWriter()
+{
+  if (m_file && std::fclose(m_file) != 0)
+    TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TPFile] " << m_path << ": " << system_error("cannot write");
+}
+
+void
+TPFileWriter::open(const std::string& path)
+{
+  close();
+
+  m_file = std::fopen(path.c_str(), "wb");
+  if (!m_file)
+    throw TPFileError(ERS_HERE, path, system_error("cannot create"));
+  m_path = path;
+
+  TPFileHeader header;
+  if (std::fwrite(&header, sizeof(header), 1, m_file) != 1)
+    throw TPFileError(ERS_HERE, m_path, system_error("cannot write"));
+}
+
+void
+TPFileWriter::write(Span<const TriggerPrimitive> tps)
+{
+  if (!m_file)
+    throw TPFileError(ERS_HERE, m_path, "not open for writing");
+  if (std::fwrite(tps.data(), sizeof(TriggerPrimitive), tps.size(), m_file) != tps.size())
+    throw TPFileError(ERS_HERE, m_path, system_error("cannot write"));
+}
+
+void
+TPFileWriter::close()
+{
+  if (!m_file)
+    return;
+  int result = std::fclose(m_file);
+  m_file = nullptr;
+  if (result != 0)
+    throw TPFileError(ERS_HERE, m_path, system_error("cannot write"));
+}
+
+void
+TPFileWriter::discard()
+{
+  if (m_file)
+    std::fclose(m_file);
+  m_file = nullptr;
+  if (!m_path.empty())
+    std::remove(m_path.c_str());
+}
+
+std::size_t
+triggeralgs::convert_tp_text_file(const std::string& text_path, const std::string& binary_path)
+{
+  Mapping text(text_path, 0);
+  if (text.size() > 0)
+    ::madvise(text.data(), text.size(), MADV_SEQUENTIAL);
+
+  TPFileWriter writer(binary_path);
+  std::vector<TriggerPrimitive> batch;
+  batch.reserve(1 << 16);
+  std::size_t n_tps = 0;
+  std::size_t line = 0;
+
+  // A partial file would replay as a valid, shorter one.
+  try {
+    const char* p = static_cast<const char*>(text.data());
+    const char* end = p + text.size();
+    while (p != end) {
+      ++line;
+      const char* line_start = p;
+      while (p != end && is_blank(*p))
+        ++p;
+      if (p == end)
+        break;
+      if (*p == '\n') {
+        ++p;
+        continue;
+      }
+
+      TriggerPrimitive& tp = batch.emplace_back();
+      p = parse_tp(p, end, tp);
+      if (!p) {
+        const char* line_end = static_cast<const char*>(std::memchr(line_start, '\n', end - line_start));
+        std::string bad_line(line_start, line_end ? line_end : end);
+        throw TPFileError(ERS_HERE,
+                          text_path,
+                          "line " + std::to_string(line) + " is not a TP: \"" + bad_line.substr(0, 100) + "\"");
+      }
+
+      if (batch.size() == batch.capacity()) {
+        writer.write(Span<const TriggerPrimitive>(batch.data(), batch.size()));
+        n_tps += batch.size();
+        batch.clear();
+      }
+    }
+    writer.write(Span<const TriggerPrimitive>(batch.data(), batch.size()));
+    n_tps += batch.size();
+    writer.close();
+  } catch (...) {
+    writer.discard();
+    throw;
+  }
+
+  TLOG_DEBUG(TLVL_DEBUG_INFO) << "[TPFile] Converted " << n_tps << " TPs from " << text_path;
+  return n_tps;
+}
@@ -0,0 +1,423 @@
+/**
+ * @file TPGenerator.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "triggeralgs/TPGenerator.hpp"
+#include "triggeralgs/Issues.hpp"
+#include "triggeralgs/Logging.hpp"
+
+#include "TRACE/trace.h"
+#define TRACE_NAME "TPGenerator"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+using namespace triggeralgs;
+
+using Logging::TLVL_IMPORTANT;
+using Logging::TLVL_VERY_IMPORTANT;
+
+namespace {
+
+constexpr double radians_per_degree = 3.14159265358979323846 / 180;
+
+// The layers of the ziggurat for the standard exponential distribution
+// (Marsaglia and Tsang, 2000).
+struct ExponentialZiggurat
+{
+  static constexpr double r = 7.69711747013104972; // Start of the tail
+  static constexpr double v = 3.949659822581572e-3; // Area of each layer
+
+  ExponentialZiggurat()
+  {
+    const double scale = 4294967296.0;
+    double x = r;
+    double previous_x = x;
+    const double q = v / std::exp(-x);
+    k[0] = static_cast<uint32_t>((x / q) * scale); // NOLINT(build/unsigned)
+    k[1] = 0;
+    w[0] = q / scale;
+    w[255] = x / scale;
+    f[0] = 1;
+    f[255] = std::exp(-x);
+    for (int i = 254; i >= 1; --i) {
+      x = -std::log(v / x + std::exp(-x));
+      k[i + 1] = static_cast<uint32_t>((x / previous_x) * scale); // NOLINT(build/unsigned)
+      previous_x = x;
+      f[i] = std::exp(-x);
+      w[i] = x / scale;
+    }
+  }
+
+  uint32_t k[256]; // NOLINT(build/unsigned)
+  double w[256];
+  double f[256];
+};
+
+const ExponentialZiggurat&
+ziggurat()
+{
+  static const ExponentialZiggurat s_ziggurat;
+  return s_ziggurat;
+}
+
+// Min-heap order for the queued activity TPs.
+bool
+later(const TriggerPrimitive& a, const TriggerPrimitive& b)
+{
+  return a.time_start > b.time_start;
+}
+
+} // namespace
+
+void
+TPGenerator::Random::seed(uint64_t seed) // NOLINT(build/unsigned)
+{
+  for (auto& state : m_state) {
+    seed += 0x9E3779B97F4A7C15ULL;
+    uint64_t z = seed; // NOLINT(build/unsigned)
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    state = z ^ (z >> 31);
+  }
+}
+
+uint64_t // NOLINT(build/unsigned)
+TPGenerator::Random::next()
+{
+  auto rotl = [](uint64_t x, int k) { return (x << k) | (x >> (64 - k)); }; // NOLINT(build/unsigned)
+  const uint64_t result = rotl(m_state[1] * 5, 7) * 9;                     // NOLINT(build/unsigned)
+  const uint64_t t = m_state[1] << 17;                                      // NOLINT(build/unsigned)
+  m_state[2] ^= m_state[0];
+  m_state[3] ^= m_state[1];
+  m_state[1] ^= m_state[2];
+  m_state[0] ^= m_state[3];
+  m_state[2] ^= t;
+  m_state[3] = rotl(m_state[3], 45);
+  return result;
+}
+
+double
+TPGenerator::Random::exponential(double mean)
+{
+  // Nearly always a point well inside a layer of the ziggurat, which needs no
+  // logarithm or exponential.
+  const ExponentialZiggurat& z = ziggurat();
+  while (true) {
+    const uint32_t bits = static_cast<uint32_t>(next() >> 32); // NOLINT(build/unsigned)
+    const int layer = bits & 0xFF;
+    const double x = bits * z.w[layer];
+    if (bits < z.k[layer])
+      return mean * x;
+    if (layer == 0)
+      return mean * (ExponentialZiggurat::r - std::log(1.0 - uniform()));
+    if (z.f[layer] + uniform() * (z.f[layer - 1] - z.f[layer]) < std::exp(-x))
+      return mean * x;
+  }
+}
+
+double
+TPGenerator::Random::normal()
+{
+  return (uniform() + uniform() + uniform() + uniform() - 2.0) * 1.7320508075688772;
+}
+
+void
+TPGenerator::configure(const nlohmann::json& config)
+{
+  if (config.is_object()) {
+    if (config.contains("seed"))
+      m_seed = config["seed"];
+    if (config.contains("clock_frequency_hz"))
+      m_clock_frequency_hz = config["clock_frequency_hz"];
+    if (config.contains("start_time"))
+      m_start_time = config["start_time"];
+    if (config.contains("detid"))
+      m_detid = config["detid"];
+    if (config.contains("first_channel"))
+      m_first_channel = config["first_channel"];
+    if (config.contains("n_channels"))
+      m_n_channels = config["n_channels"];
+    if (config.contains("noise_rate_hz"))
+      m_noise_rate_hz = config["noise_rate_hz"];
+    if (config.contains("track_rate_hz"))
+      m_track_rate_hz = config["track_rate_hz"];
+    if (config.contains("track_angles_deg"))
+      m_track_angles_deg = config["track_angles_deg"].get<std::vector<double>>();
+    if (config.contains("ticks_per_channel"))
+      m_ticks_per_channel = config["ticks_per_channel"];
+    if (config.contains("track_min_channels"))
+      m_track_min_channels = config["track_min_channels"];
+    if (config.contains("track_max_channels"))
+      m_track_max_channels = config["track_max_channels"];
+    if (config.contains("michel_rate_hz"))
+      m_michel_rate_hz = config["michel_rate_hz"];
+    if (config.contains("muon_lifetime_ticks"))
+      m_muon_lifetime_ticks = config["muon_lifetime_ticks"];
+    if (config.contains("supernova_rate_hz"))
+      m_supernova_rate_hz = config["supernova_rate_hz"];
+    if (config.contains("supernova_burst_interval"))
+      m_supernova_burst_interval = config["supernova_burst_interval"];
+    if (config.contains("supernova_burst_length"))
+      m_supernova_burst_length = config["supernova_burst_length"];
+    if (config.contains("shower_rate_hz"))
+      m_shower_rate_hz = config["shower_rate_hz"];
+    if (config.contains("shower_tps"))
+      m_shower_tps = config["shower_tps"];
+    if (config.contains("shower_channels"))
+      m_shower_channels = config["shower_channels"];
+    if (config.contains("shower_ticks"))
+      m_shower_ticks = config["shower_ticks"];
+  }
+
+  bool angles_ok = !m_track_angles_deg.empty();
+  for (double angle : m_track_angles_deg)
+    angles_ok &= angle >= 0 && angle < 90;
+  if (m_clock_frequency_hz <= 0 || m_n_channels <= 0 || !angles_ok || m_track_min_channels < 1 ||
+      m_track_max_channels < m_track_min_channels || m_shower_tps < 1 || m_shower_channels < 1 ||
+      m_noise_rate_hz < 0 || m_track_rate_hz < 0 || m_michel_rate_hz < 0 || m_supernova_rate_hz < 0 ||
+      m_shower_rate_hz < 0 || (m_supernova_burst_interval != 0 && m_supernova_burst_length == 0)) {
+    TLOG_DEBUG(TLVL_VERY_IMPORTANT) << "[TPGenerator] Invalid configuration: " << config.dump();
+    throw BadConfiguration(ERS_HERE, TRACE_NAME);
+  }
+
+  TLOG_DEBUG(TLVL_IMPORTANT) << "[TPGenerator] Seed " << m_seed << ", " << m_n_channels << " channels with noise at "
+                             << m_noise_rate_hz << " Hz, tracks at " << m_track_rate_hz << " Hz, Michels at "
+                             << m_michel_rate_hz << " Hz, supernova events at " << m_supernova_rate_hz
+                             << " Hz and showers at " << m_shower_rate_hz << " Hz.";
+  restart();
+}
+
+void
+TPGenerator::restart()
+{
+  m_random.seed(m_seed);
+  m_counters = Counters();
+  m_pending.clear();
+
+  const double start = m_start_time;
+  m_next_noise = next_arrival(start, m_noise_rate_hz * m_n_channels);
+  m_next_track = next_arrival(start, m_track_rate_hz);
+  m_next_michel = next_arrival(start, m_michel_rate_hz);
+  m_next_supernova = next_supernova_arrival(start);
+  m_next_shower = next_arrival(start, m_shower_rate_hz);
+}
+
+void
+TPGenerator::generate(std::size_t n_tps, std::vector<TriggerPrimitive>& output)
+{
+  output.reserve(output.size() + n_tps);
+  for (std::size_t i = 0; i < n_tps && next_time() < never; ++i)
+    take(output.emplace_back());
+}
+
+void
+TPGenerator::generate_until(timestamp_t until, std::vector<TriggerPrimitive>& output)
+{
+  // TPs start at the whole tick before their time.
+  while (std::floor(next_time()) < until)
+    take(output.emplace_back());
+}
+
+double
+TPGenerator::next_time()
+{
+  while (true) {
+    // Activities start at or before their first TP, so every activity that
+    // starts before the next TP is queued before that TP goes out.
+    const double next_pending = m_pending.empty() ? never : m_pending.front().time_start;
+    const double next_activity = std::min({ m_next_track, m_next_michel, m_next_supernova, m_next_shower });
+    if (next_activity <= m_next_noise && next_activity <= next_pending && next_activity < never) {
+      if (next_activity == m_next_track) {
+        add_track(m_next_track);
+        m_next_track = next_arrival(m_next_track, m_track_rate_hz);
+      } else if (next_activity == m_next_michel) {
+        add_michel(m_next_michel);
+        m_next_michel = next_arrival(m_next_michel, m_michel_rate_hz);
+      } else if (next_activity == m_next_supernova) {
+        add_supernova_event(m_next_supernova);
+        m_next_supernova = next_supernova_arrival(m_next_supernova);
+      } else {
+        add_shower(m_next_shower);
+        m_next_shower = next_arrival(m_next_shower, m_shower_rate_hz);
+      }
+      continue;
+    }
+    return std::min(next_pending, m_next_noise);
+  }
+}
+
+void
+TPGenerator::take(TriggerPrimitive& tp)
+{
+  if (!m_pending.empty() && m_pending.front().time_start <= m_next_noise) {
+    std::pop_heap(m_pending.begin(), m_pending.end(), later);
+    tp = m_pending.back();
+    m_pending.pop_back();
+  } else {
+    make_noise(m_next_noise, tp);
+    m_next_noise = next_arrival(m_next_noise, m_noise_rate_hz * m_n_channels);
+  }
+  ++m_counters.n_tps;
+}
+
+double
+TPGenerator::next_arrival(double time, double rate_hz)
+{
+  if (rate_hz <= 0)
+    return never;
+  return time + m_random.exponential(m_clock_frequency_hz / rate_hz);
+}
+
+double
+TPGenerator::next_supernova_arrival(double time)
+{
+  double arrival = next_arrival(time, m_supernova_rate_hz);
+  if (m_supernova_burst_interval == 0 || arrival >= never)
+    return arrival;
+
+  // Outside a burst, start again from the next one: the process has no memory.
+  const double interval = m_supernova_burst_interval;
+  while (true) {
+    const double since_start = arrival - m_start_time;
+    const double burst = std::floor(since_start / interval);
+    if (since_start - burst * interval < m_supernova_burst_length)
+      return arrival;
+    arrival = next_arrival(m_start_time + (burst + 1) * interval, m_supernova_rate_hz);
+  }
+}
+
+void
+TPGenerator::fill_tp(TriggerPrimitive& tp,
+                     channel_t channel,
+                     double time,
+                     double adc_peak,
+                     double time_over_threshold) const
+{
+  tp.type = TriggerPrimitive::Type::kTPC;
+  tp.algorithm = TriggerPrimitive::Algorithm::kSimpleThreshold;
+  tp.detid = m_detid;
+  tp.channel = channel;
+  tp.time_start = static_cast<timestamp_t>(time);
+  tp.time_over_threshold = std::max<timestamp_t>(1, static_cast<timestamp_t>(time_over_threshold));
+  tp.time_peak = tp.time_start + tp.time_over_threshold / 3;
+  tp.adc_peak = static_cast<uint16_t>(std::min(adc_peak, 65535.0)); // NOLINT(build/unsigned)
+  tp.adc_integral = static_cast<uint32_t>(tp.adc_peak * 0.5 * tp.time_over_threshold); // NOLINT(build/unsigned)
+}
+
+void
+TPGenerator::make_noise(double time, TriggerPrimitive& tp)
+{
+  ++m_counters.n_noise;
+  // Small pulses, mostly just over threshold: squares of uniforms, one pair
+  // from a single draw, as they are much cheaper than exponentials and only
+  // the arrival times need to be Poisson.
+  const uint64_t bits = m_random.next(); // NOLINT(build/unsigned)
+  const double size = (bits & 0xFFFFFFFF) * 0x1.0p-32;
+  const double length = (bits >> 32) * 0x1.0p-32;
+  fill_tp(tp, m_first_channel + m_random.below(m_n_channels), time, 10 + 30 * size * size, 2 + 30 * length * length);
+}
+
+void
+TPGenerator::queue_tp(channel_t channel, double time, double adc_peak, double time_over_threshold)
+{
+  if (!in_range(channel))
+    return;
+  m_pending.emplace_back();
+  fill_tp(m_pending.back(), channel, time, adc_peak, time_over_threshold);
+  std::push_heap(m_pending.begin(), m_pending.end(), later);
+}
+
+double
+TPGenerator::track_ticks_per_channel()
+{
+  const double angle = m_track_angles_deg[m_random.below(m_track_angles_deg.size())];
+  return std::tan(angle * radians_per_degree) * m_ticks_per_channel;
+}
+
+double
+TPGenerator::add_line(channel_t& channel,
+                      int direction,
+                      double time,
+                      double ticks_per_channel,
+                      int n_channels,
+                      double bragg)
+{
+  for (int i = 0; i < n_channels; ++i) {
+    // A minimum ionising particle, with a Landau-like tail, and a Bragg peak
+    // growing as the fourth power of the distance along the line.
+    const double along = double(i + 1) / n_channels;
+    const double charge = 1 + bragg * along * along * along * along;
+    const double adc_peak = (40 + m_random.exponential(15)) * charge;
+    // The signal on a channel lasts about as long as the track takes to cross it.
+    const double time_over_threshold = std::min(12 + ticks_per_channel + m_random.exponential(4), 5000.0);
+    queue_tp(channel, time + i * ticks_per_channel + 2 * m_random.uniform(), adc_peak, time_over_threshold);
+    if (i + 1 < n_channels)
+      channel += direction;
+  }
+  return time + (n_channels - 1) * ticks_per_channel;
+}
+
+void
+TPGenerator::add_track(double time)
+{
+  ++m_counters.n_tracks;
+  channel_t channel = m_first_channel + m_random.below(m_n_channels);
+  const int direction = m_random.below(2) ? 1 : -1;
+  const int length = m_track_min_channels + m_random.below(m_track_max_channels - m_track_min_channels + 1);
+  add_line(channel, direction, time, track_ticks_per_channel(), length, 0);
+}
+
+void
+TPGenerator::add_michel(double time)
+{
+  ++m_counters.n_michels;
+
+  // A stopping muon...
+  channel_t channel = m_first_channel + m_random.below(m_n_channels);
+  int direction = m_random.below(2) ? 1 : -1;
+  const int length = m_track_min_channels + m_random.below(m_track_max_channels - m_track_min_channels + 1);
+  const double end = add_line(channel, direction, time, track_ticks_per_channel(), length, 3);
+
+  // ...then, a muon lifetime later, a short electron track from where it
+  // stopped, in a direction of its own.
+  direction = m_random.below(2) ? 1 : -1;
+  channel += direction;
+  const double electron_ticks_per_channel = std::tan(m_random.uniform() * 80 * radians_per_degree) * m_ticks_per_channel;
+  add_line(channel,
+           direction,
+           end + m_random.exponential(m_muon_lifetime_ticks),
+           electron_ticks_per_channel,
+           5 + m_random.below(26),
+           0);
+}
+
+void
+TPGenerator::add_supernova_event(double time)
+{
+  ++m_counters.n_supernova_events;
+  const channel_t channel = m_first_channel + m_random.below(m_n_channels);
+  const int n_tps = 1 + m_random.below(6);
+  for (int i = 0; i < n_tps; ++i)
+    queue_tp(channel + i, time + m_random.below(20), 15 + m_random.exponential(10), 3 + m_random.exponential(5));
+}
+
+void
+TPGenerator::add_shower(double time)
+{
+  ++m_counters.n_showers;
+  const channel_t centre = m_first_channel + m_random.below(m_n_channels);
+  const int n_tps = m_shower_tps / 2 + m_random.below(m_shower_tps + 1);
+  for (int i = 0; i < n_tps; ++i) {
+    const channel_t channel = centre + static_cast<channel_t>(std::lround(m_random.normal() * m_shower_channels / 4));
+    queue_tp(channel,
+             time + m_random.uniform() * m_shower_ticks,
+             30 + m_random.exponential(60),
+             10 + m_random.exponential(30));
+  }
+}
@@ -61,6 +61,30 @@ TriggerActivityMakerADCSimpleWindow::operator()(const TriggerPrimitive& input_tp
   return;
 }
 
+void
+TriggerActivityMakerADCSimpleWindow::operator()(Span<const TriggerPrimitive> input_tps,
+                                                std::vector<TriggerActivity>& output_ta)
+{
+  for (const TriggerPrimitive& input_tp : input_tps)
+    TriggerActivityMakerADCSimpleWindow::operator()(input_tp, output_ta);
+}
+
+void
+TriggerActivityMakerADCSimpleWindow::flush(timestamp_t until, std::vector<TriggerActivity>& output_ta)
+{
+  // No TP from `until` on can be added to a complete window, so take the decision
+  // the next TP would take now rather than hold the window until it arrives.
+  if (!m_current_window.is_complete(until, m_window_length))
+    return;
+
+  if (m_current_window.adc_integral > m_adc_threshold) {
+    TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TAM:ADCSW] ADC integral in window is greater than specified threshold, flushing up to " << until << ".";
+    output_ta.push_back(construct_ta());
+    // The next TP starts a fresh window.
+    m_current_window.clear();
+  }
+}
+
 void
 TriggerActivityMakerADCSimpleWindow::configure(const nlohmann::json &config)
 {
@@ -82,7 +106,7 @@ TriggerActivityMakerADCSimpleWindow::construct_ta() const
   TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TAM:ADCSW] I am constructing a trigger activity!";
   //TLOG_DEBUG(TRACE_NAME) << m_current_window;
 
-  TriggerPrimitive latest_tp_in_window = m_current_window.tp_list.back();
+  const TriggerPrimitive& latest_tp_in_window = m_current_window.back();
   // The time_peak, time_activity, channel_* and adc_peak fields of this TA are irrelevent
   // for the purpose of this trigger alg.
   TriggerActivity ta;
@@ -98,7 +122,7 @@ TriggerActivityMakerADCSimpleWindow::construct_ta() const
   ta.detid = latest_tp_in_window.detid;
   ta.type = TriggerActivity::Type::kTPC;
   ta.algorithm = TriggerActivity::Algorithm::kADCSimpleWindow;
-  ta.inputs = m_current_window.tp_list;
+  ta.inputs = m_current_window.inputs();
   return ta;
 }
 
@@ -11,6 +11,9 @@
 #include "TRACE/trace.h"
 #define TRACE_NAME "TriggerActivityMakerBundleNPlugin"
 
+#include <algorithm>
+#include <utility>
+
 namespace triggeralgs {
 
 using Logging::TLVL_IMPORTANT;
@@ -56,24 +59,52 @@ TriggerActivityMakerBundleN::operator()(const TriggerPrimitive& input_tp, std::v
 
   if (bundle_condition()) {
     TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TA:BN] Emitting BundleN TA with " << m_current_ta.inputs.size() << " TPs.";
-    set_ta_attributes();
-    output_tas.push_back(m_current_ta);
-
-    // Reset the current.
-    m_current_ta = TriggerActivity();
+    emit_ta(output_tas);
   }
 
   // Should never reach this step. In this case, send it out.
   if (m_current_ta.inputs.size() > m_bundle_size) {
     TLOG_DEBUG(TLVL_IMPORTANT) << "[TA:BN] Emitting large BundleN TriggerActivity with " << m_current_ta.inputs.size() << " TPs.";
-    set_ta_attributes();
-    output_tas.push_back(m_current_ta);
+    emit_ta(output_tas);
+  }
+}
+
+void
+TriggerActivityMakerBundleN::operator()(Span<const TriggerPrimitive> input_tps, std::vector<TriggerActivity>& output_tas)
+{
+  // Append whole bundles at a time instead of one TP at a time.
+  size_t next = 0;
+  while (next < input_tps.size()) {
+    size_t n_missing = m_current_ta.inputs.size() < m_bundle_size ? m_bundle_size - m_current_ta.inputs.size() : 0;
+    size_t n_take = std::min(n_missing, input_tps.size() - next);
+
+    // Nothing fits in the current bundle (eg a bundle_size of 0): the single TP path
+    // knows how to send that out.
+    if (n_take == 0) {
+      TriggerActivityMakerBundleN::operator()(input_tps[next++], output_tas);
+      continue;
+    }
 
-    // Reset the current.
-    m_current_ta = TriggerActivity();
+    m_current_ta.inputs.insert(m_current_ta.inputs.end(), input_tps.begin() + next, input_tps.begin() + next + n_take);
+    next += n_take;
+
+    if (bundle_condition()) {
+      TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TA:BN] Emitting BundleN TA with " << m_current_ta.inputs.size() << " TPs.";
+      emit_ta(output_tas);
+    }
   }
 }
 
+void
+TriggerActivityMakerBundleN::emit_ta(std::vector<TriggerActivity>& output_tas)
+{
+  set_ta_attributes();
+  output_tas.push_back(std::move(m_current_ta));
+
+  // Reset the current.
+  m_current_ta = TriggerActivity();
+}
+
 void
 TriggerActivityMakerBundleN::configure(const nlohmann::json& config)
 {
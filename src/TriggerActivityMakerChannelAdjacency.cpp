@@ -10,7 +10,10 @@
 #include "TRACE/trace.h"
 #include "triggeralgs/Logging.hpp"
 #define TRACE_NAME "TriggerActivityMakerChannelAdjacencyPlugin"
+#include <algorithm>
 #include <math.h>
+#include <tuple>
+#include <utility>
 #include <vector>
 
 using namespace triggeralgs;
@@ -48,41 +51,7 @@ TriggerActivityMakerChannelAdjacency::operator()(const TriggerPrimitive& input_t
   }
 
   else {
-    TPWindow win_adj_max;
-
-    bool ta_found = 1;
-    while (ta_found) {
-
-      // make m_current_window_tmp a copy of m_current_window and clear m_current_window
-      TPWindow m_current_window_tmp = m_current_window;
-      m_current_window.clear();
-
-      // make m_current_window a new window of non-overlapping tps (of m_current_window_tmp and win_adj_max)
-      for (auto tp : m_current_window_tmp.inputs) {
-        bool new_tp = 1;
-        for (auto tp_sel : win_adj_max.inputs) {
-          if (tp.channel == tp_sel.channel) {
-            new_tp = 0;
-            break;
-          }
-        }
-        if (new_tp)
-          m_current_window.add(tp);
-      }
-
-      // check adjacency -> win_adj_max now contains only those tps that make the track
-      win_adj_max = check_adjacency();
-      if (win_adj_max.inputs.size() > 0) {
-
-        adj_pass = 1;
-        ta_found = 1;
-        m_ta_count++;
-        if (m_ta_count % m_prescale == 0) {
-          output_ta.push_back(construct_ta(win_adj_max));
-        }
-      } else
-        ta_found = 0;
-    }
+    adj_pass = make_track_tas(output_ta);
     if (adj_pass)
       m_current_window.reset(input_tp);
   }
@@ -95,6 +64,135 @@ TriggerActivityMakerChannelAdjacency::operator()(const TriggerPrimitive& input_t
   return;
 }
 
+void
+TriggerActivityMakerChannelAdjacency::operator()(Span<const TriggerPrimitive> input_tps,
+                                                 std::vector<TriggerActivity>& output_ta)
+{
+  for (const TriggerPrimitive& input_tp : input_tps)
+    TriggerActivityMakerChannelAdjacency::operator()(input_tp, output_ta);
+}
+
+void
+TriggerActivityMakerChannelAdjacency::index_channels()
+{
+  // Sort the window's TPs by channel, keeping those on the same channel in
+  // window order, and list the channels hit.
+  m_sorted_tps.clear();
+  for (size_t i = 0; i < m_current_window.size(); ++i)
+    m_sorted_tps.emplace_back(m_current_window.at(i).channel, i);
+  std::sort(m_sorted_tps.begin(), m_sorted_tps.end());
+
+  m_channels.clear();
+  for (const auto& [channel, position] : m_sorted_tps) {
+    if (!m_channels.empty() && m_channels.back().channel == static_cast<unsigned int>(channel)) {
+      m_channels.back().last_tp = position;
+      continue;
+    }
+    m_channels.push_back({ static_cast<unsigned int>(channel), position, position, m_channels.size() + 1 });
+  }
+}
+
+bool
+TriggerActivityMakerChannelAdjacency::make_track_tas(std::vector<TriggerActivity>& output_ta)
+{
+  // Take tracks out of the complete window, making a TA of each, until no track
+  // is left. Returns whether any track was found.
+  //
+  // The hit channels are walked in order, in runs as the adjacency logic below
+  // extends them, and the first run longer than the threshold is a track. Its
+  // channels are then left out, which can only change the run just before it,
+  // that ended on the track's first channel: the walk goes back to the start of
+  // that run and carries on, rather than starting over. Each channel is walked
+  // once, plus once again for every track found, after the sort.
+  index_channels();
+  const std::size_t end = m_channels.size();
+  std::size_t head = 0;
+  m_runs.clear();
+  bool adj_pass = 0;
+
+  // ADAJACENCY LOGIC ====================================================================
+  // Adjcancency Tolerance = Number of times prepared to skip missed hits before resetting
+  // the adjacency count. This accounts for things like dead channels / missed TPs.
+  std::size_t run_start = end;
+  std::size_t run_before = end; // The channel walked before the run, or end
+  std::size_t run_length = 0;
+  unsigned int tol_count = 0; // Tolerance count, should not pass adj_tolerance
+  std::size_t before = end;
+  std::size_t current = head;
+  while (current != end) {
+    if (run_length == 0) {
+      run_start = current;
+      run_before = before;
+      run_length = 1;
+    }
+
+    std::size_t next = m_channels[current].next;
+    unsigned int gap = next == end ? 0 : m_channels[next].channel - m_channels[current].channel;
+
+    // If next hit is on next channel, increment the adjacency count
+    if (gap == 1) {
+      ++run_length;
+    }
+
+    // Allow a max gap of 5 channels (e.g., 45 and 50; 46, 47, 48, 49 are missing); increment the adjacency count
+    // Sum of gaps should be < adj_tolerance (e.g., if toleance is 30, the max total gap can vary from 0 to 29+4 = 33)
+    else if (gap > 1 && gap <= 5 && tol_count < m_adj_tolerance) {
+      ++run_length;
+      tol_count += gap - 1;
+    }
+
+    // If track length > m_adjacency_threshold, make a TA of it and take its
+    // channels out of the walk.
+    else if (run_length > m_adjacency_threshold) {
+      adj_pass = 1;
+      m_ta_count++;
+      if (m_ta_count % m_prescale == 0)
+        output_ta.push_back(construct_ta(run_start, current));
+
+      if (run_before == end)
+        head = next;
+      else
+        m_channels[run_before].next = next;
+
+      if (m_runs.empty()) {
+        before = end;
+        current = head;
+      } else {
+        std::tie(current, before) = m_runs.back();
+        m_runs.pop_back();
+      }
+      run_length = 0;
+      tol_count = 0;
+      continue;
+    }
+
+    // If track length < m_adjacency_threshold, reset variables for next iteration.
+    else {
+      m_runs.emplace_back(run_start, run_before);
+      run_length = 0;
+      tol_count = 0;
+    }
+
+    before = current;
+    current = next;
+  }
+
+  return adj_pass;
+}
+
+void
+TriggerActivityMakerChannelAdjacency::flush(timestamp_t until, std::vector<TriggerActivity>& output_ta)
+{
+  // No TP from `until` on can be added to a complete window: look for tracks in it
+  // now, as the next TP would, rather than hold the window until that TP arrives.
+  if (!m_current_window.is_complete(until, m_window_length))
+    return;
+
+  // The next TP starts a fresh window.
+  if (make_track_tas(output_ta))
+    m_current_window.clear();
+}
+
 void
 TriggerActivityMakerChannelAdjacency::configure(const nlohmann::json& config)
 {
@@ -113,12 +211,22 @@ TriggerActivityMakerChannelAdjacency::configure(const nlohmann::json& config)
 }
 
 TriggerActivity
-TriggerActivityMakerChannelAdjacency::construct_ta(TPWindow win_adj_max) const
+TriggerActivityMakerChannelAdjacency::construct_ta(std::size_t first, std::size_t last)
 {
+  // The track starts with the last TP on its first channel, and takes the
+  // first TP on each of the others.
+  m_track.clear();
+  m_track.push_back(m_current_window.at(m_channels[first].last_tp));
+  uint32_t adc_integral = m_track.back().adc_integral; // NOLINT(build/unsigned)
+  for (std::size_t i = first; i != last;) {
+    i = m_channels[i].next;
+    m_track.push_back(m_current_window.at(m_channels[i].first_tp));
+    adc_integral += m_track.back().adc_integral;
+  }
 
   TriggerActivity ta;
 
-  TriggerPrimitive last_tp = win_adj_max.inputs.back();
+  const TriggerPrimitive& last_tp = m_track.back();
 
   ta.time_start = last_tp.time_start;
   ta.time_end = last_tp.time_start;
@@ -127,12 +235,12 @@ TriggerActivityMakerChannelAdjacency::construct_ta(TPWindow win_adj_max) const
   ta.channel_start = last_tp.channel;
   ta.channel_end = last_tp.channel;
   ta.channel_peak = last_tp.channel;
-  ta.adc_integral = win_adj_max.adc_integral;
+  ta.adc_integral = adc_integral;
   ta.adc_peak = last_tp.adc_peak;
   ta.detid = last_tp.detid;
   ta.type = TriggerActivity::Type::kTPC;
   ta.algorithm = TriggerActivity::Algorithm::kChannelAdjacency;
-  ta.inputs = win_adj_max.inputs;
+  ta.inputs = m_track;
 
   for (const auto& tp : ta.inputs) {
     ta.time_start = std::min(ta.time_start, tp.time_start);
@@ -149,93 +257,11 @@ TriggerActivityMakerChannelAdjacency::construct_ta(TPWindow win_adj_max) const
   return ta;
 }
 
-// std::vector<TriggerPrimitive>
-TPWindow
-TriggerActivityMakerChannelAdjacency::check_adjacency()
-{
-  // This function deals with tp window (m_current_window), select adjacent tps (with a channel gap from 0 to 5; sum of
-  // all gaps < m_adj_tolerance), checks if track length > m_adjacency_threshold: return the tp window (win_adj_max,
-  // which is subset of the input tp window)
-
-  unsigned int channel = 0;      // Current channel ID
-  unsigned int next_channel = 0; // Next channel ID
-  unsigned int next = 0;         // The next position in the hit channels vector
-  unsigned int tol_count = 0;    // Tolerance count, should not pass adj_tolerance
-
-  // Generate a channelID ordered list of hit channels for this window; second element of pair is tps
-  std::vector<std::pair<int, TriggerPrimitive>> chanTPList;
-  for (auto tp : m_current_window.inputs) {
-    chanTPList.push_back(std::make_pair(tp.channel, tp));
-  }
-  std::sort(chanTPList.begin(),
-            chanTPList.end(),
-            [](const std::pair<int, TriggerPrimitive>& a, const std::pair<int, TriggerPrimitive>& b) {
-              return (a.first < b.first);
-            });
-
-  // ADAJACENCY LOGIC ====================================================================
-  // =====================================================================================
-  // Adjcancency Tolerance = Number of times prepared to skip missed hits before resetting
-  // the adjacency count (win_adj). This accounts for things like dead channels / missed TPs.
-
-  // add first tp, and then if tps are on next channels (check code below to understand the definition)
-  TPWindow win_adj;
-  TPWindow win_adj_max; // if track length > m_adjacency_threshold, set win_adj_max = win_adj; return win_adj_max;
-
-  for (int i = 0; i < chanTPList.size(); ++i) {
-
-    win_adj_max.clear();
-
-    next = (i + 1) % chanTPList.size(); // Loops back when outside of channel list range
-    channel = chanTPList.at(i).first;
-    next_channel = chanTPList.at(next).first; // Next channel with a hit
-
-    // End of vector condition.
-    if (next == 0) {
-      next_channel = channel - 1;
-    }
-
-    // Skip same channel hits.
-    if (next_channel == channel)
-      continue;
-
-    // If win_adj size == zero, add current tp
-    if (win_adj.inputs.size() == 0)
-      win_adj.add(chanTPList[i].second);
-
-    // If next hit is on next channel, increment the adjacency count
-    if (next_channel - channel == 1) {
-      win_adj.add(chanTPList[next].second);
-    }
-
-    // Allow a max gap of 5 channels (e.g., 45 and 50; 46, 47, 48, 49 are missing); increment the adjacency count
-    // Sum of gaps should be < adj_tolerance (e.g., if toleance is 30, the max total gap can vary from 0 to 29+4 = 33)
-    else if (next_channel - channel > 0 && next_channel - channel <= 5 && tol_count < m_adj_tolerance) {
-      win_adj.add(chanTPList[next].second);
-      tol_count += next_channel - channel - 1;
-    }
-
-    // if track length > m_adjacency_threshold, set win_adj_max = win_adj;
-    else if (win_adj.inputs.size() > m_adjacency_threshold) {
-      win_adj_max = win_adj;
-      break;
-    }
-
-    // If track length < m_adjacency_threshold, reset variables for next iteration.
-    else {
-      tol_count = 0;
-      win_adj.clear();
-    }
-  }
-
-  return win_adj_max;
-}
-
 // =====================================================================================
 // Functions below this line are for debugging purposes.
 // =====================================================================================
 void
-TriggerActivityMakerChannelAdjacency::add_window_to_record(TPWindow window)
+TriggerActivityMakerChannelAdjacency::add_window_to_record(const TPWindow& window)
 {
   m_window_record.push_back(window);
   return;
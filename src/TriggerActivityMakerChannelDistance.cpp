@@ -54,6 +54,22 @@ TriggerActivityMakerChannelDistance::operator()(const TriggerPrimitive& input_tp
   m_current_upper_bound = std::max(m_current_upper_bound, input_tp.channel + m_max_channel_distance);
 }
 
+void
+TriggerActivityMakerChannelDistance::flush(timestamp_t until, std::vector<TriggerActivity>& output_tas)
+{
+  // Any TP from `until` on would close the TA based on time, so close it now.
+  if (m_current_ta.inputs.empty() || until < m_current_ta.inputs.front().time_start ||
+      until - m_current_ta.inputs.front().time_start <= m_window_length)
+    return;
+
+  if (m_current_ta.inputs.size() >= m_min_tps) {
+    set_ta_attributes();
+    output_tas.push_back(m_current_ta);
+  }
+  // The next TP starts a new TA.
+  m_current_ta = TriggerActivity();
+}
+
 void
 TriggerActivityMakerChannelDistance::configure(const nlohmann::json& config)
 {
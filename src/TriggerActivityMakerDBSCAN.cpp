@@ -32,8 +32,27 @@ TriggerActivityMakerDBSCAN::operator()(const TriggerPrimitive& input_tp, std::ve
   m_dbscan_clusters.clear();
   m_dbscan->add_primitive(input_tp, &m_dbscan_clusters);
 
-  uint64_t t0=m_dbscan->get_first_prim_time();
-  
+  make_tas(output_ta);
+
+  m_dbscan->trim_hits();
+}
+
+void
+TriggerActivityMakerDBSCAN::flush(timestamp_t until, std::vector<TriggerActivity>& output_ta)
+{
+  // Clusters that no TP from `until` on can grow are complete: send them out
+  // now rather than when the next TP arrives.
+  m_dbscan_clusters.clear();
+  m_dbscan->flush(until, &m_dbscan_clusters);
+
+  make_tas(output_ta);
+
+  m_dbscan->trim_hits();
+}
+
+void
+TriggerActivityMakerDBSCAN::make_tas(std::vector<TriggerActivity>& output_ta) const
+{
   for(auto const& cluster : m_dbscan_clusters){
     auto& ta=output_ta.emplace_back();
 
@@ -68,8 +87,6 @@ TriggerActivityMakerDBSCAN::operator()(const TriggerPrimitive& input_tp, std::ve
     ta.type = TriggerActivity::Type::kTPC;
     ta.algorithm = TriggerActivity::Algorithm::kDBSCAN;
   }
-
-  m_dbscan->trim_hits();
 }
 
 void
@@ -82,7 +99,7 @@ TriggerActivityMakerDBSCAN::configure(const nlohmann::json &config)
     if (config.contains("eps"))
       m_eps = config["eps"];
   }
-  m_dbscan=std::make_unique<dbscan::IncrementalDBSCAN>(m_eps, m_min_pts, 10000);
+  m_dbscan=std::make_unique<dbscan::IncrementalDBSCAN>(m_eps, m_min_pts);
 }
 
 // Register algo in TA Factory
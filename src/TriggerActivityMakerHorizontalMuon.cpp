@@ -55,7 +55,7 @@ TriggerActivityMakerHorizontalMuon::operator()(const TriggerPrimitive& input_tp,
 
     ta_count++;
     if (ta_count % m_prescale == 0) {
-      auto ta = construct_ta();
+      auto ta = construct_ta(m_current_window);
       TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:HM]: Emitting ADC threshold trigger with " << m_current_window.adc_integral
                                     << " window ADC integral. ta.time_start=" << ta.time_start
                                     << " ta.time_end=" << ta.time_end;
@@ -77,7 +77,7 @@ TriggerActivityMakerHorizontalMuon::operator()(const TriggerPrimitive& input_tp,
       TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:HM] Emitting multiplicity trigger with "
                                     << m_current_window.n_channels_hit() << " unique channels hit.";
 
-      output_ta.push_back(construct_ta());
+      output_ta.push_back(construct_ta(m_current_window));
       m_current_window.reset(input_tp);
     }
   }
@@ -100,11 +100,11 @@ TriggerActivityMakerHorizontalMuon::operator()(const TriggerPrimitive& input_tp,
         m_max_adjacency = adjacency;
       }
       TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:HM] Emitting track and multiplicity TA with adjacency "
-                                    << check_adjacency() << " and multiplicity " << m_current_window.n_channels_hit()
+                                    << adjacency << " and multiplicity " << m_current_window.n_channels_hit()
                                     << ". The ADC integral of this TA is " << m_current_window.adc_integral
                                     << " and the largest longest track seen so far is " << m_max_adjacency;
 
-      output_ta.push_back(construct_ta());
+      output_ta.push_back(construct_ta(m_current_window));
       m_current_window.reset(input_tp);
     }
   }
@@ -117,7 +117,7 @@ TriggerActivityMakerHorizontalMuon::operator()(const TriggerPrimitive& input_tp,
     TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:HM] Emitting a TA due to a TP with a very large time over threshold: "
                                   << input_tp.time_over_threshold << " ticks and offline channel: " << input_tp.channel
                                   << ", where the ADC integral of that TP is " << input_tp.adc_integral;
-    output_ta.push_back(construct_ta());
+    output_ta.push_back(construct_ta(m_current_window));
     m_current_window.reset(input_tp);
   }
 
@@ -129,6 +129,44 @@ TriggerActivityMakerHorizontalMuon::operator()(const TriggerPrimitive& input_tp,
   return;
 }
 
+void
+TriggerActivityMakerHorizontalMuon::operator()(Span<const TriggerPrimitive> input_tps,
+                                               std::vector<TriggerActivity>& output_ta)
+{
+  for (const TriggerPrimitive& input_tp : input_tps)
+    TriggerActivityMakerHorizontalMuon::operator()(input_tp, output_ta);
+}
+
+void
+TriggerActivityMakerHorizontalMuon::flush(timestamp_t until, std::vector<TriggerActivity>& output_ta)
+{
+  // A TP at or after `until` would find the window complete and check triggers 1) to 3)
+  // on it. Do that now rather than hold the window until such a TP arrives. The large
+  // TOT trigger is about that TP itself, so it is left to it.
+  if (!m_current_window.is_complete(until, m_window_length))
+    return;
+
+  uint16_t adjacency = 0;
+  bool triggered = (m_current_window.adc_integral > m_adc_threshold && m_trigger_on_adc) ||
+                   (m_current_window.n_channels_hit() > m_n_channels_threshold && m_trigger_on_n_channels) ||
+                   ((adjacency = check_adjacency()) > m_adjacency_threshold && m_trigger_on_adjacency);
+
+  // If the prescale would drop this TA, leave the decision (and the count) to the TP.
+  if (!triggered || static_cast<uint16_t>(ta_count + 1) % m_prescale != 0)
+    return;
+
+  ta_count++;
+  if (adjacency > m_max_adjacency) {
+    m_max_adjacency = adjacency;
+  }
+  TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:HM] Emitting TA on flush up to " << until << " with adjacency " << adjacency
+                                << ", multiplicity " << m_current_window.n_channels_hit() << " and ADC integral "
+                                << m_current_window.adc_integral;
+  output_ta.push_back(construct_ta(m_current_window));
+  // The next TP starts a fresh window.
+  m_current_window.clear();
+}
+
 void
 TriggerActivityMakerHorizontalMuon::configure(const nlohmann::json& config)
 {
@@ -161,12 +199,12 @@ TriggerActivityMakerHorizontalMuon::configure(const nlohmann::json& config)
 }
 
 TriggerActivity
-TriggerActivityMakerHorizontalMuon::construct_ta() const
+TriggerActivityMakerHorizontalMuon::construct_ta(const TPWindow& window)
 {
 
   TriggerActivity ta;
 
-  TriggerPrimitive last_tp = m_current_window.inputs.back();
+  const TriggerPrimitive& last_tp = window.back();
 
   ta.time_start = last_tp.time_start;
   ta.time_end = last_tp.time_start + last_tp.time_over_threshold;
@@ -175,12 +213,12 @@ TriggerActivityMakerHorizontalMuon::construct_ta() const
   ta.channel_start = last_tp.channel;
   ta.channel_end = last_tp.channel;
   ta.channel_peak = last_tp.channel;
-  ta.adc_integral = m_current_window.adc_integral;
+  ta.adc_integral = window.adc_integral;
   ta.adc_peak = last_tp.adc_integral;
   ta.detid = last_tp.detid;
   ta.type = TriggerActivity::Type::kTPC;
   ta.algorithm = TriggerActivity::Algorithm::kHorizontalMuon;
-  ta.inputs = m_current_window.inputs;
+  ta.inputs = window.inputs();
 
   for (const auto& tp : ta.inputs) {
     ta.time_start = std::min(ta.time_start, tp.time_start);
@@ -205,78 +243,14 @@ TriggerActivityMakerHorizontalMuon::check_adjacency() const
   // a configurable tolerance paramter, which allows up to adj_tolerance missing hits
   // on adjacent wires before restarting the adjacency count. The maximum gap is 4 which
   // comes from tuning on December 2021 coldbox data, and June 2022 coldbox runs.
-
-  uint16_t adj = 1;              // Initialise adjacency, 1 for the first wire.
-  uint16_t max = 0;              // Maximum adjacency of window, which this function returns
-  unsigned int channel = 0;      // Current channel ID
-  unsigned int next_channel = 0; // Next channel ID
-  unsigned int next = 0;         // The next position in the hit channels vector
-  unsigned int tol_count = 0;    // Tolerance count, should not pass adj_tolerance
-
-  // Generate a channelID ordered list of hit channels for this window
-  std::vector<int> chanList;
-  for (auto tp : m_current_window.inputs) {
-    chanList.push_back(tp.channel);
-  }
-  std::sort(chanList.begin(), chanList.end());
-
-  // ADAJACENCY LOGIC ====================================================================
-  // =====================================================================================
-  // Adjcancency Tolerance = Number of times prepared to skip missed hits before resetting
-  // the adjacency count. This accounts for things like dead channels / missed TPs. The
-  // maximum gap is 4 which comes from tuning on December 2021 coldbox data, and June 2022
-  // coldbox runs.
-  for (int i = 0; i < chanList.size(); ++i) {
-
-    next = (i + 1) % chanList.size(); // Loops back when outside of channel list range
-    channel = chanList.at(i);
-    next_channel = chanList.at(next); // Next channel with a hit
-
-    // End of vector condition.
-    if (next_channel == 0) {
-      next_channel = channel - 1;
-    }
-
-    // Skip same channel hits.
-    if (next_channel == channel) {
-      continue;
-    }
-
-    // If next hit is on next channel, increment the adjacency count.
-    else if (next_channel == channel + 1) {
-      ++adj;
-    }
-
-    // If next channel is not on the next hit, but the 'second next', increase adjacency
-    // but also tally up with the tolerance counter.
-    else if (((next_channel == channel + 2) || (next_channel == channel + 3) || (next_channel == channel + 4) ||
-              (next_channel == channel + 5)) &&
-             (tol_count < m_adj_tolerance)) {
-      ++adj;
-      for (int i = 0; i < next_channel - channel; ++i) {
-        ++tol_count;
-      }
-    }
-
-    // If next hit isn't within reach, end the adjacency count and check for a new max.
-    // Reset variables for next iteration.
-    else {
-      if (adj > max) {
-        max = adj;
-      }
-      adj = 1;
-      tol_count = 0;
-    }
-  }
-
-  return max;
+  return m_current_window.longest_adjacent_run(5, m_adj_tolerance);
 }
 
 // =====================================================================================
 // Functions below this line are for debugging purposes.
 // =====================================================================================
 void
-TriggerActivityMakerHorizontalMuon::add_window_to_record(TPWindow window)
+TriggerActivityMakerHorizontalMuon::add_window_to_record(const TPWindow& window)
 {
   m_window_record.push_back(window);
   return;
@@ -289,15 +263,15 @@ TriggerActivityMakerHorizontalMuon::dump_window_record()
   std::ofstream outfile;
   outfile.open("window_record_tam.csv", std::ios_base::app);
 
-  for (auto window : m_window_record) {
+  for (const auto& window : m_window_record) {
     outfile << window.time_start << ",";
-    outfile << window.inputs.back().time_start << ",";
-    outfile << window.inputs.back().time_start - window.time_start << ",";
+    outfile << window.back().time_start << ",";
+    outfile << window.back().time_start - window.time_start << ",";
     outfile << window.adc_integral << ",";
     outfile << window.n_channels_hit() << ",";       // Number of unique channels with hits
-    outfile << window.inputs.size() << ",";          // Number of TPs in TPWindow
-    outfile << window.inputs.back().channel << ",";  // Last TP Channel ID
-    outfile << window.inputs.front().channel << ","; // First TP Channel ID
+    outfile << window.size() << ",";                 // Number of TPs in TPWindow
+    outfile << window.back().channel << ",";         // Last TP Channel ID
+    outfile << window.front().channel << ",";        // First TP Channel ID
     outfile << check_adjacency() << ",";             // New adjacency value for the window
     outfile << check_tot() << std::endl;             // Summed window TOT
   }
@@ -335,8 +309,8 @@ TriggerActivityMakerHorizontalMuon::check_tot() const
   // Here, we just want to sum up all the tot values for each TP within window,
   // and return this tot of the window.
   int window_tot = 0;
-  for (auto tp : m_current_window.inputs) {
-    window_tot += tp.time_over_threshold;
+  for (size_t i = 0; i < m_current_window.size(); ++i) {
+    window_tot += m_current_window.at(i).time_over_threshold;
   }
 
   return window_tot;
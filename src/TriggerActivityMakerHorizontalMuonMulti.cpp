@@ -0,0 +1,372 @@
+/**
+ * @file TriggerActivityMakerHorizontalMuonMulti.cpp
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "triggeralgs/HorizontalMuon/TriggerActivityMakerHorizontalMuonMulti.hpp"
+#include "triggeralgs/HorizontalMuon/TriggerActivityMakerHorizontalMuon.hpp"
+#include "triggeralgs/Issues.hpp"
+
+#include "TRACE/trace.h"
+#define TRACE_NAME "TriggerActivityMakerHorizontalMuonMultiPlugin"
+
+#include <algorithm>
+#include <vector>
+
+using namespace triggeralgs;
+
+using Logging::TLVL_DEBUG_ALL;
+using Logging::TLVL_DEBUG_MEDIUM;
+
+TriggerActivityMakerHorizontalMuonMulti::TriggerActivityMakerHorizontalMuonMulti()
+{
+  configure(nlohmann::json::object());
+}
+
+void
+TriggerActivityMakerHorizontalMuonMulti::operator()(const TriggerPrimitive& input_tp,
+                                                    std::vector<TriggerActivity>& output_ta)
+{
+  m_output_sets.clear();
+  process(input_tp, [&](std::size_t set, const TriggerActivity& ta) {
+    output_ta.push_back(ta);
+    m_output_sets.push_back(set);
+  });
+}
+
+void
+TriggerActivityMakerHorizontalMuonMulti::operator()(Span<const TriggerPrimitive> input_tps,
+                                                    std::vector<TriggerActivity>& output_ta)
+{
+  m_output_sets.clear();
+  for (const TriggerPrimitive& input_tp : input_tps) {
+    process(input_tp, [&](std::size_t set, const TriggerActivity& ta) {
+      output_ta.push_back(ta);
+      m_output_sets.push_back(set);
+    });
+  }
+}
+
+void
+TriggerActivityMakerHorizontalMuonMulti::flush(timestamp_t until, std::vector<TriggerActivity>& output_ta)
+{
+  m_output_sets.clear();
+  process_flush(until, [&](std::size_t set, const TriggerActivity& ta) {
+    output_ta.push_back(ta);
+    m_output_sets.push_back(set);
+  });
+}
+
+void
+TriggerActivityMakerHorizontalMuonMulti::operator()(const TriggerPrimitive& input_tp,
+                                                    std::vector<std::vector<TriggerActivity>>& output_ta)
+{
+  if (output_ta.size() < m_sets.size())
+    output_ta.resize(m_sets.size());
+  process(input_tp, [&](std::size_t set, const TriggerActivity& ta) { output_ta[set].push_back(ta); });
+}
+
+void
+TriggerActivityMakerHorizontalMuonMulti::flush(timestamp_t until,
+                                               std::vector<std::vector<TriggerActivity>>& output_ta)
+{
+  if (output_ta.size() < m_sets.size())
+    output_ta.resize(m_sets.size());
+  process_flush(until, [&](std::size_t set, const TriggerActivity& ta) { output_ta[set].push_back(ta); });
+}
+
+template<class Emit>
+void
+TriggerActivityMakerHorizontalMuonMulti::process(const TriggerPrimitive& input_tp, Emit&& emit)
+{
+  if (m_print_tp_info) {
+    TLOG_DEBUG(TLVL_DEBUG_ALL) << "[TAM:HMM] TP Start Time: " << input_tp.time_start
+                               << ", TP ADC Sum: " << input_tp.adc_integral
+                               << ", TP TOT: " << input_tp.time_over_threshold << ", TP ADC Peak: " << input_tp.adc_peak
+                               << ", TP Offline Channel ID: " << input_tp.channel << ", windows: " << m_windows.size();
+  }
+
+  // Each window goes through HorizontalMuon's steps once, and each of its sets
+  // decides on the outcome.
+  for (SharedWindow& shared : m_windows) {
+    TPWindow& window = shared.window;
+
+    // 0) First TP, or the first since a flush.
+    if (window.is_empty()) {
+      window.reset(input_tp);
+      shared.changed = true;
+      continue;
+    }
+
+    if ((input_tp.time_start - window.time_start) < m_window_length) {
+      window.add(input_tp);
+      continue;
+    }
+
+    // The window is complete: check the triggers of each set on it.
+    m_emitting.clear();
+    m_dropping.clear();
+    m_moving.clear();
+    bool have_adjacency = false;
+    uint16_t window_adjacency = 0;
+    for (std::size_t set_index : shared.sets) {
+      ParameterSet& set = m_sets[set_index];
+      bool triggered = false;
+      bool prescaled = true;
+      if (window.adc_integral > set.adc_threshold && set.trigger_on_adc) {
+        triggered = true;
+      } else if (window.n_channels_hit() > set.n_channels_threshold && set.trigger_on_n_channels) {
+        triggered = true;
+      } else if (set.trigger_on_adjacency) {
+        if (!have_adjacency) {
+          window_adjacency = adjacency(window);
+          have_adjacency = true;
+        }
+        if (window_adjacency > set.adjacency_threshold) {
+          triggered = true;
+          if (static_cast<uint16_t>(set.ta_count + 1) % set.prescale == 0 && window_adjacency > set.max_adjacency)
+            set.max_adjacency = window_adjacency;
+        }
+      }
+      if (!triggered && set.trigger_on_tot && input_tp.time_over_threshold > set.tot_threshold) {
+        triggered = true;
+        prescaled = false;
+      }
+
+      if (!triggered) {
+        m_moving.push_back(set_index);
+      } else if (!prescaled || ++set.ta_count % set.prescale == 0) {
+        m_emitting.push_back(set_index);
+      } else {
+        m_dropping.push_back(set_index);
+      }
+    }
+
+    if (!m_emitting.empty()) {
+      TriggerActivity ta = TriggerActivityMakerHorizontalMuon::construct_ta(window);
+      for (std::size_t set_index : m_emitting) {
+        TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:HMM] Parameter set " << set_index << " emitting a TA with ADC integral "
+                                      << window.adc_integral << ", multiplicity " << window.n_channels_hit()
+                                      << " and adjacency " << window_adjacency;
+        emit(set_index, ta);
+      }
+    }
+
+    // The sets that triggered start a window with this TP; those whose
+    // trigger was prescaled away keep the window as it is, without this TP;
+    // the others slide it on.
+    if (!m_moving.empty()) {
+      if (!m_dropping.empty())
+        split(window, m_dropping, false);
+      if (!m_emitting.empty()) {
+        split(TPWindow(), m_emitting, true);
+        m_new_windows.back().window.reset(input_tp);
+      }
+      shared.sets.swap(m_moving);
+      window.move(input_tp, m_window_length);
+      shared.changed = true;
+    } else if (!m_dropping.empty()) {
+      if (!m_emitting.empty()) {
+        split(TPWindow(), m_emitting, true);
+        m_new_windows.back().window.reset(input_tp);
+      }
+      shared.sets.swap(m_dropping);
+    } else {
+      window.reset(input_tp);
+      shared.changed = true;
+    }
+  }
+
+  merge_windows();
+}
+
+template<class Emit>
+void
+TriggerActivityMakerHorizontalMuonMulti::process_flush(timestamp_t until, Emit&& emit)
+{
+  // As TriggerActivityMakerHorizontalMuon::flush(), for each set.
+  for (SharedWindow& shared : m_windows) {
+    TPWindow& window = shared.window;
+    if (!window.is_complete(until, m_window_length))
+      continue;
+
+    m_emitting.clear();
+    m_moving.clear();
+    bool have_adjacency = false;
+    uint16_t window_adjacency = 0;
+    for (std::size_t set_index : shared.sets) {
+      ParameterSet& set = m_sets[set_index];
+      uint16_t set_adjacency = 0;
+      bool triggered = (window.adc_integral > set.adc_threshold && set.trigger_on_adc) ||
+                       (window.n_channels_hit() > set.n_channels_threshold && set.trigger_on_n_channels);
+      if (!triggered && set.trigger_on_adjacency) {
+        if (!have_adjacency) {
+          window_adjacency = adjacency(window);
+          have_adjacency = true;
+        }
+        set_adjacency = window_adjacency;
+        triggered = set_adjacency > set.adjacency_threshold;
+      }
+
+      // If the prescale would drop this TA, leave the decision (and the count) to the TP.
+      if (!triggered || static_cast<uint16_t>(set.ta_count + 1) % set.prescale != 0) {
+        m_moving.push_back(set_index);
+        continue;
+      }
+      set.ta_count++;
+      if (set_adjacency > set.max_adjacency)
+        set.max_adjacency = set_adjacency;
+      m_emitting.push_back(set_index);
+    }
+    if (m_emitting.empty())
+      continue;
+
+    TriggerActivity ta = TriggerActivityMakerHorizontalMuon::construct_ta(window);
+    for (std::size_t set_index : m_emitting) {
+      TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:HMM] Parameter set " << set_index << " emitting a TA on flush up to "
+                                    << until;
+      emit(set_index, ta);
+    }
+
+    // The next TP starts a fresh window for the sets that triggered.
+    if (m_moving.empty()) {
+      window.clear();
+      shared.changed = true;
+    } else {
+      split(TPWindow(), m_emitting, true);
+      shared.sets.swap(m_moving);
+    }
+  }
+
+  merge_windows();
+}
+
+void
+TriggerActivityMakerHorizontalMuonMulti::split(const TPWindow& window,
+                                               const std::vector<std::size_t>& sets,
+                                               bool changed)
+{
+  SharedWindow& shared = m_new_windows.emplace_back();
+  shared.window = window;
+  shared.sets = sets;
+  shared.changed = changed;
+}
+
+void
+TriggerActivityMakerHorizontalMuonMulti::merge_windows()
+{
+  for (SharedWindow& shared : m_new_windows)
+    m_windows.push_back(std::move(shared));
+  m_new_windows.clear();
+
+  // Windows that neither slid on nor restarted were already different from
+  // each other, and all took the same TP.
+  for (std::size_t i = 0; i < m_windows.size(); ++i) {
+    for (std::size_t j = i + 1; j < m_windows.size();) {
+      SharedWindow& a = m_windows[i];
+      SharedWindow& b = m_windows[j];
+      if ((a.changed || b.changed) && same_tps(a.window, b.window)) {
+        a.sets.insert(a.sets.end(), b.sets.begin(), b.sets.end());
+        a.changed = true;
+        m_windows.erase(m_windows.begin() + j);
+      } else {
+        ++j;
+      }
+    }
+  }
+  for (SharedWindow& shared : m_windows)
+    shared.changed = false;
+}
+
+bool
+TriggerActivityMakerHorizontalMuonMulti::same_tps(const TPWindow& a, const TPWindow& b)
+{
+  if (a.size() != b.size() || a.adc_integral != b.adc_integral || a.n_channels_hit() != b.n_channels_hit())
+    return false;
+  for (std::size_t i = 0; i < a.size(); ++i) {
+    const TriggerPrimitive& x = a.at(i);
+    const TriggerPrimitive& y = b.at(i);
+    if (x.time_start != y.time_start || x.channel != y.channel || x.adc_integral != y.adc_integral ||
+        x.time_over_threshold != y.time_over_threshold || x.time_peak != y.time_peak || x.adc_peak != y.adc_peak ||
+        x.detid != y.detid || x.type != y.type || x.algorithm != y.algorithm || x.flag != y.flag ||
+        x.version != y.version)
+      return false;
+  }
+  return true;
+}
+
+std::size_t
+TriggerActivityMakerHorizontalMuonMulti::window_occupancy() const
+{
+  std::size_t n_tps = 0;
+  for (const SharedWindow& shared : m_windows)
+    n_tps += shared.window.size();
+  return n_tps;
+}
+
+TriggerActivityMakerHorizontalMuonMulti::ParameterSet
+TriggerActivityMakerHorizontalMuonMulti::parse_parameter_set(const nlohmann::json& config,
+                                                             const ParameterSet& defaults)
+{
+  ParameterSet set = defaults;
+  if (config.contains("trigger_on_adc"))
+    set.trigger_on_adc = config["trigger_on_adc"];
+  if (config.contains("trigger_on_n_channels"))
+    set.trigger_on_n_channels = config["trigger_on_n_channels"];
+  if (config.contains("adc_threshold"))
+    set.adc_threshold = config["adc_threshold"];
+  if (config.contains("n_channels_threshold"))
+    set.n_channels_threshold = config["n_channels_threshold"];
+  if (config.contains("trigger_on_adjacency"))
+    set.trigger_on_adjacency = config["trigger_on_adjacency"];
+  if (config.contains("adjacency_threshold"))
+    set.adjacency_threshold = config["adjacency_threshold"];
+  if (config.contains("prescale"))
+    set.prescale = config["prescale"];
+  if (config.contains("trigger_on_tot"))
+    set.trigger_on_tot = config["trigger_on_tot"];
+  if (config.contains("tot_threshold"))
+    set.tot_threshold = config["tot_threshold"];
+  if (set.prescale == 0)
+    throw BadConfiguration(ERS_HERE, TRACE_NAME);
+  return set;
+}
+
+void
+TriggerActivityMakerHorizontalMuonMulti::configure(const nlohmann::json& config)
+{
+  ParameterSet defaults;
+  m_sets.clear();
+  if (config.is_object()) {
+    if (config.contains("window_length"))
+      m_window_length = config["window_length"];
+    if (config.contains("adj_tolerance"))
+      m_adj_tolerance = config["adj_tolerance"];
+    if (config.contains("print_tp_info"))
+      m_print_tp_info = config["print_tp_info"];
+
+    defaults = parse_parameter_set(config, defaults);
+    if (config.contains("parameter_sets")) {
+      if (!config["parameter_sets"].is_array() || config["parameter_sets"].empty())
+        throw BadConfiguration(ERS_HERE, TRACE_NAME);
+      for (const nlohmann::json& set_config : config["parameter_sets"])
+        m_sets.push_back(parse_parameter_set(set_config, defaults));
+    }
+  }
+  if (m_sets.empty())
+    m_sets.push_back(defaults);
+
+  // All of the sets start with the same, empty, window.
+  m_windows.clear();
+  SharedWindow& shared = m_windows.emplace_back();
+  for (std::size_t i = 0; i < m_sets.size(); ++i)
+    shared.sets.push_back(i);
+
+  TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:HMM] Configured " << m_sets.size() << " parameter sets";
+}
+
+// Register algo in TA Factory
+REGISTER_TRIGGER_ACTIVITY_MAKER(TRACE_NAME, TriggerActivityMakerHorizontalMuonMulti)
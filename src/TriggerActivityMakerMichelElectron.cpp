@@ -24,6 +24,7 @@ TriggerActivityMakerMichelElectron::operator()(const TriggerPrimitive& input_tp,
   // The first time operator() is called, reset the window object.
   if (m_current_window.is_empty()) {
     m_current_window.reset(input_tp);
+    window_changed();
     m_primitive_count++;
     return;
   }
@@ -32,36 +33,43 @@ TriggerActivityMakerMichelElectron::operator()(const TriggerPrimitive& input_tp,
   // is less than the specified window size, add the TP to the window.
   if ((input_tp.time_start - m_current_window.time_start) < m_window_length) {
     m_current_window.add(input_tp);
+    window_changed();
   }
 
   // Check Michel Candidate ========================================================
   // We've filled the window, now require a sufficient length track AND that the track
-  // has a potential Bragg P, and then a kink.
-  else if (longest_activity().size() > m_adjacency_threshold) {
-     
-     
+  // has a potential Bragg P, and then a kink. A track that fails the checks holds the
+  // window as it is, so they are not run again until it changes.
+  else if (track_size() > m_adjacency_threshold) {
+
      // We have a good length acitivity, now search for Bragg peak and kinks
-     std::vector<TriggerPrimitive> trackHits = longest_activity();
-     
-     if (check_bragg_peak(trackHits)){
-       if (check_kinks(trackHits)){
-         TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:ME] Emitting a trigger for candidate Michel event.";
-         output_ta.push_back(construct_ta());
-         m_current_window.reset(input_tp);
-       } // Kinks 
-     } // Bragg peak
+     if (track_is_michel()) {
+       TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:ME] Emitting a trigger for candidate Michel event.";
+       output_ta.push_back(construct_ta());
+       m_current_window.reset(input_tp);
+       window_changed();
+     }
 
   }
 
   // Otherwise, slide the window along using the current TP.
   else {
     m_current_window.move(input_tp, m_window_length);
+    window_changed();
   }
 
   m_primitive_count++;
   return;
 }
 
+void
+TriggerActivityMakerMichelElectron::operator()(Span<const TriggerPrimitive> input_tps,
+                                               std::vector<TriggerActivity>& output_ta)
+{
+  for (const TriggerPrimitive& input_tp : input_tps)
+    TriggerActivityMakerMichelElectron::operator()(input_tp, output_ta);
+}
+
 void
 TriggerActivityMakerMichelElectron::configure(const nlohmann::json& config)
 {
@@ -91,7 +99,7 @@ TriggerActivity
 TriggerActivityMakerMichelElectron::construct_ta() const
 {
 
-  TriggerPrimitive latest_tp_in_window = m_current_window.inputs.back();
+  const TriggerPrimitive& latest_tp_in_window = m_current_window.back();
 
   TriggerActivity ta;
   ta.time_start = m_current_window.time_start;
@@ -106,11 +114,77 @@ TriggerActivityMakerMichelElectron::construct_ta() const
   ta.detid = latest_tp_in_window.detid;
   ta.type = TriggerActivity::Type::kTPC;
   ta.algorithm = TriggerActivity::Algorithm::kMichelElectron;
-  ta.inputs = m_current_window.inputs;
+  ta.inputs = m_current_window.inputs();
 
   return ta;
 }
 
+std::size_t
+TriggerActivityMakerMichelElectron::track_size()
+{
+  if (m_track_valid)
+    return m_track_size;
+  m_track_valid = true;
+  m_track_checked = false;
+
+  // longest_activity() takes channel IDs as unsigned: leave any window with
+  // negative ones to it.
+  const ChannelOccupancy& occupancy = m_current_window.channel_occupancy();
+  if (occupancy.lowest_hit_channel() < 0) {
+    m_track_hits = longest_activity();
+    m_track_gathered = true;
+    m_track_size = m_track_hits.size();
+    return m_track_size;
+  }
+
+  // The longest activity is every TP on the channels of the first longest
+  // adjacent run, which the window keeps track of as TPs come and go. Except
+  // that longest_activity() only takes one TP on channel 0: the first alone,
+  // or the last at the start of a longer run.
+  m_track_run = occupancy.longest_adjacent_span(5, m_adj_tolerance);
+  m_track_gathered = false;
+  m_track_size = 0;
+  if (m_track_run.length != 0) {
+    m_track_size = occupancy.hit_count(m_track_run.first_channel, m_track_run.last_channel);
+    if (m_track_run.first_channel == 0)
+      m_track_size -= occupancy.hit_count(0, 0) - 1;
+  }
+  return m_track_size;
+}
+
+bool
+TriggerActivityMakerMichelElectron::track_is_michel()
+{
+  track_size();
+  if (m_track_checked)
+    return m_track_is_michel;
+
+  if (!m_track_gathered) {
+    // In order of channel, and of arrival on each channel, as longest_activity() has them.
+    // Of the TPs on channel 0, only the one track_size() counted.
+    m_track_hits.clear();
+    std::size_t channel_0_hits = m_current_window.channel_occupancy().hit_count(0, 0);
+    std::size_t channel_0_taken = m_track_run.last_channel == 0 ? 1 : channel_0_hits;
+    std::size_t n_on_channel_0 = 0;
+    for (std::size_t i = 0; i < m_current_window.size(); ++i) {
+      const TriggerPrimitive& tp = m_current_window.at(i);
+      if (tp.channel < m_track_run.first_channel || tp.channel > m_track_run.last_channel)
+        continue;
+      if (tp.channel == 0 && ++n_on_channel_0 != channel_0_taken)
+        continue;
+      m_track_hits.push_back(tp);
+    }
+    std::stable_sort(m_track_hits.begin(),
+                     m_track_hits.end(),
+                     [](const TriggerPrimitive& a, const TriggerPrimitive& b) { return a.channel < b.channel; });
+    m_track_gathered = true;
+  }
+
+  m_track_is_michel = m_track_checks.has_bragg_peak(m_track_hits) && m_track_checks.has_kinks(m_track_hits);
+  m_track_checked = true;
+  return m_track_is_michel;
+}
+
 std::vector<TriggerPrimitive>
 TriggerActivityMakerMichelElectron::longest_activity() const
 {
@@ -127,13 +201,11 @@ TriggerActivityMakerMichelElectron::longest_activity() const
   unsigned int next = 0;         // The next position in the hit channels vector
   unsigned int tol_count = 0;    // Tolerance count, should not pass adj_tolerance
 
-  // Generate a channelID ordered list of hit channels for this window
-  std::vector<TriggerPrimitive> hitList;
-  for (auto tp : m_current_window.inputs) {
-    hitList.push_back(tp);
-  }
-  std::sort(hitList.begin(), hitList.end(), [](TriggerPrimitive a, TriggerPrimitive b)
-            { return a.channel < b.channel; });
+  // Generate a channelID ordered list of hit channels for this window, keeping the
+  // hits on each channel in the order they came
+  std::vector<TriggerPrimitive> hitList = m_current_window.inputs();
+  std::stable_sort(hitList.begin(), hitList.end(), [](const TriggerPrimitive& a, const TriggerPrimitive& b)
+                   { return a.channel < b.channel; });
 
   // ADAJACENCY LOGIC ====================================================================
   // =====================================================================================
@@ -191,125 +263,13 @@ TriggerActivityMakerMichelElectron::longest_activity() const
   return finalHits;
 }
 
-
-// Function that tries to identify a Bragg peak via a running
-// mean average of the ADC values. We use the running mean as it's less susceptible to
-// spikes of activity that might trick the algorithm. We establish a baseline, then
-// count up clusters of charge deposition above that baseline. If the largest is at
-// one of the ends of that collection, signal a potential Bragg peak.
-bool
-TriggerActivityMakerMichelElectron::check_bragg_peak(std::vector<TriggerPrimitive> trackHits)
-{
-  bool bragg = false; 
-  std::vector<float> adc_means_list;
-  uint16_t convolve_value = 6;
-
-  // Loop over hits that correspond to high adjacency activity
-  for (uint16_t i = 0; i < trackHits.size(); ++i){
-    float adc_sum = 0;
-    float adc_mean = 0;
-
-    // Calculate running ADC mean of this track 
-    for (uint16_t j = i; j < i+convolve_value; ++j){
-       int hit = (j) % trackHits.size(); 
-       adc_sum += trackHits.at(hit).adc_integral;
-    }
-
-    adc_mean = adc_sum / convolve_value;
-    adc_means_list.push_back(adc_mean);
-    adc_sum = 0;
-  } 
-
-  // We now have a list of convolved adc means. 
-  float ped = std::accumulate(adc_means_list.begin(), adc_means_list.end(), 0.0) / adc_means_list.size();
-  float charge = 0;
-  std::vector<float> charge_dumps;
-
-  // Now go through the list, picking up clusters of charge above the baseline/ped
-  for (auto a : adc_means_list){
-    if (a > ped){
-       charge += a;
-    }
-    else if( a < ped && charge !=0 ){
-     charge_dumps.push_back(charge);
-     charge = 0; 
-    } 
-  } 
-
-  // If the maximum of that list of charge dumps is near(at?) either end of it
-  float max_charge = *max_element(charge_dumps.begin(), charge_dumps.end()); 
-  if(max_charge == charge_dumps.front() || max_charge == charge_dumps.back()){ bragg=true; }
-
-  return bragg;
- }
-
-bool
-TriggerActivityMakerMichelElectron::check_kinks(std::vector<TriggerPrimitive> finalHits)
-{
-    bool kinks = false;  // We actually required two kinks in the coldbox, the michel kink and the wes kink
-    std::vector<float> runningGradient;
-    std::vector<float> runningMeanGradient;
-
-    // Choice to be made here. Do we want to scane in collection (z) or time (x) direction when calculating gradient between hits. I
-    // would say if we have already made the request to pass a track of length specific threshold which is longer than the drift
-    // direction for the coldbox, it makes sense to scan across channels a little more.
-    std::sort(finalHits.begin(), finalHits.end(), [](TriggerPrimitive a, TriggerPrimitive b) { return a.channel < b.channel; });
-
-    // Populate the runningGradient with the track hits. Do this between ith and i+kth TPs, to small scale fluctuations of the track
-    // Yet k should be kept small, so that enough gradient information is preserved at the end of the track to identify kinks
-    for (int i=0 ; i < finalHits.size()-2; i++){
-   
-      // Skip same channel hits or if the start times are the same - no div by zero! 
-      if (finalHits.at(i+2).channel == finalHits.at(i).channel || (finalHits.at(i+2).time_start == finalHits.at(i).time_start) ) { continue; }
-
-      // Check that the next TP is closeby; enough in space and time directions so as to avoid obtaining a gradient value from
-      // same channel hits at large time difference or vice versa due to kink topology or showers. Clearly we shouldn't be very far in 
-      // channel number, but since we might later try to do this check in the time direction, leave the condition in.
-      int diff = finalHits.at(i+2).time_start - finalHits.at(i).time_start;
-      if((std::abs(diff) > 1000) || ((std::abs(finalHits.at(i+2).channel - finalHits.at(i).channel) > 6))) { continue; } 
-
-      // Gradient is just change in z (collection) over change in x (drift). x is admitedly roughly converted from
-      // hit start time, but I don't think diffusion effects are a huge concern over 20cm. Using mm for readability/visualisation 
-      float dz = (finalHits.at(i+2).channel - finalHits.at(i).channel)*4.67; // Change in collection wire z to separation in mm
-      long long int dt = finalHits.at(i+2).time_start - finalHits.at(i).time_start;
-      float dx = dt*0.028; // Change time to separation in x mm
-      float g = dz/dx;
-
-      runningGradient.push_back(g); 
-    }
- 
-    // Require a decent length of the gradients vector. Otherwise some adjacent events are showers and the conditions above mean
-    // we don't get enough entries. In essence, this provides some confidence that it's track-like rather than shower-like. Which
-    // is what we want for a Michel event.
-    if ( runningGradient.size() > 10 ){
-      
-      // Now lets take a running mean of the gradients between TPs, less susceptible to wild changes due to deltas/etc
-      for(int g=0 ; g < runningGradient.size()-1 ; g++){
-        float gsum = runningGradient.at(g) + runningGradient.at(g+1);
-        runningMeanGradient.push_back(gsum/2);
-      } 
-   
-      // We have a list of gradients, now just demand that the two ends have gradients that differ significantly
-      // from the mean gradient of the activity at both ends. This aims to pick out wesKinks and michelKinks
-      if(runningMeanGradient.size() > 10 ){
-
-        float mean = (std::abs(std::accumulate(runningMeanGradient.begin(), runningMeanGradient.end(), 0.0)))/(runningMeanGradient.size());
-
-        // If you're testing on simulation or december data, you won't see the wes kink, so use an || instead of &&
-        if((std::abs(runningMeanGradient.front()) + mean > 2.5*mean)  ||  ((std::abs(runningMeanGradient.back() + mean)) > 2.5*mean)){ kinks=true; }   
-      } 
-    } 
-
-  return kinks;
-}
-
 // ===============================================================================================
 // ===============================================================================================
 // Functions below this line are for debugging purposes.
 // ===============================================================================================
 
 void
-TriggerActivityMakerMichelElectron::add_window_to_record(Window window)
+TriggerActivityMakerMichelElectron::add_window_to_record(const TPWindow& window)
 {
   m_window_record.push_back(window);
   return;
@@ -324,15 +284,15 @@ TriggerActivityMakerMichelElectron::dump_window_record()
   std::ofstream outfile;
   outfile.open("window_record_tam.csv", std::ios_base::app);
 
-  for (auto window : m_window_record) {
+  for (const auto& window : m_window_record) {
     outfile << window.time_start << ",";
-    outfile << window.inputs.back().time_start << ",";
-    outfile << window.inputs.back().time_start - window.time_start << ","; // window_length - from TP start times
+    outfile << window.back().time_start << ",";
+    outfile << window.back().time_start - window.time_start << ","; // window_length - from TP start times
     outfile << window.adc_integral << ",";
     outfile << window.n_channels_hit() << ",";       // Number of unique channels with hits
-    outfile << window.inputs.size() << ",";          // Number of TPs in Window
-    outfile << window.inputs.back().channel << ",";  // Last TP Channel ID
-    outfile << window.inputs.front().channel << ","; // First TP Channel ID
+    outfile << window.size() << ",";                 // Number of TPs in Window
+    outfile << window.back().channel << ",";         // Last TP Channel ID
+    outfile << window.front().channel << ",";        // First TP Channel ID
     outfile << longest_activity().size() << std::endl;             // New adjacency value for the window
   }
 
@@ -364,28 +324,22 @@ TriggerActivityMakerMichelElectron::dump_tp(TriggerPrimitive const& input_tp)
   return;
 }
 
-/*
 void
-TriggerActivityMakerMichelElectron::flush(timestamp_t, std::vector<TriggerActivity>& output_ta)
+TriggerActivityMakerMichelElectron::flush(timestamp_t until, std::vector<TriggerActivity>& output_ta)
 {
-  // Check the status of the current window, construct TA if conditions are met. Regardless
-  // of whether the conditions are met, reset the window.
-  if(m_current_window.adc_integral > m_adc_threshold && m_trigger_on_adc){
-  //else if(m_current_window.adc_integral > m_conf.adc_threshold && m_conf.trigger_on_adc){
-    //TLOG_DEBUG(TRACE_NAME) << "ADC integral in window is greater than specified threshold.";
-    output_ta.push_back(construct_ta());
-  }
-  else if(m_current_window.n_channels_hit() > m_n_channels_threshold && m_trigger_on_n_channels){
-  //else if(m_current_window.n_channels_hit() > m_conf.n_channels_threshold && m_conf.trigger_on_n_channels){
-    //TLOG_DEBUG(TRACE_NAME) << "Number of channels hit in the window is greater than specified threshold.";
+  // No TP from `until` on can be added to a complete window: check it for a Michel
+  // candidate now, as the next TP would, rather than hold it until that TP arrives.
+  if (!m_current_window.is_complete(until, m_window_length))
+    return;
+
+  if (track_size() > m_adjacency_threshold && track_is_michel()) {
+    TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:ME] Emitting a trigger for candidate Michel event on flush up to " << until << ".";
     output_ta.push_back(construct_ta());
+    // The next TP starts a fresh window.
+    m_current_window.clear();
+    window_changed();
   }
-
-  //TLOG_DEBUG(TRACE_NAME) << "Clearing the current window, on the arrival of the next input_tp, the window will be
-reset."; m_current_window.clear();
-
-  return;
-}*/
+}
 
 // Register algo in TA Factory
 REGISTER_TRIGGER_ACTIVITY_MAKER(TRACE_NAME, TriggerActivityMakerMichelElectron)
@@ -59,24 +59,11 @@ TriggerActivityMakerPlaneCoincidence::operator()(const TriggerPrimitive& input_t
   bool collectionComplete = (input_tp.time_start - m_collection_window.time_start) > m_window_length;
   // Then require that the collection window be complete in the adjacency checks
   if (!collectionComplete) { } // Do nothing
-  else if (collectionComplete && (m_induction1_window.adc_integral + m_induction2_window.adc_integral + m_collection_window.adc_integral)
-            > m_adc_threshold && check_adjacency(m_collection_window) >= m_adjacency_threshold){
-
-          TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:PC] Emitting low energy trigger with " << m_induction1_window.adc_integral << " U "
-                  << m_induction2_window.adc_integral << " Y induction ADC sums and "
-                  << check_adjacency(m_collection_window) << " adjacent collection hits.";
-   
-          // Initial studies - output the TPs of the collection plane window that caused this trigger
-          add_window_to_record(m_collection_window);
-          dump_window_record();
-          m_window_record.clear();     
-
-          // Initial studies - Also dump the TPs that have contributed to this TA decision
-          for(auto tp : m_collection_window.inputs) dump_tp(tp);
- 
-          // We have fulfilled our trigger condition, construct a TA and reset/flush the windows
+  else if (collectionComplete && passes_trigger()) {
+          emit_ta(output_ta);
+
+          // We have fulfilled our trigger condition, reset/flush the windows
           // to ensure they're all in the same "time zone"!
-          output_ta.push_back(construct_ta(m_collection_window));
           if (isZ) m_collection_window.reset(input_tp);
           else m_collection_window.clear();
           if (isU) m_induction1_window.reset(input_tp); 
@@ -96,6 +83,30 @@ TriggerActivityMakerPlaneCoincidence::operator()(const TriggerPrimitive& input_t
   return;
 }
 
+void
+TriggerActivityMakerPlaneCoincidence::operator()(Span<const TriggerPrimitive> input_tps,
+                                                 std::vector<TriggerActivity>& output_ta)
+{
+  for (const TriggerPrimitive& input_tp : input_tps)
+    TriggerActivityMakerPlaneCoincidence::operator()(input_tp, output_ta);
+}
+
+void
+TriggerActivityMakerPlaneCoincidence::flush(timestamp_t until, std::vector<TriggerActivity>& output_ta)
+{
+  // Any TP from `until` on finds the collection window complete. If the windows
+  // pass the trigger already, without that TP, emit now rather than wait for it.
+  if (m_collection_window.is_empty() || until < m_collection_window.time_start ||
+      until - m_collection_window.time_start <= m_window_length || !passes_trigger())
+    return;
+
+  emit_ta(output_ta);
+  // The next TP on each plane starts a fresh window.
+  m_collection_window.clear();
+  m_induction1_window.clear();
+  m_induction2_window.clear();
+}
+
 void
 TriggerActivityMakerPlaneCoincidence::configure(const nlohmann::json& config)
 {
@@ -116,15 +127,17 @@ TriggerActivityMakerPlaneCoincidence::configure(const nlohmann::json& config)
       m_adj_tolerance = config["adj_tolerance"];
     if (config.contains("adjacency_threshold"))
       m_adjacency_threshold = config["adjacency_threshold"];
+    if (config.contains("dump_triggering_tps"))
+      m_dump_triggering_tps = config["dump_triggering_tps"];
   }
 
 }
 
 TriggerActivity
-TriggerActivityMakerPlaneCoincidence::construct_ta(TPWindow m_current_window) const
+TriggerActivityMakerPlaneCoincidence::construct_ta(const TPWindow& m_current_window) const
 {
 
-  TriggerPrimitive latest_tp_in_window = m_current_window.inputs.back();
+  const TriggerPrimitive& latest_tp_in_window = m_current_window.back();
 
   TriggerActivity ta;
   ta.time_start = m_current_window.time_start;
@@ -139,75 +152,56 @@ TriggerActivityMakerPlaneCoincidence::construct_ta(TPWindow m_current_window) co
   ta.detid = latest_tp_in_window.detid;
   ta.type = TriggerActivity::Type::kTPC;
   ta.algorithm = TriggerActivity::Algorithm::kPlaneCoincidence;
-  ta.inputs = m_current_window.inputs;
+  ta.inputs = m_current_window.inputs();
 
   return ta;
 }
 
+bool
+TriggerActivityMakerPlaneCoincidence::passes_trigger() const
+{
+  // A localised spike of ADC across the planes, with a short track on the collection plane.
+  return (m_induction1_window.adc_integral + m_induction2_window.adc_integral + m_collection_window.adc_integral) >
+           m_adc_threshold &&
+         check_adjacency(m_collection_window) >= m_adjacency_threshold;
+}
+
+void
+TriggerActivityMakerPlaneCoincidence::emit_ta(std::vector<TriggerActivity>& output_ta)
+{
+  TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:PC] Emitting low energy trigger with " << m_induction1_window.adc_integral << " U "
+          << m_induction2_window.adc_integral << " Y induction ADC sums and "
+          << check_adjacency(m_collection_window) << " adjacent collection hits.";
+
+  if (m_dump_triggering_tps) {
+    // Initial studies - output the TPs of the collection plane window that caused this trigger
+    add_window_to_record(m_collection_window);
+    dump_window_record();
+    m_window_record.clear();
+
+    // Initial studies - Also dump the TPs that have contributed to this TA decision
+    for (size_t i = 0; i < m_collection_window.size(); ++i) dump_tp(m_collection_window.at(i));
+  }
+
+  output_ta.push_back(construct_ta(m_collection_window));
+}
+
 uint16_t
-TriggerActivityMakerPlaneCoincidence::check_adjacency(TPWindow window) const
+TriggerActivityMakerPlaneCoincidence::check_adjacency(const TPWindow& window) const
 {
   /* This function returns the adjacency value for the current window, where adjacency
   *  is defined as the maximum number of consecutive wires containing hits. It accepts
   *  a configurable tolerance paramter, which allows up to adj_tolerance missing hits
-  *  on adjacent wires before restarting the adjacency count. */
-
-  uint16_t adj = 1;              // Initialise adjacency, 1 for the first wire.
-  uint16_t max = 0;              // Maximum adjacency of window, which this function returns
-  unsigned int channel = 0;      // Current channel ID
-  unsigned int next_channel = 0; // Next channel ID
-  unsigned int next = 0;         // The next position in the hit channels vector
-  unsigned int tol_count = 0;    // Tolerance count, should not pass adj_tolerance
-
-  /* Generate a channelID ordered list of hit channels for this window */
-  std::vector<int> chanList;
-  for (auto tp : window.inputs) {
-    chanList.push_back(tp.channel);
-  }
-  std::sort(chanList.begin(), chanList.end());
-
-  /* ADAJACENCY LOGIC ====================================================================
-  *  Adjcancency Tolerance = Number of times prepared to skip missed hits before resetting 
-  *  the adjacency count. This accounts for things like dead channels / missed TPs. */
-  for (size_t i = 0; i < chanList.size(); ++i) {
-
-    next = (i + 1) % chanList.size(); // Loops back when outside of channel list range
-    channel = chanList.at(i);
-    next_channel = chanList.at(next); // Next channel with a hit
-
-    // End of vector condition.
-    if (next_channel == 0) { next_channel = channel - 1; }
-
-    // Skip same channel hits.
-    if (next_channel == channel) { continue; }
-
-    // If next hit is on next channel, increment the adjacency count.
-    else if (next_channel == channel + 1){ ++adj; }
-
-    // If next channel is not on the next hit, but the 'second next', increase adjacency 
-    // but also tally up with the tolerance counter.
-    else if ((next_channel == channel + 2 || next_channel == channel + 3) && (tol_count < m_adj_tolerance)) { 
-	++adj;
-        for (size_t i = 0 ; i < next_channel-channel ; ++i) ++tol_count;
-    }
-
-    // If next hit isn't within reach, end the adjacency count and check for a new max.
-    // Reset variables for next iteration.
-    else {
-      if (adj > max) { max = adj; } 
-      adj = 1;
-      tol_count = 0;
-    }
-  }
-
-  return max;
+  *  on adjacent wires before restarting the adjacency count. A hit up to 3 channels
+  *  along can still be bridged. */
+  return window.longest_adjacent_run(3, m_adj_tolerance);
 }
 
 // =====================================================================================
 // Functions below this line are for debugging and performance study purposes.
 // =====================================================================================
 void
-TriggerActivityMakerPlaneCoincidence::add_window_to_record(TPWindow window)
+TriggerActivityMakerPlaneCoincidence::add_window_to_record(const TPWindow& window)
 {
   m_window_record.push_back(window);
   return;
@@ -220,17 +214,17 @@ TriggerActivityMakerPlaneCoincidence::dump_window_record()
   std::ofstream outfile;
   outfile.open("window_record_tam.csv", std::ios_base::app);
 
-  for (auto window : m_window_record) {
+  for (const auto& window : m_window_record) {
     outfile << window.time_start << ",";
-    outfile << window.inputs.back().time_start << ",";
-    outfile << window.inputs.back().time_start - window.time_start << ",";
+    outfile << window.back().time_start << ",";
+    outfile << window.back().time_start - window.time_start << ",";
     outfile << window.adc_integral << ",";
     outfile << window.n_channels_hit() << ",";             // Number of unique channels with hits
-    outfile << window.inputs.size() << ",";                // Number of TPs in TPWindow
-    outfile << window.inputs.back().channel << ",";        // Last TP Channel ID
-    outfile << window.inputs.back().time_start << ",";     // Last TP start time
-    outfile << window.inputs.front().channel << ",";       // First TP Channel ID
-    outfile << window.inputs.front().time_start << ",";    // First TP start time 
+    outfile << window.size() << ",";                       // Number of TPs in TPWindow
+    outfile << window.back().channel << ",";               // Last TP Channel ID
+    outfile << window.back().time_start << ",";            // Last TP start time
+    outfile << window.front().channel << ",";              // First TP Channel ID
+    outfile << window.front().time_start << ",";           // First TP start time 
     outfile << check_adjacency(window) << ",";             // New adjacency value for the window
     outfile << check_tot(window) << std::endl;             // Summed window TOT
   }
@@ -263,13 +257,13 @@ TriggerActivityMakerPlaneCoincidence::dump_tp(TriggerPrimitive const& input_tp)
 }
 
 int
-TriggerActivityMakerPlaneCoincidence::check_tot(TPWindow m_current_window) const
+TriggerActivityMakerPlaneCoincidence::check_tot(const TPWindow& m_current_window) const
 {
   // Here, we just want to sum up all the tot values for each TP within window,
   // and return this tot of the window.
   int window_tot = 0; 
-  for (auto tp : m_current_window.inputs) {
-    window_tot += tp.time_over_threshold;
+  for (size_t i = 0; i < m_current_window.size(); ++i) {
+    window_tot += m_current_window.at(i).time_over_threshold;
   }
 
   return window_tot;
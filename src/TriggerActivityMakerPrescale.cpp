@@ -22,29 +22,41 @@ void
 TriggerActivityMakerPrescale::operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta)
 {
   if ((m_primitive_count++) % m_prescale == 0) {
-
     TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:Pr] Emitting prescaled TriggerActivity " << (m_primitive_count - 1);
-    std::vector<TriggerPrimitive> tp_list;
-    tp_list.push_back(input_tp);
-
-    TriggerActivity ta;
-    ta.time_start = input_tp.time_start;
-    ta.time_end = input_tp.time_start + input_tp.time_over_threshold;
-    ta.time_peak = input_tp.time_peak;
-    ta.time_activity = 0;
-    ta.channel_start = input_tp.channel;
-    ta.channel_end = input_tp.channel;
-    ta.channel_peak = input_tp.channel;
-    ta.adc_integral = input_tp.adc_integral;
-    ta.adc_peak = input_tp.adc_peak;
-    ta.detid = input_tp.detid;
-    ta.type = TriggerActivity::Type::kTPC;
-    ta.algorithm = TriggerActivity::Algorithm::kPrescale;
-
-    ta.inputs = tp_list;
-
-    output_ta.push_back(ta);
+    emit_ta(input_tp, output_ta);
+  }
+}
+
+void
+TriggerActivityMakerPrescale::operator()(Span<const TriggerPrimitive> input_tps, std::vector<TriggerActivity>& output_ta)
+{
+  // Jump straight to the TPs that pass the prescale rather than testing each one.
+  uint64_t first = (m_prescale - m_primitive_count % m_prescale) % m_prescale; // NOLINT(build/unsigned)
+  for (uint64_t i = first; i < input_tps.size(); i += m_prescale) { // NOLINT(build/unsigned)
+    TLOG_DEBUG(TLVL_DEBUG_MEDIUM) << "[TAM:Pr] Emitting prescaled TriggerActivity " << (m_primitive_count + i);
+    emit_ta(input_tps[i], output_ta);
   }
+  m_primitive_count += input_tps.size();
+}
+
+void
+TriggerActivityMakerPrescale::emit_ta(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta) const
+{
+  TriggerActivity& ta = output_ta.emplace_back();
+  ta.time_start = input_tp.time_start;
+  ta.time_end = input_tp.time_start + input_tp.time_over_threshold;
+  ta.time_peak = input_tp.time_peak;
+  ta.time_activity = 0;
+  ta.channel_start = input_tp.channel;
+  ta.channel_end = input_tp.channel;
+  ta.channel_peak = input_tp.channel;
+  ta.adc_integral = input_tp.adc_integral;
+  ta.adc_peak = input_tp.adc_peak;
+  ta.detid = input_tp.detid;
+  ta.type = TriggerActivity::Type::kTPC;
+  ta.algorithm = TriggerActivity::Algorithm::kPrescale;
+
+  ta.inputs.push_back(input_tp);
 }
 
 void
@@ -11,6 +11,9 @@
 #include "TRACE/trace.h"
 #define TRACE_NAME "TriggerCandidateMakerBundleNPlugin"
 
+#include <algorithm>
+#include <utility>
+
 namespace triggeralgs {
 
 using Logging::TLVL_IMPORTANT;
@@ -41,24 +44,52 @@ TriggerCandidateMakerBundleN::operator()(const TriggerActivity& input_ta, std::v
 
   if (bundle_condition()) {
     TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TC:BN] Emitting BundleN TriggerCandidate with " << m_current_tc.inputs.size() << " TAs.";
-    set_tc_attributes();
-    output_tcs.push_back(m_current_tc);
-
-    // Reset the current.
-    m_current_tc = TriggerCandidate();
+    emit_tc(output_tcs);
   }
 
   // Should never reach this step. In this case, send it out.
   if (m_current_tc.inputs.size() > m_bundle_size) {
     TLOG_DEBUG(TLVL_IMPORTANT) << "[TC:BN] Emitting large BundleN TriggerCandidate with " << m_current_tc.inputs.size() << " TAs.";
-    set_tc_attributes();
-    output_tcs.push_back(m_current_tc);
+    emit_tc(output_tcs);
+  }
+}
+
+void
+TriggerCandidateMakerBundleN::operator()(Span<const TriggerActivity> input_tas, std::vector<TriggerCandidate>& output_tcs)
+{
+  // Append whole bundles at a time instead of one TA at a time.
+  size_t next = 0;
+  while (next < input_tas.size()) {
+    size_t n_missing = m_current_tc.inputs.size() < m_bundle_size ? m_bundle_size - m_current_tc.inputs.size() : 0;
+    size_t n_take = std::min(n_missing, input_tas.size() - next);
 
-    // Reset the current.
-    m_current_tc = TriggerCandidate();
+    // Nothing fits in the current bundle (eg a bundle_size of 0): the single TA path
+    // knows how to send that out.
+    if (n_take == 0) {
+      TriggerCandidateMakerBundleN::operator()(input_tas[next++], output_tcs);
+      continue;
+    }
+
+    m_current_tc.inputs.insert(m_current_tc.inputs.end(), input_tas.begin() + next, input_tas.begin() + next + n_take);
+    next += n_take;
+
+    if (bundle_condition()) {
+      TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TC:BN] Emitting BundleN TriggerCandidate with " << m_current_tc.inputs.size() << " TAs.";
+      emit_tc(output_tcs);
+    }
   }
 }
 
+void
+TriggerCandidateMakerBundleN::emit_tc(std::vector<TriggerCandidate>& output_tcs)
+{
+  set_tc_attributes();
+  output_tcs.push_back(std::move(m_current_tc));
+
+  // Reset the current.
+  m_current_tc = TriggerCandidate();
+}
+
 void
 TriggerCandidateMakerBundleN::configure(const nlohmann::json& config)
 {
@@ -82,6 +82,22 @@ TriggerCandidateMakerChannelAdjacency::operator()(const TriggerActivity& activit
   return;
 }
 
+void
+TriggerCandidateMakerChannelAdjacency::operator()(Span<const TriggerActivity> activities,
+                                                  std::vector<TriggerCandidate>& output_tc)
+{
+  for (const TriggerActivity& activity : activities)
+    TriggerCandidateMakerChannelAdjacency::operator()(activity, output_tc);
+}
+
+void
+TriggerCandidateMakerChannelAdjacency::flush(timestamp_t until, std::vector<TriggerCandidate>&)
+{
+  // A TC is made as soon as the window passes the threshold, so a heartbeat only has to
+  // drop the TAs that no TA from `until` on can share the window with.
+  m_current_window.expire(until, m_window_length);
+}
+
 void
 TriggerCandidateMakerChannelAdjacency::configure(const nlohmann::json& config)
 {
@@ -114,7 +130,7 @@ TriggerCandidateMakerChannelAdjacency::configure(const nlohmann::json& config)
 TriggerCandidate
 TriggerCandidateMakerChannelAdjacency::construct_tc() const
 {
-  TriggerActivity latest_ta_in_window = m_current_window.inputs.back();
+  const TriggerActivity& latest_ta_in_window = m_current_window.back();
 
   TriggerCandidate tc;
   tc.time_start = m_current_window.time_start - m_readout_window_ticks_before;
@@ -128,8 +144,8 @@ TriggerCandidateMakerChannelAdjacency::construct_tc() const
   // Take the list of triggeralgs::TriggerActivity in the current
   // window and convert them (implicitly) to detdataformats'
   // TriggerActivityData, which is the base class of TriggerActivity
-  for (auto& ta : m_current_window.inputs) {
-    tc.inputs.push_back(ta);
+  for (size_t i = 0; i < m_current_window.size(); ++i) {
+    tc.inputs.push_back(m_current_window.at(i));
   }
 
   return tc;
@@ -137,7 +153,7 @@ TriggerCandidateMakerChannelAdjacency::construct_tc() const
 
 // Functions below this line are for debugging purposes.
 void
-TriggerCandidateMakerChannelAdjacency::add_window_to_record(TAWindow window)
+TriggerCandidateMakerChannelAdjacency::add_window_to_record(const TAWindow& window)
 {
   m_window_record.push_back(window);
   return;
@@ -99,6 +99,22 @@ TriggerCandidateMakerHorizontalMuon::operator()(const TriggerActivity& activity,
   return;
 }
 
+void
+TriggerCandidateMakerHorizontalMuon::operator()(Span<const TriggerActivity> activities,
+                                                std::vector<TriggerCandidate>& output_tc)
+{
+  for (const TriggerActivity& activity : activities)
+    TriggerCandidateMakerHorizontalMuon::operator()(activity, output_tc);
+}
+
+void
+TriggerCandidateMakerHorizontalMuon::flush(timestamp_t until, std::vector<TriggerCandidate>&)
+{
+  // A TC is made as soon as the window passes the threshold, so a heartbeat only has to
+  // drop the TAs that no TA from `until` on can share the window with.
+  m_current_window.expire(until, m_window_length);
+}
+
 void
 TriggerCandidateMakerHorizontalMuon::configure(const nlohmann::json& config)
 {
@@ -133,7 +149,7 @@ TriggerCandidateMakerHorizontalMuon::configure(const nlohmann::json& config)
 TriggerCandidate
 TriggerCandidateMakerHorizontalMuon::construct_tc() const
 {
-  TriggerActivity latest_ta_in_window = m_current_window.inputs.back();
+  const TriggerActivity& latest_ta_in_window = m_current_window.back();
 
   TriggerCandidate tc;
   tc.time_start = m_current_window.time_start - m_readout_window_ticks_before;
@@ -147,8 +163,8 @@ TriggerCandidateMakerHorizontalMuon::construct_tc() const
   // Take the list of triggeralgs::TriggerActivity in the current
   // window and convert them (implicitly) to detdataformats'
   // TriggerActivityData, which is the base class of TriggerActivity
-  for (auto& ta : m_current_window.inputs) {
-    tc.inputs.push_back(ta);
+  for (size_t i = 0; i < m_current_window.size(); ++i) {
+    tc.inputs.push_back(m_current_window.at(i));
   }
 
   return tc;
@@ -163,7 +179,7 @@ TriggerCandidateMakerHorizontalMuon::check_adjacency() const
 
 // Functions below this line are for debugging purposes.
 void
-TriggerCandidateMakerHorizontalMuon::add_window_to_record(TAWindow window)
+TriggerCandidateMakerHorizontalMuon::add_window_to_record(const TAWindow& window)
 {
   m_window_record.push_back(window);
   return;
@@ -176,13 +192,13 @@ TriggerCandidateMakerHorizontalMuon::dump_window_record()
   std::ofstream outfile;
   outfile.open("window_record_tcm.csv", std::ios_base::app);
 
-  for (auto window : m_window_record) {
+  for (const auto& window : m_window_record) {
     outfile << window.time_start << ",";
-    outfile << window.inputs.back().time_start << ",";
-    outfile << window.inputs.back().time_start - window.time_start << ",";
+    outfile << window.back().time_start << ",";
+    outfile << window.back().time_start - window.time_start << ",";
     outfile << window.adc_integral << ",";
     outfile << window.n_channels_hit() << ",";
-    outfile << window.inputs.size() << std::endl;
+    outfile << window.size() << std::endl;
   }
 
   outfile.close();
@@ -192,27 +208,4 @@ TriggerCandidateMakerHorizontalMuon::dump_window_record()
   return;
 }
 
-/*
-void
-TriggerCandidateMakerHorizontalMuon::flush(timestamp_t, std::vector<TriggerCandidate>& output_tc)
-{
-  // Check the status of the current window, construct TC if conditions are met. Regardless
-  // of whether the conditions are met, reset the window.
-  if(m_current_window.adc_integral > m_adc_threshold && m_trigger_on_adc){
-  //else if(m_current_window.adc_integral > m_conf.adc_threshold && m_conf.trigger_on_adc){
-    //TLOG_DEBUG(TRACE_NAME) << "ADC integral in window is greater than specified threshold.";
-    output_tc.push_back(construct_tc());
-  }
-  else if(m_current_window.n_channels_hit() > m_n_channels_threshold && m_trigger_on_n_channels){
-  //else if(m_current_window.n_channels_hit() > m_conf.n_channels_threshold && m_conf.trigger_on_n_channels){
-    //TLOG_DEBUG(TRACE_NAME) << "Number of channels hit in the window is greater than specified threshold.";
-    output_tc.push_back(construct_tc());
-  }
-
-  //TLOG_DEBUG(TRACE_NAME) << "Clearing the current window, on the arrival of the next input_tp, the window will be
-reset."; m_current_window.clear();
-
-  return;
-}*/
-
 REGISTER_TRIGGER_CANDIDATE_MAKER(TRACE_NAME, TriggerCandidateMakerHorizontalMuon)
@@ -85,7 +85,12 @@ TriggerCandidateMakerMichelElectron::operator()(const TriggerActivity& activity,
   // If it is not, move the window along.
   else {
     TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TCM:ME] Window is at required length but specified threshold not met, shifting window along.";
+    // When every TA has left the window, this maker has always kept the old
+    // window start time rather than restarting the window on the new TA.
+    timestamp_t time_start = m_current_window.time_start;
     m_current_window.move(activity, m_window_length);
+    if (m_current_window.size() == 1)
+      m_current_window.time_start = time_start;
   }
 
   //TLOG_DEBUG(TLVL_DEBUG_ALL) << "[TCM:ME] " m_current_window;
@@ -97,6 +102,34 @@ TriggerCandidateMakerMichelElectron::operator()(const TriggerActivity& activity,
   return;
 }
 
+void
+TriggerCandidateMakerMichelElectron::operator()(Span<const TriggerActivity> activities,
+                                                std::vector<TriggerCandidate>& output_tc)
+{
+  for (const TriggerActivity& activity : activities)
+    TriggerCandidateMakerMichelElectron::operator()(activity, output_tc);
+}
+
+void
+TriggerCandidateMakerMichelElectron::flush(timestamp_t until, std::vector<TriggerCandidate>& output_tc)
+{
+  // No TA from `until` on can be added to a complete window, so take the decision
+  // the next TA would take now rather than hold the window until it arrives.
+  if (!m_current_window.is_complete(until, m_window_length))
+    return;
+
+  if (m_current_window.adc_integral > m_adc_threshold && m_trigger_on_adc) {
+    TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TCM:ME] ADC integral in window is greater than specified threshold, flushing up to "
+                                << until << ".";
+    output_tc.push_back(construct_tc());
+    // The next TA starts a fresh window.
+    m_current_window.clear();
+  } else if (m_current_window.n_channels_hit() > m_n_channels_threshold && m_trigger_on_n_channels) {
+    tc_number++;
+    m_current_window.clear();
+  }
+}
+
 void
 TriggerCandidateMakerMichelElectron::configure(const nlohmann::json& config)
 {
@@ -133,7 +166,7 @@ TriggerCandidateMakerMichelElectron::configure(const nlohmann::json& config)
 TriggerCandidate
 TriggerCandidateMakerMichelElectron::construct_tc() const
 {
-  TriggerActivity latest_ta_in_window = m_current_window.inputs.back();
+  const TriggerActivity& latest_ta_in_window = m_current_window.back();
 
   TriggerCandidate tc;
   tc.time_start = m_current_window.time_start - m_readout_window_ticks_before;
@@ -147,8 +180,8 @@ TriggerCandidateMakerMichelElectron::construct_tc() const
   // Take the list of triggeralgs::TriggerActivity in the current
   // window and convert them (implicitly) to detdataformats'
   // TriggerActivityData, which is the base class of TriggerActivity
-  for (auto& ta : m_current_window.inputs) {
-    tc.inputs.push_back(ta);
+  for (size_t i = 0; i < m_current_window.size(); ++i) {
+    tc.inputs.push_back(m_current_window.at(i));
   }
 
   return tc;
@@ -163,7 +196,7 @@ TriggerCandidateMakerMichelElectron::check_adjacency() const
 
 // Functions below this line are for debugging purposes.
 void
-TriggerCandidateMakerMichelElectron::add_window_to_record(Window window)
+TriggerCandidateMakerMichelElectron::add_window_to_record(const TAWindow& window)
 {
   m_window_record.push_back(window);
   return;
@@ -176,13 +209,13 @@ TriggerCandidateMakerMichelElectron::dump_window_record()
   std::ofstream outfile;
   outfile.open("window_record_tcm.csv", std::ios_base::app);
 
-  for (auto window : m_window_record) {
+  for (const auto& window : m_window_record) {
     outfile << window.time_start << ",";
-    outfile << window.inputs.back().time_start << ",";
-    outfile << window.inputs.back().time_start - window.time_start << ",";
+    outfile << window.back().time_start << ",";
+    outfile << window.back().time_start - window.time_start << ",";
     outfile << window.adc_integral << ",";
     outfile << window.n_channels_hit() << ",";
-    outfile << window.inputs.size() << std::endl;
+    outfile << window.size() << std::endl;
   }
 
   outfile.close();
@@ -192,27 +225,4 @@ TriggerCandidateMakerMichelElectron::dump_window_record()
   return;
 }
 
-/*
-void
-TriggerCandidateMakerMichelElectron::flush(timestamp_t, std::vector<TriggerCandidate>& output_tc)
-{
-  // Check the status of the current window, construct TC if conditions are met. Regardless
-  // of whether the conditions are met, reset the window.
-  if(m_current_window.adc_integral > m_adc_threshold && m_trigger_on_adc){
-  //else if(m_current_window.adc_integral > m_conf.adc_threshold && m_conf.trigger_on_adc){
-    //TLOG_DEBUG(TRACE_NAME) << "ADC integral in window is greater than specified threshold.";
-    output_tc.push_back(construct_tc());
-  }
-  else if(m_current_window.n_channels_hit() > m_n_channels_threshold && m_trigger_on_n_channels){
-  //else if(m_current_window.n_channels_hit() > m_conf.n_channels_threshold && m_conf.trigger_on_n_channels){
-    //TLOG_DEBUG(TRACE_NAME) << "Number of channels hit in the window is greater than specified threshold.";
-    output_tc.push_back(construct_tc());
-  }
-
-  //TLOG_DEBUG(TRACE_NAME) << "Clearing the current window, on the arrival of the next input_tp, the window will be
-reset."; m_current_window.clear();
-
-  return;
-}*/
-
 REGISTER_TRIGGER_CANDIDATE_MAKER(TRACE_NAME, TriggerCandidateMakerMichelElectron)
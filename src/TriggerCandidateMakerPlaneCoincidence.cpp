@@ -93,6 +93,34 @@ TriggerCandidateMakerPlaneCoincidence::operator()(const TriggerActivity& activit
   return;
 }
 
+void
+TriggerCandidateMakerPlaneCoincidence::operator()(Span<const TriggerActivity> activities,
+                                                  std::vector<TriggerCandidate>& output_tc)
+{
+  for (const TriggerActivity& activity : activities)
+    TriggerCandidateMakerPlaneCoincidence::operator()(activity, output_tc);
+}
+
+void
+TriggerCandidateMakerPlaneCoincidence::flush(timestamp_t until, std::vector<TriggerCandidate>& output_tc)
+{
+  // No TA from `until` on can be added to a complete window, so take the decision
+  // the next TA would take now rather than hold the window until it arrives.
+  if (!m_current_window.is_complete(until, m_window_length))
+    return;
+
+  if (m_current_window.adc_integral > m_adc_threshold && m_trigger_on_adc) {
+    TLOG_DEBUG(TLVL_DEBUG_HIGH) << "[TCM:PC] ADC integral in window is greater than specified threshold, flushing up to "
+                                << until << ".";
+    output_tc.push_back(construct_tc());
+    // The next TA starts a fresh window.
+    m_current_window.clear();
+  } else if (m_current_window.n_channels_hit() > m_n_channels_threshold && m_trigger_on_n_channels) {
+    tc_number++;
+    m_current_window.clear();
+  }
+}
+
 void
 TriggerCandidateMakerPlaneCoincidence::configure(const nlohmann::json& config)
 {
@@ -127,7 +155,7 @@ TriggerCandidateMakerPlaneCoincidence::configure(const nlohmann::json& config)
 TriggerCandidate
 TriggerCandidateMakerPlaneCoincidence::construct_tc() const
 {
-  TriggerActivity latest_ta_in_window = m_current_window.inputs.back();
+  const TriggerActivity& latest_ta_in_window = m_current_window.back();
 
   TriggerCandidate tc;
   tc.time_start = m_current_window.time_start - m_readout_window_ticks_before;
@@ -141,8 +169,8 @@ TriggerCandidateMakerPlaneCoincidence::construct_tc() const
   // Take the list of triggeralgs::TriggerActivity in the current
   // window and convert them (implicitly) to detdataformats'
   // TriggerActivityData, which is the base class of TriggerActivity
-  for (auto& ta : m_current_window.inputs) {
-    tc.inputs.push_back(ta);
+  for (size_t i = 0; i < m_current_window.size(); ++i) {
+    tc.inputs.push_back(m_current_window.at(i));
   }
 
   return tc;
@@ -157,7 +185,7 @@ TriggerCandidateMakerPlaneCoincidence::check_adjacency() const
 
 // Functions below this line are for debugging purposes.
 void
-TriggerCandidateMakerPlaneCoincidence::add_window_to_record(TAWindow window)
+TriggerCandidateMakerPlaneCoincidence::add_window_to_record(const TAWindow& window)
 {
   m_window_record.push_back(window);
   return;
@@ -170,13 +198,13 @@ TriggerCandidateMakerPlaneCoincidence::dump_window_record()
   std::ofstream outfile;
   outfile.open("window_record_tcm.csv", std::ios_base::app);
 
-  for (auto window : m_window_record) {
+  for (const auto& window : m_window_record) {
     outfile << window.time_start << ",";
-    outfile << window.inputs.back().time_start << ",";
-    outfile << window.inputs.back().time_start - window.time_start << ",";
+    outfile << window.back().time_start << ",";
+    outfile << window.back().time_start - window.time_start << ",";
     outfile << window.adc_integral << ",";
     outfile << window.n_channels_hit() << ",";
-    outfile << window.inputs.size() << std::endl;
+    outfile << window.size() << std::endl;
   }
 
   outfile.close();
@@ -23,22 +23,34 @@ TriggerCandidateMakerPrescale::operator()(const TriggerActivity& activity, std::
 {
   if ((m_activity_count++) % m_prescale == 0) {
     TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TCM:Pr] Emitting prescaled TriggerCandidate " << (m_activity_count - 1);
+    emit_tc(activity, cand);
+  }
+}
 
-    std::vector<TriggerActivity::TriggerActivityData> ta_list;
-    ta_list.push_back(static_cast<TriggerActivity::TriggerActivityData>(activity));
-
-    TriggerCandidate tc;
-    tc.time_start = activity.time_start - m_readout_window_ticks_before;
-    tc.time_end = activity.time_end + m_readout_window_ticks_after;
-    tc.time_candidate = activity.time_start;
-    tc.detid = activity.detid;
-    tc.type = TriggerCandidate::Type::kPrescale;
-    tc.algorithm = TriggerCandidate::Algorithm::kPrescale;
+void
+TriggerCandidateMakerPrescale::operator()(Span<const TriggerActivity> activities, std::vector<TriggerCandidate>& cand)
+{
+  // Jump straight to the TAs that pass the prescale rather than testing each one.
+  uint64_t first = (m_prescale - m_activity_count % m_prescale) % m_prescale; // NOLINT(build/unsigned)
+  for (uint64_t i = first; i < activities.size(); i += m_prescale) { // NOLINT(build/unsigned)
+    TLOG_DEBUG(TLVL_DEBUG_LOW) << "[TCM:Pr] Emitting prescaled TriggerCandidate " << (m_activity_count + i);
+    emit_tc(activities[i], cand);
+  }
+  m_activity_count += activities.size();
+}
 
-    tc.inputs = ta_list;
+void
+TriggerCandidateMakerPrescale::emit_tc(const TriggerActivity& activity, std::vector<TriggerCandidate>& cand) const
+{
+  TriggerCandidate& tc = cand.emplace_back();
+  tc.time_start = activity.time_start - m_readout_window_ticks_before;
+  tc.time_end = activity.time_end + m_readout_window_ticks_after;
+  tc.time_candidate = activity.time_start;
+  tc.detid = activity.detid;
+  tc.type = TriggerCandidate::Type::kPrescale;
+  tc.algorithm = TriggerCandidate::Algorithm::kPrescale;
 
-    cand.push_back(tc);
-  }
+  tc.inputs.push_back(static_cast<TriggerActivity::TriggerActivityData>(activity));
 }
 
 void
@@ -1,35 +1,121 @@
 #include "triggeralgs/dbscan/Hit.hpp"
 
 #include <algorithm>
+#include <utility>
 
 namespace triggeralgs {
 namespace dbscan {
 
 //======================================================================
-HitSet::HitSet()
+HitSet::HitSet(const HitSet& other)
 {
-    hits.reserve(10);
+    *this = other;
+}
+
+//======================================================================
+HitSet::HitSet(HitSet&& other) noexcept
+{
+    *this = std::move(other);
+}
+
+//======================================================================
+HitSet&
+HitSet::operator=(const HitSet& other)
+{
+    if (this != &other) {
+        m_size = 0;
+        reserve(other.m_size);
+        std::copy(other.begin(), other.end(), m_hits);
+        m_size = other.m_size;
+    }
+    return *this;
+}
+
+//======================================================================
+HitSet&
+HitSet::operator=(HitSet&& other) noexcept
+{
+    if (this == &other) {
+        return *this;
+    }
+    if (other.m_hits == other.m_inline) {
+        std::copy(other.begin(), other.end(), m_inline);
+        release();
+    } else {
+        release();
+        m_hits = other.m_hits;
+        m_capacity = other.m_capacity;
+        other.m_hits = other.m_inline;
+        other.m_capacity = kInlineHits;
+    }
+    m_size = other.m_size;
+    other.m_size = 0;
+    return *this;
+}
+
+//======================================================================
+HitSet::~HitSet()
+{
+    release();
+}
+
+//======================================================================
+void
+HitSet::reserve(uint32_t capacity)
+{
+    if (capacity <= m_capacity) {
+        return;
+    }
+    uint32_t new_capacity = std::max(capacity, 2 * m_capacity);
+    Hit** hits = new Hit*[new_capacity];
+    std::copy(begin(), end(), hits);
+    release();
+    m_hits = hits;
+    m_capacity = new_capacity;
+}
+
+//======================================================================
+void
+HitSet::release()
+{
+    if (m_hits != m_inline) {
+        delete[] m_hits;
+        m_hits = m_inline;
+        m_capacity = kInlineHits;
+    }
 }
 
 //======================================================================
 void
 HitSet::insert(Hit* h)
 {
-    // We're typically inserting hits at or near the end, so do a
-    // linear scan instead of full binary search. This turns out to be much
-    // faster in our case
-    auto it = hits.rbegin();
-    while (it != hits.rend() && (*it)->time >= h->time) {
+    // Hits nearly always arrive in time order, so the new hit usually
+    // goes on the end, and cannot be there already
+    if (m_size == 0 || m_hits[m_size - 1]->time < h->time) {
+        if (m_size == m_capacity) {
+            reserve(m_size + 1);
+        }
+        m_hits[m_size++] = h;
+        return;
+    }
+
+    // Otherwise do a linear scan back from the end instead of a full
+    // binary search, which turns out to be much faster in our case
+    uint32_t pos = m_size;
+    while (pos != 0 && m_hits[pos - 1]->time >= h->time) {
         // Don't insert the hit if we already have it
-        if (*it == h) {
+        if (m_hits[pos - 1] == h) {
             return;
         }
-        ++it;
+        --pos;
     }
-    
-    if (it == hits.rend() || *it != h) {
-        hits.insert(it.base(), h);
+
+    if (m_size == m_capacity) {
+        reserve(m_size + 1);
     }
+    std::copy_backward(m_hits + pos, m_hits + m_size, m_hits + m_size + 1);
+    m_hits[pos] = h;
+    ++m_size;
 }
 
 //======================================================================
@@ -0,0 +1,108 @@
+#include "triggeralgs/dbscan/HitPool.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <utility>
+
+namespace triggeralgs {
+namespace dbscan {
+
+//======================================================================
+HitPool::HitPool(size_t chunk_size)
+    : m_chunk_size(std::max<size_t>(chunk_size, 1))
+{}
+
+//======================================================================
+Hit&
+HitPool::allocate(float time, int chan, const triggeralgs::TriggerPrimitive* prim)
+{
+    if (m_chunks.empty() || m_back_used == m_chunk_size) {
+        if (!m_spare.empty()) {
+            m_chunks.push_back(std::move(m_spare));
+            m_spare = std::vector<Hit>();
+        } else {
+            m_chunks.emplace_back();
+            m_chunks.back().reserve(m_chunk_size);
+        }
+        m_back_used = 0;
+    }
+
+    // A reused chunk already has its hits, whose neighbour lists keep
+    // their capacity through reset()
+    std::vector<Hit>& chunk = m_chunks.back();
+    Hit* hit;
+    if (m_back_used < chunk.size()) {
+        hit = &chunk[m_back_used];
+        hit->reset(time, chan, prim);
+    } else {
+        hit = &chunk.emplace_back(time, chan, prim);
+    }
+    ++m_back_used;
+    hit->generation = m_next_generation++;
+    return *hit;
+}
+
+//======================================================================
+void
+HitPool::release(size_t n)
+{
+    assert(n <= size());
+    m_first_generation += n;
+
+    // Every chunk before the one holding the oldest hit kept is done
+    // with. They are all full, since a chunk is only started once the
+    // one before it is
+    while (!m_chunks.empty() && m_first_generation - m_front_generation >= m_chunk_size) {
+#ifdef TRIGGERALGS_HITPOOL_CHECK_STALE
+        // Moving the vector keeps its hits where they are
+        m_set_aside.push_back(std::move(m_chunks.front()));
+#else
+        if (m_spare.empty()) {
+            m_spare = std::move(m_chunks.front());
+        }
+#endif
+        m_chunks.pop_front();
+        m_front_generation += m_chunk_size;
+    }
+}
+
+//======================================================================
+size_t
+HitPool::count_before(float time) const
+{
+    size_t first = 0;
+    size_t last = size();
+    while (first < last) {
+        size_t middle = first + (last - first) / 2;
+        if ((*this)[middle].time < time) {
+            first = middle + 1;
+        } else {
+            last = middle;
+        }
+    }
+    return first;
+}
+
+//======================================================================
+Hit&
+HitPool::at_generation(uint64_t generation)
+{
+    uint64_t offset = generation - m_front_generation;
+    return m_chunks[offset / m_chunk_size][offset % m_chunk_size];
+}
+
+//======================================================================
+const Hit&
+HitPool::at_generation(uint64_t generation) const
+{
+    uint64_t offset = generation - m_front_generation;
+    return m_chunks[offset / m_chunk_size][offset % m_chunk_size];
+}
+
+}
+}
+// Local Variables:
+// mode: c++
+// c-basic-offset: 4
+// c-file-style: "linux"
+// End:
@@ -1,7 +1,9 @@
 #include "triggeralgs/dbscan/dbscan.hpp"
 #include "triggeralgs/dbscan/Hit.hpp"
 
+#include <algorithm>
 #include <cassert>
+#include <cmath>
 #include <limits>
 
 namespace triggeralgs {
@@ -26,6 +28,118 @@ neighbours_sorted(const std::vector<Hit*>& hits, Hit& q, float eps, int minPts)
     return n;
 }
 
+//======================================================================
+HitIndex::HitIndex(float eps)
+    : m_eps(eps)
+    , m_width(std::max(1, static_cast<int>(std::min(std::ceil(eps), 1e9f))))
+{}
+
+//======================================================================
+int
+HitIndex::column_index(int chan) const
+{
+    int index = chan / m_width;
+    if (chan % m_width != 0 && chan < 0) {
+        --index;
+    }
+    return index;
+}
+
+//======================================================================
+std::vector<HitIndex::Entry>*
+HitIndex::column(int index, bool create)
+{
+    if (m_columns.empty() || index < m_first_column ||
+        index - m_first_column >= static_cast<int>(m_columns.size())) {
+        if (!create) {
+            return nullptr;
+        }
+        if (m_columns.empty()) {
+            m_first_column = index;
+            m_columns.resize(1);
+        } else if (index < m_first_column) {
+            m_columns.insert(m_columns.begin(), m_first_column - index, std::vector<Entry>());
+            m_first_column = index;
+        } else {
+            m_columns.resize(index - m_first_column + 1);
+        }
+    }
+    return &m_columns[index - m_first_column];
+}
+
+//======================================================================
+void
+HitIndex::add(Hit* hit)
+{
+    std::vector<Entry>& entries = *column(column_index(hit->chan), true);
+    // Clear out the forgotten hits at the front of the column rather than
+    // let it grow
+    if (entries.size() == entries.capacity() && !entries.empty() &&
+        entries.front().index < m_first_kept) {
+        auto first_kept = std::lower_bound(
+            entries.begin(), entries.end(), m_first_kept, [](const Entry& e, uint64_t index) {
+                return e.index < index;
+            });
+        entries.erase(entries.begin(), first_kept);
+    }
+    entries.push_back({ hit, m_n_added++ });
+}
+
+//======================================================================
+int
+HitIndex::neighbours(Hit& q, int minPts)
+{
+    // Any neighbour is less than eps, and so less than a column width,
+    // away in channel
+    std::vector<Entry>* columns[3];
+    size_t ends[3];
+    int n_columns = 0;
+    int index = column_index(q.chan);
+    for (int i = index - 1; i <= index + 1; ++i) {
+        std::vector<Entry>* entries = column(i, false);
+        if (entries && !entries->empty()) {
+            columns[n_columns] = entries;
+            ends[n_columns] = entries->size();
+            ++n_columns;
+        }
+    }
+
+    // Walk back through the columns together, always taking the hit that
+    // was added latest, as neighbours_sorted() walks back through all the
+    // hits. A column is done at its first hit that is forgotten or too
+    // early
+    int n = 0;
+    while (true) {
+        int latest = -1;
+        for (int k = 0; k < n_columns; ++k) {
+            if (ends[k] != 0 &&
+                (latest < 0 ||
+                 (*columns[k])[ends[k] - 1].index > (*columns[latest])[ends[latest] - 1].index)) {
+                latest = k;
+            }
+        }
+        if (latest < 0) {
+            break;
+        }
+
+        const Entry& entry = (*columns[latest])[--ends[latest]];
+        if (entry.index < m_first_kept) {
+            ends[latest] = 0;
+            continue;
+        }
+        if (entry.hit->time > q.time + m_eps)
+            continue;
+        if (entry.hit->time < q.time - m_eps) {
+            ends[latest] = 0;
+            continue;
+        }
+
+        if (q.add_potential_neighbour(entry.hit, m_eps, minPts))
+            ++n;
+    }
+    return n;
+}
+
 //======================================================================
 bool
 Cluster::maybe_add_new_hit(Hit* new_hit, float eps, int minPts)
@@ -95,12 +209,13 @@ void
 IncrementalDBSCAN::cluster_reachable(Hit* seed_hit, Cluster& cluster)
 {
     // Loop over all neighbours (and the neighbours of core points, and so on)
-    std::vector<Hit*> seedSet(seed_hit->neighbours.begin(),
-                              seed_hit->neighbours.end());
+    std::vector<Hit*>& seedSet = m_seeds;
+    seedSet.assign(seed_hit->neighbours.begin(), seed_hit->neighbours.end());
 
     while (!seedSet.empty()) {
         Hit* q = seedSet.back();
         seedSet.pop_back();
+        assert(m_pool.is_kept(*q));
         // Change noise to a border point
         if (q->connectedness == Connectedness::kNoise) {
             cluster.add_hit(q);
@@ -125,10 +240,7 @@ IncrementalDBSCAN::cluster_reachable(Hit* seed_hit, Cluster& cluster)
 void
 IncrementalDBSCAN::add_point(float time, float channel, std::vector<Cluster>* completed_clusters)
 {
-    Hit& new_hit=m_hit_pool[m_pool_end];
-    new_hit.reset(time, channel);
-    ++m_pool_end;
-    if(m_pool_end==m_hit_pool.size()) m_pool_end=0;
+    Hit& new_hit=m_pool.allocate(time, channel);
     add_hit(&new_hit, completed_clusters);
 }
 
@@ -140,10 +252,7 @@ IncrementalDBSCAN::add_primitive(const triggeralgs::TriggerPrimitive& prim, std:
         m_first_prim_time=prim.time_start;
     }
     
-    Hit& new_hit=m_hit_pool[m_pool_end];
-    new_hit.reset(1e-2*(prim.time_start-m_first_prim_time), prim.channel, &prim);
-    ++m_pool_end;
-    if(m_pool_end==m_hit_pool.size()) m_pool_end=0;
+    Hit& new_hit=m_pool.allocate(1e-2*(prim.time_start-m_first_prim_time), prim.channel, &prim);
 
     add_hit(&new_hit, completed_clusters);
 }
@@ -152,29 +261,31 @@ IncrementalDBSCAN::add_primitive(const triggeralgs::TriggerPrimitive& prim, std:
 void
 IncrementalDBSCAN::add_hit(Hit* new_hit, std::vector<Cluster>* completed_clusters)
 {
-    // TODO: this should be a member variable, not a static, in case
-    // there are multiple IncrementalDBSCAN instances
-    static int next_cluster_index = 0;
-
-    m_hits.push_back(new_hit);
+    m_index.add(new_hit);
     m_latest_time = new_hit->time;
 
     // All the clusters that this hit neighboured. If there are
     // multiple clusters neighbouring this hit, we'll merge them at
     // the end
-    std::set<int> clusters_neighbouring_hit;
+    std::vector<int>& clusters_neighbouring_hit = m_neighbouring_clusters;
+    clusters_neighbouring_hit.clear();
 
     // Find all the hit's neighbours
-    neighbours_sorted(m_hits, *new_hit, m_eps, m_minPts);
+    m_index.neighbours(*new_hit, m_minPts);
 
     for (auto neighbour : new_hit->neighbours) {
+        assert(m_pool.is_kept(*neighbour));
         if (neighbour->cluster != kUndefined && neighbour->cluster != kNoise &&
             neighbour->neighbours.size() + 1 >= m_minPts) {
             // This neighbour is a core point in a cluster. Add the cluster to the list of
             // clusters that will contain this hit
-            clusters_neighbouring_hit.insert(neighbour->cluster);
+            clusters_neighbouring_hit.push_back(neighbour->cluster);
         }
     }
+    std::sort(clusters_neighbouring_hit.begin(), clusters_neighbouring_hit.end());
+    clusters_neighbouring_hit.erase(
+        std::unique(clusters_neighbouring_hit.begin(), clusters_neighbouring_hit.end()),
+        clusters_neighbouring_hit.end());
 
     if (clusters_neighbouring_hit.empty()) {
         // This hit didn't match any existing cluster. See if we can
@@ -184,12 +295,13 @@ IncrementalDBSCAN::add_hit(Hit* new_hit, std::vector<Cluster>* completed_cluster
             // std::cout << "New cluster starting at hit time " << new_hit->time << " with " << new_hit->neighbours.size() << " neighbours" << std::endl;
             new_hit->connectedness = Connectedness::kCore;
             auto new_it = m_clusters.emplace_hint(
-                m_clusters.end(), next_cluster_index, next_cluster_index);
+                m_clusters.end(), m_next_cluster_index, m_next_cluster_index);
             Cluster& new_cluster = new_it->second;
             new_cluster.completeness = Completeness::kIncomplete;
             new_cluster.add_hit(new_hit);
-            next_cluster_index++;
+            m_next_cluster_index++;
             cluster_reachable(new_hit, new_cluster);
+            queue_cluster(new_cluster);
         }
         else{
             // std::cout << "New hit time " << new_hit->time << " with " << new_hit->neighbours.size() << " neighbours is noise" << std::endl;
@@ -204,6 +316,7 @@ IncrementalDBSCAN::add_hit(Hit* new_hit, std::vector<Cluster>* completed_cluster
         auto it = m_clusters.find(*index_it);
         assert(it != m_clusters.end());
         Cluster& cluster = it->second;
+        float first_time = (*cluster.hits.begin())->time;
         // std::cout << "Adding hit time " << new_hit->time << " with " << new_hit->neighbours.size() << " neighbours to existing cluster" << std::endl;
         cluster.add_hit(new_hit);
 
@@ -221,6 +334,7 @@ IncrementalDBSCAN::add_hit(Hit* new_hit, std::vector<Cluster>* completed_cluster
             // addition of new_hit. Add q's neighbours to the cluster
             if(q->neighbours.size() + 1 == m_minPts){
                 for (auto r : q->neighbours) {
+                    assert(m_pool.is_kept(*r));
                     cluster.add_hit(r);
                 }
             }
@@ -235,6 +349,14 @@ IncrementalDBSCAN::add_hit(Hit* new_hit, std::vector<Cluster>* completed_cluster
             assert(other_it != m_clusters.end());
             Cluster& other_cluster = other_it->second;
             cluster.steal_hits(other_cluster);
+            m_clusters.erase(other_it);
+        }
+
+        // The cluster's latest time is only ever put off, which
+        // complete_clusters() catches up with, but an earlier first hit
+        // needs a new entry for trim_hits()
+        if ((*cluster.hits.begin())->time < first_time) {
+            m_by_first_time.push({ (*cluster.hits.begin())->time, cluster.index });
         }
     }
 
@@ -247,12 +369,13 @@ IncrementalDBSCAN::add_hit(Hit* new_hit, std::vector<Cluster>* completed_cluster
             if(neighbour->cluster==kNoise || neighbour->cluster==kUndefined){
                 if(new_hit->cluster==kNoise || new_hit->cluster==kUndefined){
                     auto new_it = m_clusters.emplace_hint(
-                                                          m_clusters.end(), next_cluster_index, next_cluster_index);
+                                                          m_clusters.end(), m_next_cluster_index, m_next_cluster_index);
                     Cluster& new_cluster = new_it->second;
                     new_cluster.completeness = Completeness::kIncomplete;
                     new_cluster.add_hit(neighbour);
-                    next_cluster_index++;
+                    m_next_cluster_index++;
                     cluster_reachable(neighbour, new_cluster);
+                    queue_cluster(new_cluster);
                 }
             }
         }
@@ -262,58 +385,113 @@ IncrementalDBSCAN::add_hit(Hit* new_hit, std::vector<Cluster>* completed_cluster
     }
 
 
-    // Delete any completed clusters from the list. Put them in the
-    // `completed_clusters` vector, if that vector was passed
-    auto clust_it = m_clusters.begin();
-    while (clust_it != m_clusters.end()) {
-        Cluster& cluster = clust_it->second;
+    complete_clusters(m_latest_time - m_eps, completed_clusters);
+}
 
-        if (cluster.latest_time < m_latest_time - m_eps) {
-            cluster.completeness = Completeness::kComplete;
-        }
+//======================================================================
+void
+IncrementalDBSCAN::flush(triggeralgs::timestamp_t until, std::vector<Cluster>* completed_clusters)
+{
+    if (m_first_prim_time == 0 || until < m_first_prim_time) {
+        return;
+    }
 
-        if (cluster.completeness == Completeness::kComplete) {
-            if(completed_clusters){
-                // TODO: room for std::move here?
-                //
-                // Clusters that got merged into another cluster had
-                // their hits cleared, and were set kComplete, by
-                // steal_hits
-                if(cluster.hits.size()!=0){
-                    completed_clusters->push_back(cluster);
-                }
-            }
-            clust_it = m_clusters.erase(clust_it);
+    // A new hit at `time` can only neighbour hits later than time -
+    // eps, but through those neighbours it can still pull in hits
+    // back to time - 2*eps, so only clusters ending before then are
+    // out of reach
+    float time = 1e-2 * (until - m_first_prim_time);
+    complete_clusters(time - 2 * m_eps, completed_clusters);
+}
+
+//======================================================================
+void
+IncrementalDBSCAN::queue_cluster(const Cluster& cluster)
+{
+    m_by_latest_time.push({ cluster.latest_time, cluster.index });
+    m_by_first_time.push({ (*cluster.hits.begin())->time, cluster.index });
+}
+
+//======================================================================
+void
+IncrementalDBSCAN::complete_clusters(float time, std::vector<Cluster>* completed_clusters)
+{
+    // Only the clusters whose entry has come due can be complete. Those
+    // that have taken later hits since their entry was made go back in
+    // the queue with their latest time; entries for clusters that were
+    // merged into another are dropped
+    std::vector<int>& complete = m_completed_clusters;
+    complete.clear();
+    while (!m_by_latest_time.empty() && m_by_latest_time.top().time < time) {
+        int index = m_by_latest_time.top().index;
+        m_by_latest_time.pop();
+        auto clust_it = m_clusters.find(index);
+        if (clust_it == m_clusters.end()) {
             continue;
+        }
+        Cluster& cluster = clust_it->second;
+        if (cluster.latest_time < time) {
+            cluster.completeness = Completeness::kComplete;
+            complete.push_back(index);
         } else {
-            ++clust_it;
+            m_by_latest_time.push({ cluster.latest_time, index });
         }
     }
+
+    // Move the completed clusters to `completed_clusters`, if that
+    // vector was passed, in the order they were made
+    std::sort(complete.begin(), complete.end());
+    for (int index : complete) {
+        auto clust_it = m_clusters.find(index);
+        if (completed_clusters) {
+            completed_clusters->push_back(std::move(clust_it->second));
+        }
+        m_clusters.erase(clust_it);
+    }
 }
 
-void
-IncrementalDBSCAN::trim_hits()
+//======================================================================
+std::vector<Hit*>
+IncrementalDBSCAN::get_hits()
 {
-    // Find the earliest time of a hit in any cluster in the list (active or
-    // not)
-    float earliest_time = std::numeric_limits<float>::max();
-
-    for (auto& cluster : m_clusters) {
-        earliest_time =
-            std::min(earliest_time, (*cluster.second.hits.begin())->time);
+    std::vector<Hit*> hits;
+    hits.reserve(m_pool.size());
+    for (size_t i = 0; i < m_pool.size(); ++i) {
+        hits.push_back(&m_pool[i]);
     }
+    return hits;
+}
 
-    // If there were no clusters, set the earliest_time to the latest time
-    // (otherwise it would still be FLOAT_MAX)
+//======================================================================
+void
+IncrementalDBSCAN::trim_hits()
+{
+    // Find the earliest time of a hit in any cluster in the list,
+    // dropping the entries of clusters that are gone or have taken an
+    // earlier hit since. If there were no clusters, use the latest time
+    float earliest_time = m_latest_time;
     if (m_clusters.empty()) {
-        earliest_time = m_latest_time;
+        while (!m_by_first_time.empty()) {
+            m_by_first_time.pop();
+        }
+    } else {
+        while (true) {
+            assert(!m_by_first_time.empty());
+            const ClusterTime& first = m_by_first_time.top();
+            auto clust_it = m_clusters.find(first.index);
+            if (clust_it != m_clusters.end() &&
+                (*clust_it->second.hits.begin())->time == first.time) {
+                earliest_time = first.time;
+                break;
+            }
+            m_by_first_time.pop();
+        }
     }
-    auto last_it = std::lower_bound(m_hits.begin(),
-                                    m_hits.end(),
-                                    earliest_time - 10 * m_eps,
-                                    time_comp_lower);
 
-    m_hits.erase(m_hits.begin(), last_it);
+    size_t n_trimmed = m_pool.count_before(earliest_time - 10 * m_eps);
+
+    m_index.drop_oldest(n_trimmed);
+    m_pool.release(n_trimmed);
 }
 
 }
@@ -0,0 +1,173 @@
+/**
+ * @file benchmark_adjacency.cxx
+ *
+ * Compares the ways of finding the longest adjacent run of hit channels in a
+ * window of TPs, as HorizontalMuon does for every TP: sorting the window's
+ * channels and scanning them, as it did at first; walking the bitmap of
+ * ChannelOccupancy (scan_adjacent_run()); and ChannelOccupancy's kept
+ * segments (longest_adjacent_run()). The window slides over a synthetic
+ * stream of noise and tracks, and the times given are per TP, for the query
+ * alone, net of keeping the window.
+ *
+ * Usage: benchmark_adjacency [n_tps]
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "triggeralgs/ChannelOccupancy.hpp"
+#include "triggeralgs/TPGenerator.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+
+using namespace triggeralgs;
+
+namespace {
+
+const channel_t s_max_step = 5;
+const uint16_t s_tolerance = 3;
+
+// HorizontalMuon's original adjacency.
+uint16_t
+sort_and_scan(const std::deque<TriggerPrimitive>& window)
+{
+  uint16_t adj = 1;
+  uint16_t max = 0;
+  unsigned int tol_count = 0;
+
+  std::vector<int> chanList;
+  for (const TriggerPrimitive& tp : window)
+    chanList.push_back(tp.channel);
+  std::sort(chanList.begin(), chanList.end());
+
+  for (std::size_t i = 0; i < chanList.size(); ++i) {
+    unsigned int channel = chanList[i];
+    unsigned int next_channel = chanList[(i + 1) % chanList.size()];
+    if (next_channel == 0)
+      next_channel = channel - 1;
+    if (next_channel == channel) {
+      continue;
+    } else if (next_channel == channel + 1) {
+      ++adj;
+    } else if (next_channel >= channel + 2 && next_channel <= channel + s_max_step && tol_count < s_tolerance) {
+      ++adj;
+      tol_count += next_channel - channel;
+    } else {
+      max = std::max(max, adj);
+      adj = 1;
+      tol_count = 0;
+    }
+  }
+  return max;
+}
+
+enum class Method
+{
+  kNone,
+  kSortAndScan,
+  kBitmapScan,
+  kKeptSegments
+};
+
+// Slide a window over the TPs, and find the adjacency after every TP.
+double
+run(const std::vector<TriggerPrimitive>& tps, timestamp_t window_length, Method method, uint64_t& checksum) // NOLINT
+{
+  std::deque<TriggerPrimitive> window;
+  ChannelOccupancy occupancy;
+  uint64_t sum = 0; // NOLINT(build/unsigned)
+  double mean_size = 0;
+
+  auto start = std::chrono::steady_clock::now();
+  for (const TriggerPrimitive& tp : tps) {
+    while (!window.empty() && tp.time_start - window.front().time_start >= window_length) {
+      occupancy.remove(window.front().channel);
+      window.pop_front();
+    }
+    window.push_back(tp);
+    occupancy.add(tp.channel);
+
+    switch (method) {
+      case Method::kNone:
+        sum += occupancy.n_channels_hit();
+        break;
+      case Method::kSortAndScan:
+        sum += sort_and_scan(window);
+        break;
+      case Method::kBitmapScan:
+        sum += occupancy.scan_adjacent_run(s_max_step, s_tolerance);
+        break;
+      case Method::kKeptSegments:
+        sum += occupancy.longest_adjacent_run(s_max_step, s_tolerance);
+        break;
+    }
+    mean_size += window.size();
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  if (method == Method::kNone)
+    std::printf("%10.0f", mean_size / tps.size());
+  checksum = sum;
+  return 1e9 * seconds / tps.size();
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  size_t n_tps = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+
+  std::printf("ns per TP to find the adjacency of the window, max_step %d, tolerance %d\n",
+              s_max_step,
+              s_tolerance);
+  std::printf("%12s %10s %10s %14s %14s %14s\n",
+              "stream",
+              "window",
+              "tps held",
+              "sort and scan",
+              "bitmap scan",
+              "kept segments");
+
+  struct Mix
+  {
+    const char* name;
+    double noise_rate_hz;
+    double track_rate_hz;
+  };
+  for (const Mix& mix : { Mix{ "quiet", 100, 50 }, Mix{ "noisy", 2000, 50 }, Mix{ "busy", 2000, 1000 } }) {
+    TPGenerator generator;
+    generator.configure({ { "noise_rate_hz", mix.noise_rate_hz }, { "track_rate_hz", mix.track_rate_hz } });
+    std::vector<TriggerPrimitive> tps;
+    generator.generate(n_tps, tps);
+
+    for (timestamp_t window_length : { 1000, 8000, 32000 }) {
+      std::printf("%12s %10llu", mix.name, static_cast<unsigned long long>(window_length)); // NOLINT(runtime/int)
+      uint64_t sums[4]; // NOLINT(build/unsigned)
+      double base = run(tps, window_length, Method::kNone, sums[0]);
+      double sort_and_scan = window_length > 8000 && mix.noise_rate_hz > 1000
+                               ? -1 // Far too slow to wait for
+                               : run(tps, window_length, Method::kSortAndScan, sums[1]) - base;
+      double bitmap_scan = run(tps, window_length, Method::kBitmapScan, sums[2]) - base;
+      double kept_segments = run(tps, window_length, Method::kKeptSegments, sums[3]) - base;
+      if (sort_and_scan < 0)
+        std::printf(" %14s", "-");
+      else
+        std::printf(" %14.1f", sort_and_scan);
+      std::printf(" %14.1f %14.1f\n", bitmap_scan, kept_segments);
+
+      if (sums[2] != sums[3] || (sort_and_scan >= 0 && sums[1] != sums[2])) {
+        std::fprintf(stderr, "The methods disagree\n");
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,216 @@
+/**
+ * @file benchmark_batch.cxx
+ *
+ * Compares the per-object operator() of every registered TA and TC maker
+ * with its Span batch entry point, on the same synthetic input stream.
+ *
+ * Usage: benchmark_batch [n_tps] [batch_size]
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "triggeralgs/TriggerActivityFactory.hpp"
+#include "triggeralgs/TriggerCandidateFactory.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+using namespace triggeralgs;
+
+namespace {
+
+// Algorithms that cannot run stand-alone (eg need an inference server).
+const std::vector<std::string> s_skipped = { "TriggerActivityMakerTritonPlugin" };
+
+// Configurations that make the makers actually do work on the synthetic stream.
+// Anything not listed here is configured with an empty object.
+const std::map<std::string, nlohmann::json>&
+benchmark_configs()
+{
+  static const std::map<std::string, nlohmann::json> s_configs = {
+    { "TriggerActivityMakerPrescalePlugin", { { "prescale", 100 } } },
+    { "TriggerActivityMakerBundleNPlugin", { { "bundle_size", 100 } } },
+    { "TriggerCandidateMakerPrescalePlugin", { { "prescale", 10 } } },
+    { "TriggerCandidateMakerBundleNPlugin", { { "bundle_size", 10 } } },
+    { "TriggerCandidateMakerHorizontalMuonPlugin", { { "trigger_on_adc", true } } },
+    { "TriggerCandidateMakerChannelAdjacencyPlugin", { { "trigger_on_adc", true } } },
+  };
+  return s_configs;
+}
+
+nlohmann::json
+config_for(const std::string& alg_name)
+{
+  auto it = benchmark_configs().find(alg_name);
+  return it == benchmark_configs().end() ? nlohmann::json::object() : it->second;
+}
+
+// Time-ordered TPs with uniform channels and a fixed seed, so every maker and
+// both entry points see exactly the same stream.
+std::vector<TriggerPrimitive>
+make_tps(size_t n_tps)
+{
+  std::vector<TriggerPrimitive> tps(n_tps);
+  uint64_t state = 0x2545F4914F6CDD1DULL; // NOLINT(build/unsigned)
+  auto next = [&state]() {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+  };
+
+  timestamp_t time = 1'000'000;
+  for (auto& tp : tps) {
+    time += next() % 32;
+    tp.type = TriggerPrimitive::Type::kTPC;
+    tp.time_start = time;
+    tp.time_over_threshold = 10 + next() % 40;
+    tp.time_peak = tp.time_start + tp.time_over_threshold / 2;
+    tp.channel = next() % 2560;
+    tp.adc_integral = 500 + next() % 5000;
+    tp.adc_peak = 20 + next() % 200;
+    tp.detid = 0;
+  }
+  return tps;
+}
+
+// Group the TPs into fixed-size TAs for the TC makers.
+std::vector<TriggerActivity>
+make_tas(const std::vector<TriggerPrimitive>& tps, size_t tps_per_ta)
+{
+  std::vector<TriggerActivity> tas;
+  for (size_t first = 0; first + tps_per_ta <= tps.size(); first += tps_per_ta) {
+    TriggerActivity& ta = tas.emplace_back();
+    ta.inputs.assign(tps.begin() + first, tps.begin() + first + tps_per_ta);
+    ta.time_start = ta.inputs.front().time_start;
+    ta.time_end = ta.inputs.back().time_start + ta.inputs.back().time_over_threshold;
+    ta.channel_start = ta.inputs.front().channel;
+    ta.channel_end = ta.inputs.front().channel;
+    for (const auto& tp : ta.inputs) {
+      ta.channel_start = std::min(ta.channel_start, tp.channel);
+      ta.channel_end = std::max(ta.channel_end, tp.channel);
+      ta.adc_integral += tp.adc_integral;
+      if (tp.adc_peak > ta.adc_peak) {
+        ta.adc_peak = tp.adc_peak;
+        ta.time_peak = tp.time_peak;
+        ta.channel_peak = tp.channel;
+      }
+    }
+    ta.time_activity = ta.time_peak;
+    ta.type = TriggerActivity::Type::kTPC;
+  }
+  return tas;
+}
+
+struct Result
+{
+  double seconds = 0;
+  size_t n_outputs = 0;
+};
+
+// Feed `inputs` to a freshly configured maker, one object per call.
+template<class Output, class Maker, class Input>
+Result
+run_single(Maker& maker, const std::vector<Input>& inputs)
+{
+  std::vector<Output> outputs;
+  Result result;
+  auto start = std::chrono::steady_clock::now();
+  for (const Input& input : inputs) {
+    maker(input, outputs);
+    if (outputs.size() > 4096) {
+      result.n_outputs += outputs.size();
+      outputs.clear();
+    }
+  }
+  result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  result.n_outputs += outputs.size();
+  return result;
+}
+
+// Feed `inputs` to a freshly configured maker, `batch_size` objects per call.
+template<class Output, class Maker, class Input>
+Result
+run_batch(Maker& maker, const std::vector<Input>& inputs, size_t batch_size)
+{
+  std::vector<Output> outputs;
+  Result result;
+  Span<const Input> all(inputs);
+  auto start = std::chrono::steady_clock::now();
+  for (size_t first = 0; first < all.size(); first += batch_size) {
+    maker(all.subspan(first, batch_size), outputs);
+    if (outputs.size() > 4096) {
+      result.n_outputs += outputs.size();
+      outputs.clear();
+    }
+  }
+  result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  result.n_outputs += outputs.size();
+  return result;
+}
+
+template<class Factory, class Input, class Output>
+void
+benchmark_all(const char* unit, const std::vector<Input>& inputs, size_t batch_size)
+{
+  for (const std::string& alg_name : Factory::get_registered_algorithms()) {
+    if (std::find(s_skipped.begin(), s_skipped.end(), alg_name) != s_skipped.end())
+      continue;
+
+    auto factory = Factory::get_instance();
+    auto single_maker = factory->build_maker(alg_name);
+    auto batch_maker = factory->build_maker(alg_name);
+    try {
+      single_maker->configure(config_for(alg_name));
+      batch_maker->configure(config_for(alg_name));
+    } catch (const std::exception&) {
+      std::printf("%-48s skipped: configuration rejected\n", alg_name.c_str());
+      continue;
+    }
+
+    Result single = run_single<Output>(*single_maker, inputs);
+    Result batch = run_batch<Output>(*batch_maker, inputs, batch_size);
+
+    double single_rate = inputs.size() / single.seconds;
+    double batch_rate = inputs.size() / batch.seconds;
+    std::printf("%-48s single %10.3e %ss/s  batch %10.3e %ss/s  speedup %5.2fx  outputs %zu/%zu%s\n",
+                alg_name.c_str(),
+                single_rate,
+                unit,
+                batch_rate,
+                unit,
+                batch_rate / single_rate,
+                single.n_outputs,
+                batch.n_outputs,
+                single.n_outputs == batch.n_outputs ? "" : "  MISMATCH");
+  }
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  size_t n_tps = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+  size_t batch_size = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 1024;
+
+  std::vector<TriggerPrimitive> tps = make_tps(n_tps);
+  std::vector<TriggerActivity> tas = make_tas(tps, 16);
+
+  std::printf("TA makers: %zu TPs, batches of %zu\n", tps.size(), batch_size);
+  benchmark_all<TriggerActivityFactory, TriggerPrimitive, TriggerActivity>("TP", tps, batch_size);
+
+  std::printf("TC makers: %zu TAs, batches of %zu\n", tas.size(), batch_size);
+  benchmark_all<TriggerCandidateFactory, TriggerActivity, TriggerCandidate>("TA", tas, batch_size);
+
+  return 0;
+}
@@ -0,0 +1,216 @@
+/**
+ * @file benchmark_channel_adjacency.cxx
+ *
+ * Times ChannelAdjacency's closing of a complete window, which takes every
+ * track out of it, against the number of tracks and of noise TPs in the
+ * window. "one by one" is the way the maker did it at first, sorting what is
+ * left of the window again for each track; "one walk" is the maker itself,
+ * which sorts the window once and walks its channels once, plus once again
+ * over the run before each track. The times are per window.
+ *
+ * Usage: benchmark_channel_adjacency [min_ms_per_point]
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "triggeralgs/ChannelAdjacency/TriggerActivityMakerChannelAdjacency.hpp"
+#include "triggeralgs/TPWindow.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+using namespace triggeralgs;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const timestamp_t s_window_length = 8000;
+const uint16_t s_threshold = 15;
+const uint16_t s_tolerance = 3;
+double s_min_seconds = 0.05;
+
+// ChannelAdjacency's first track in the window, as it was found at first.
+TPWindow
+check_adjacency(const TPWindow& window)
+{
+  std::vector<std::pair<int, TriggerPrimitive>> chanTPList;
+  for (size_t i = 0; i < window.size(); ++i)
+    chanTPList.push_back(std::make_pair(window.at(i).channel, window.at(i)));
+  std::sort(chanTPList.begin(),
+            chanTPList.end(),
+            [](const std::pair<int, TriggerPrimitive>& a, const std::pair<int, TriggerPrimitive>& b) {
+              return a.first < b.first;
+            });
+
+  unsigned int tol_count = 0;
+  TPWindow win_adj;
+  TPWindow win_adj_max;
+  for (std::size_t i = 0; i < chanTPList.size(); ++i) {
+    std::size_t next = (i + 1) % chanTPList.size();
+    unsigned int channel = chanTPList[i].first;
+    unsigned int next_channel = next == 0 ? channel - 1 : chanTPList[next].first;
+    if (next_channel == channel)
+      continue;
+    if (win_adj.is_empty())
+      win_adj.add(chanTPList[i].second);
+    if (next_channel - channel == 1) {
+      win_adj.add(chanTPList[next].second);
+    } else if (next_channel - channel > 0 && next_channel - channel <= 5 && tol_count < s_tolerance) {
+      win_adj.add(chanTPList[next].second);
+      tol_count += next_channel - channel - 1;
+    } else if (win_adj.size() > s_threshold) {
+      win_adj_max = win_adj;
+      break;
+    } else {
+      tol_count = 0;
+      win_adj.clear();
+    }
+  }
+  return win_adj_max;
+}
+
+// Take the tracks out of the window one at a time, leaving out the channels of
+// each before looking for the next.
+std::size_t
+take_tracks_one_by_one(TPWindow& window)
+{
+  std::size_t n_tracks = 0;
+  TPWindow track;
+  while (true) {
+    TPWindow rest;
+    std::swap(rest, window);
+    for (std::size_t i = 0; i < rest.size(); ++i) {
+      bool new_tp = true;
+      for (std::size_t j = 0; j < track.size(); ++j) {
+        if (rest.at(i).channel == track.at(j).channel) {
+          new_tp = false;
+          break;
+        }
+      }
+      if (new_tp)
+        window.add(rest.at(i));
+    }
+    track = check_adjacency(window);
+    if (track.is_empty())
+      return n_tracks;
+    ++n_tracks;
+  }
+}
+
+// A window with tracks 30 channels long, 100 channels apart, with a second TP
+// on every fourth channel, and noise.
+std::vector<TriggerPrimitive>
+make_window(int n_tracks, int n_noise)
+{
+  std::mt19937 random(42);
+  std::vector<TriggerPrimitive> tps;
+  auto add_tp = [&](int channel) {
+    TriggerPrimitive tp;
+    tp.type = TriggerPrimitive::Type::kTPC;
+    tp.time_start = 1'000'000 + random() % (s_window_length - 100);
+    tp.time_over_threshold = 10;
+    tp.channel = channel;
+    tp.adc_integral = 1000;
+    tps.push_back(tp);
+  };
+  for (int track = 0; track < n_tracks; ++track) {
+    for (int channel = 100 * track; channel < 100 * track + 30; ++channel) {
+      add_tp(channel);
+      if (channel % 4 == 0)
+        add_tp(channel);
+    }
+  }
+  for (int i = 0; i < n_noise; ++i)
+    add_tp(random() % (100 * std::max(n_tracks, 1)));
+  std::sort(tps.begin(), tps.end(), [](const TriggerPrimitive& a, const TriggerPrimitive& b) {
+    return a.time_start < b.time_start;
+  });
+  return tps;
+}
+
+// Time `step` after `setup`, which is not timed, until at least s_min_seconds
+// have gone by in all, and return the mean time of a step.
+template<class Setup, class Step>
+double
+ns_per_step(Setup setup, Step step)
+{
+  double timed = 0;
+  std::size_t n_runs = 0;
+  Clock::time_point begin = Clock::now();
+  do {
+    setup();
+    Clock::time_point start = Clock::now();
+    step();
+    timed += std::chrono::duration<double>(Clock::now() - start).count();
+    ++n_runs;
+  } while (n_runs < 3 || std::chrono::duration<double>(Clock::now() - begin).count() < s_min_seconds);
+  return 1e9 * timed / n_runs;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  if (argc > 1)
+    s_min_seconds = std::strtod(argv[1], nullptr) / 1000;
+
+  std::printf("us per complete window, adjacency threshold %d, tolerance %d\n", s_threshold, s_tolerance);
+  std::printf("%8s %8s %8s %14s %14s %10s\n", "tracks", "noise", "tps", "one by one", "one walk", "speedup");
+
+  for (int n_noise : { 0, 500 }) {
+    for (int n_tracks : { 1, 4, 16, 64 }) {
+      std::vector<TriggerPrimitive> tps = make_window(n_tracks, n_noise);
+      TriggerPrimitive closing = tps.back();
+      closing.time_start = tps.front().time_start + s_window_length;
+
+      TPWindow window;
+      std::size_t old_tracks = 0;
+      double one_by_one = ns_per_step(
+        [&] {
+          window.clear();
+          for (const TriggerPrimitive& tp : tps)
+            window.add(tp);
+        },
+        [&] { old_tracks = take_tracks_one_by_one(window); });
+
+      std::unique_ptr<TriggerActivityMakerChannelAdjacency> maker;
+      std::vector<TriggerActivity> output_ta;
+      double one_walk = ns_per_step(
+        [&] {
+          maker = std::make_unique<TriggerActivityMakerChannelAdjacency>();
+          maker->configure({ { "window_length", s_window_length },
+                             { "adjacency_threshold", s_threshold },
+                             { "adj_tolerance", s_tolerance } });
+          for (const TriggerPrimitive& tp : tps)
+            (*maker)(tp, output_ta);
+          output_ta.clear();
+        },
+        [&] { (*maker)(closing, output_ta); });
+
+      std::printf("%8d %8d %8zu %14.1f %14.1f %10.1f\n",
+                  n_tracks,
+                  n_noise,
+                  tps.size(),
+                  one_by_one / 1000,
+                  one_walk / 1000,
+                  one_by_one / one_walk);
+      if (old_tracks != output_ta.size()) {
+        std::fprintf(stderr, "The methods disagree: %zu tracks against %zu\n", old_tracks, output_ta.size());
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
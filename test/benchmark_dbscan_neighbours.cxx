@@ -0,0 +1,109 @@
+/**
+ * @file benchmark_dbscan_neighbours.cxx
+ *
+ * Times the search for the neighbours of each new hit in IncrementalDBSCAN
+ * against the number of channels and the noise rate, on TPs from TPGenerator
+ * turned into hits as add_primitive() does. "time band" is
+ * dbscan::neighbours_sorted, which tries every hit within eps in time of the
+ * new one, whatever its channel; "index" is dbscan::HitIndex, which only
+ * tries the hits in the three columns of channels around it. Both forget the
+ * hits more than 10 eps old, as trim_hits() would with no cluster open. The
+ * times are per hit, including adding it.
+ *
+ * Usage: benchmark_dbscan_neighbours [n_tps]
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "triggeralgs/TPGenerator.hpp"
+#include "triggeralgs/dbscan/Hit.hpp"
+#include "triggeralgs/dbscan/dbscan.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <vector>
+
+using namespace triggeralgs;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+const float s_eps = 10;
+const int s_min_pts = 3;
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  std::size_t n_tps = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 100'000;
+
+  std::printf("ns per hit to find its neighbours, eps %.0f\n", s_eps);
+  std::printf(
+    "%9s %12s %12s %12s %12s %10s\n", "channels", "noise Hz/ch", "within eps", "time band", "index", "speedup");
+
+  for (int n_channels : { 256, 1024, 3072 }) {
+    for (double noise_rate_hz : { 1000.0, 10000.0, 50000.0 }) {
+      TPGenerator generator;
+      generator.configure({ { "n_channels", n_channels }, { "noise_rate_hz", noise_rate_hz }, { "track_rate_hz", 200 } });
+      std::vector<TriggerPrimitive> tps;
+      generator.generate(n_tps, tps);
+
+      std::deque<dbscan::Hit> hits;
+      std::vector<dbscan::Hit*> sorted;
+      std::size_t band_neighbours = 0;
+      std::size_t within_eps = 0;
+      Clock::time_point start = Clock::now();
+      for (const TriggerPrimitive& tp : tps) {
+        dbscan::Hit& hit = hits.emplace_back(1e-2 * (tp.time_start - tps.front().time_start), tp.channel);
+        sorted.push_back(&hit);
+        band_neighbours += dbscan::neighbours_sorted(sorted, hit, s_eps, s_min_pts);
+        if (sorted.size() % 64 == 0) {
+          auto last_it = std::lower_bound(sorted.begin(), sorted.end(), hit.time - 10 * s_eps, dbscan::time_comp_lower);
+          sorted.erase(sorted.begin(), last_it);
+          within_eps += sorted.end() - std::lower_bound(sorted.begin(), sorted.end(), hit.time - s_eps, dbscan::time_comp_lower);
+        }
+      }
+      double band = std::chrono::duration<double>(Clock::now() - start).count();
+
+      hits.clear();
+      sorted.clear();
+      dbscan::HitIndex index(s_eps);
+      std::size_t index_neighbours = 0;
+      start = Clock::now();
+      for (const TriggerPrimitive& tp : tps) {
+        dbscan::Hit& hit = hits.emplace_back(1e-2 * (tp.time_start - tps.front().time_start), tp.channel);
+        sorted.push_back(&hit);
+        index.add(&hit);
+        index_neighbours += index.neighbours(hit, s_min_pts);
+        if (sorted.size() % 64 == 0) {
+          auto last_it = std::lower_bound(sorted.begin(), sorted.end(), hit.time - 10 * s_eps, dbscan::time_comp_lower);
+          index.drop_oldest(last_it - sorted.begin());
+          sorted.erase(sorted.begin(), last_it);
+        }
+      }
+      double indexed = std::chrono::duration<double>(Clock::now() - start).count();
+
+      std::printf("%9d %12.0f %12.1f %12.1f %12.1f %10.1f\n",
+                  n_channels,
+                  noise_rate_hz,
+                  within_eps * 64.0 / n_tps,
+                  1e9 * band / n_tps,
+                  1e9 * indexed / n_tps,
+                  band / indexed);
+      if (band_neighbours != index_neighbours) {
+        std::fprintf(stderr, "The searches disagree: %zu neighbours against %zu\n", band_neighbours, index_neighbours);
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,112 @@
+/**
+ * @file benchmark_dbscan_threads.cxx
+ *
+ * Measures how the throughput of independent TriggerActivityMakerDBSCAN
+ * instances grows with the number run at once, one per thread, as with one
+ * maker per APA. Each instance has its own stream from TPGenerator and
+ * nothing is shared between them, so the total should grow in proportion to
+ * the instances up to the number of cores. Each run is checked against the
+ * same instances run one after the other on the caller's thread.
+ *
+ * Usage: benchmark_dbscan_threads [n_tps_per_instance] [max_instances]
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "triggeralgs/TPGenerator.hpp"
+#include "triggeralgs/dbscan/TriggerActivityMakerDBSCAN.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+using namespace triggeralgs;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Run a new maker over `tps` and return the number of TAs it made.
+std::size_t
+run(const std::vector<TriggerPrimitive>& tps)
+{
+  TriggerActivityMakerDBSCAN maker;
+  maker.configure({ { "min_pts", 3 }, { "eps", 10 } });
+  std::vector<TriggerActivity> output_ta;
+  for (const TriggerPrimitive& tp : tps)
+    maker(tp, output_ta);
+  maker.flush(tps.back().time_start + 1, output_ta);
+  return output_ta.size();
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  std::size_t n_tps = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 500'000;
+  std::size_t max_instances =
+    argc > 2 ? std::strtoull(argv[2], nullptr, 10) : std::max(1u, std::thread::hardware_concurrency());
+
+  std::vector<std::vector<TriggerPrimitive>> streams(max_instances);
+  for (std::size_t i = 0; i < max_instances; ++i) {
+    TPGenerator generator;
+    generator.configure({ { "seed", i + 1 }, { "noise_rate_hz", 2000 }, { "track_rate_hz", 200 } });
+    generator.generate(n_tps, streams[i]);
+  }
+
+  std::printf("TriggerActivityMakerDBSCAN, %zu TPs per instance, %u cores\n",
+              n_tps,
+              std::thread::hardware_concurrency());
+  std::printf("%10s %14s %14s %10s %13s\n", "instances", "serial MTP/s", "threads MTP/s", "speedup", "per instance");
+
+  for (std::size_t n_instances = 1; n_instances <= max_instances; n_instances *= 2) {
+    std::vector<std::size_t> serial_tas(n_instances);
+    Clock::time_point start = Clock::now();
+    for (std::size_t i = 0; i < n_instances; ++i)
+      serial_tas[i] = run(streams[i]);
+    double serial = std::chrono::duration<double>(Clock::now() - start).count();
+
+    // The threads start together, once they all exist.
+    std::vector<std::size_t> thread_tas(n_instances);
+    std::atomic<std::size_t> n_ready{ 0 };
+    std::atomic<bool> go{ false };
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < n_instances; ++i) {
+      threads.emplace_back([&, i] {
+        ++n_ready;
+        while (!go.load(std::memory_order_acquire))
+          std::this_thread::yield();
+        thread_tas[i] = run(streams[i]);
+      });
+    }
+    while (n_ready.load() != n_instances)
+      std::this_thread::yield();
+    start = Clock::now();
+    go.store(true, std::memory_order_release);
+    for (std::thread& thread : threads)
+      thread.join();
+    double parallel = std::chrono::duration<double>(Clock::now() - start).count();
+
+    double n_total = static_cast<double>(n_tps) * n_instances;
+    std::printf("%10zu %14.2f %14.2f %9.2fx %12.0f%%\n",
+                n_instances,
+                1e-6 * n_total / serial,
+                1e-6 * n_total / parallel,
+                serial / parallel,
+                100 * serial / parallel / n_instances);
+    if (thread_tas != serial_tas) {
+      std::fprintf(stderr, "The threaded instances made different TAs from the serial ones\n");
+      return 1;
+    }
+  }
+  return 0;
+}
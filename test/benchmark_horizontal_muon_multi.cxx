@@ -0,0 +1,100 @@
+/**
+ * @file benchmark_horizontal_muon_multi.cxx
+ *
+ * Compares K HorizontalMuon makers, one per parameter set, with one
+ * TriggerActivityMakerHorizontalMuonMulti evaluating the K sets together, on
+ * the same synthetic stream. The sets differ in their adjacency threshold and
+ * prescale, as in a threshold scan. Prints the time per TP of each, and the
+ * mean number of windows the multi maker keeps.
+ *
+ * Usage: benchmark_horizontal_muon_multi [n_tps]
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "triggeralgs/HorizontalMuon/TriggerActivityMakerHorizontalMuon.hpp"
+#include "triggeralgs/HorizontalMuon/TriggerActivityMakerHorizontalMuonMulti.hpp"
+#include "triggeralgs/TPGenerator.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <vector>
+
+using namespace triggeralgs;
+
+namespace {
+
+// The k-th of a scan of sets.
+nlohmann::json
+parameter_set(std::size_t k)
+{
+  return { { "adjacency_threshold", 8 + 2 * (k % 8) }, { "prescale", 1 + k / 8 } };
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  std::size_t n_tps = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+
+  TPGenerator generator;
+  generator.configure({ { "noise_rate_hz", 500 }, { "track_rate_hz", 200 } });
+  std::vector<TriggerPrimitive> tps;
+  generator.generate(n_tps, tps);
+
+  std::printf("ns per TP for K parameter sets\n");
+  std::printf("%4s %16s %16s %10s %14s\n", "K", "K makers", "multi maker", "speedup", "mean windows");
+
+  for (std::size_t n_sets : { 1, 2, 4, 8, 16, 32 }) {
+    std::vector<std::unique_ptr<TriggerActivityMakerHorizontalMuon>> makers;
+    nlohmann::json sets = nlohmann::json::array();
+    for (std::size_t k = 0; k < n_sets; ++k) {
+      makers.push_back(std::make_unique<TriggerActivityMakerHorizontalMuon>());
+      makers.back()->configure(parameter_set(k));
+      sets.push_back(parameter_set(k));
+    }
+    TriggerActivityMakerHorizontalMuonMulti multi;
+    multi.configure({ { "parameter_sets", sets } });
+
+    std::vector<TriggerActivity> output_ta;
+    std::size_t n_separate = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const TriggerPrimitive& tp : tps) {
+      for (auto& maker : makers)
+        (*maker)(tp, output_ta);
+      n_separate += output_ta.size();
+      output_ta.clear();
+    }
+    double separate = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::size_t n_together = 0;
+    double windows = 0;
+    start = std::chrono::steady_clock::now();
+    for (const TriggerPrimitive& tp : tps) {
+      multi(tp, output_ta);
+      n_together += output_ta.size();
+      output_ta.clear();
+      windows += multi.n_windows();
+    }
+    double together = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::printf("%4zu %16.1f %16.1f %10.2f %14.2f\n",
+                n_sets,
+                1e9 * separate / n_tps,
+                1e9 * together / n_tps,
+                separate / together,
+                windows / n_tps);
+    if (n_separate != n_together) {
+      std::fprintf(stderr, "The makers disagree: %zu TAs against %zu\n", n_separate, n_together);
+      return 1;
+    }
+  }
+  return 0;
+}
@@ -0,0 +1,690 @@
+/**
+ * @file benchmark_makers.cxx
+ *
+ * Replays TP streams through every TA maker and TC maker registered with the
+ * factories, each with a representative configuration, and writes the
+ * throughput, the outputs, the peak heap use and the allocations of each as
+ * JSON, so that releases can be compared. The streams are a synthetic one from
+ * TPGenerator, and any recorded streams given as text dumps, one TP per
+ * line as "time_start time_over_threshold time_peak channel adc_integral
+ * adc_peak detid type". The TC makers are fed the TPs of each stream grouped
+ * into TAs. The makers run in a scratch directory, removed at the end, so
+ * that any debugging files they write are not left behind; PlaneCoincidence's
+ * dumps of each TA's TPs are turned off, so that its numbers do not include
+ * them.
+ *
+ * Built with TRIGGERALGS_ALLOCATION_PROFILING, it also attributes every
+ * allocation to the maker being called, counts them per call, and keeps the
+ * call stack of each, so that the results show each maker's allocations per
+ * call in steady state and the code that makes them, and a summary of the
+ * worst offenders goes to stderr. Capturing the stacks slows the makers down
+ * by as much as they allocate, so the timings of such a build are not
+ * comparable with the others.
+ *
+ * Usage: benchmark_makers [n_tps] [tp_file ...] > results.json
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "triggeralgs/TPGenerator.hpp"
+#include "triggeralgs/TriggerActivityFactory.hpp"
+#include "triggeralgs/TriggerCandidateFactory.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <sys/resource.h>
+
+#ifdef TRIGGERALGS_ALLOCATION_PROFILING
+#include <cxxabi.h>
+#include <dlfcn.h>
+#include <execinfo.h>
+#endif
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+using namespace triggeralgs;
+
+namespace {
+
+// Every allocation in the process goes through the operator new below.
+std::atomic<uint64_t> s_n_allocations{ 0 };   // NOLINT(build/unsigned)
+std::atomic<uint64_t> s_allocated_bytes{ 0 }; // NOLINT(build/unsigned)
+std::atomic<int64_t> s_live_bytes{ 0 };
+std::atomic<int64_t> s_peak_live_bytes{ 0 };
+
+// Room in front of each block for its size, keeping the block aligned.
+constexpr std::size_t s_header = alignof(std::max_align_t);
+
+#ifdef TRIGGERALGS_ALLOCATION_PROFILING
+
+// The innermost frames of the stack of an allocation, below operator new.
+constexpr int s_stack_depth = 12;
+using Stack = std::array<void*, s_stack_depth>;
+
+struct StackHash
+{
+  std::size_t operator()(const Stack& stack) const
+  {
+    std::size_t hash = 0;
+    for (void* frame : stack)
+      hash = hash * 31 + reinterpret_cast<std::size_t>(frame);
+    return hash;
+  }
+};
+
+struct AllocationCount
+{
+  uint64_t n_allocations = 0; // NOLINT(build/unsigned)
+  uint64_t n_bytes = 0;       // NOLINT(build/unsigned)
+};
+
+// The allocations made by one maker over one run, call by call.
+struct AllocationProfile
+{
+  uint64_t n_calls = 0;                 // NOLINT(build/unsigned)
+  uint64_t n_allocating_calls = 0;      // NOLINT(build/unsigned)
+  uint64_t max_allocations_in_call = 0; // NOLINT(build/unsigned)
+  AllocationCount total;
+  // Over the second half of the inputs, once windows and buffers have grown
+  // to their working size.
+  uint64_t n_steady_calls = 0; // NOLINT(build/unsigned)
+  AllocationCount steady;
+  AllocationCount call; // In the call being made
+  std::unordered_map<Stack, AllocationCount, StackHash> stacks;
+
+  void end_call(bool in_steady_state)
+  {
+    ++n_calls;
+    if (call.n_allocations > 0)
+      ++n_allocating_calls;
+    max_allocations_in_call = std::max(max_allocations_in_call, call.n_allocations);
+    total.n_allocations += call.n_allocations;
+    total.n_bytes += call.n_bytes;
+    if (in_steady_state) {
+      ++n_steady_calls;
+      steady.n_allocations += call.n_allocations;
+      steady.n_bytes += call.n_bytes;
+    }
+    call = AllocationCount();
+  }
+};
+
+// The profile of the maker being run, if any. Allocations made while
+// recording one, eg by the map of stacks, are not themselves recorded.
+AllocationProfile* s_profile = nullptr;
+std::mutex s_profile_mutex;
+thread_local bool s_in_profiler = false;
+
+void
+profile_allocation(std::size_t size)
+{
+  if (s_profile == nullptr || s_in_profiler)
+    return;
+  s_in_profiler = true;
+
+  // Skip this function and the operator new that called it.
+  void* frames[s_stack_depth + 2];
+  int n_frames = backtrace(frames, s_stack_depth + 2);
+  Stack stack{};
+  for (int i = 2; i < n_frames; ++i)
+    stack[i - 2] = frames[i];
+
+  {
+    std::lock_guard<std::mutex> lock(s_profile_mutex);
+    if (s_profile != nullptr) {
+      ++s_profile->call.n_allocations;
+      s_profile->call.n_bytes += size;
+      AllocationCount& count = s_profile->stacks[stack];
+      ++count.n_allocations;
+      count.n_bytes += size;
+    }
+  }
+  s_in_profiler = false;
+}
+
+#endif
+
+void*
+counted_allocate(std::size_t size)
+{
+  char* block = static_cast<char*>(std::malloc(size + s_header));
+  if (block == nullptr)
+    throw std::bad_alloc();
+  *reinterpret_cast<std::size_t*>(block) = size;
+#ifdef TRIGGERALGS_ALLOCATION_PROFILING
+  profile_allocation(size);
+#endif
+
+  s_n_allocations.fetch_add(1, std::memory_order_relaxed);
+  s_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+  int64_t live = s_live_bytes.fetch_add(size, std::memory_order_relaxed) + size;
+  int64_t peak = s_peak_live_bytes.load(std::memory_order_relaxed);
+  while (live > peak && !s_peak_live_bytes.compare_exchange_weak(peak, live, std::memory_order_relaxed)) {
+  }
+  return block + s_header;
+}
+
+void
+counted_free(void* pointer)
+{
+  if (pointer == nullptr)
+    return;
+  char* block = static_cast<char*>(pointer) - s_header;
+  s_live_bytes.fetch_sub(*reinterpret_cast<std::size_t*>(block), std::memory_order_relaxed);
+  std::free(block);
+}
+
+} // namespace
+
+void*
+operator new(std::size_t size)
+{
+  return counted_allocate(size);
+}
+
+void*
+operator new[](std::size_t size)
+{
+  return counted_allocate(size);
+}
+
+void
+operator delete(void* pointer) noexcept
+{
+  counted_free(pointer);
+}
+
+void
+operator delete[](void* pointer) noexcept
+{
+  counted_free(pointer);
+}
+
+void
+operator delete(void* pointer, std::size_t) noexcept
+{
+  counted_free(pointer);
+}
+
+void
+operator delete[](void* pointer, std::size_t) noexcept
+{
+  counted_free(pointer);
+}
+
+namespace {
+
+// Algorithms that cannot run stand-alone (eg need an inference server).
+const std::vector<std::string> s_skipped = { "TriggerActivityMakerTritonPlugin" };
+
+// Configurations that make the makers do representative work on a stream of
+// noise and tracks. Anything not listed here is configured with an empty
+// object, ie with the maker's defaults.
+const std::map<std::string, nlohmann::json>&
+benchmark_configs()
+{
+  static const std::map<std::string, nlohmann::json> s_configs = {
+    { "TriggerActivityMakerPrescalePlugin", { { "prescale", 100 } } },
+    { "TriggerActivityMakerBundleNPlugin", { { "bundle_size", 100 } } },
+    { "TriggerActivityMakerADCSimpleWindowPlugin", { { "window_length", 10000 }, { "adc_threshold", 300000 } } },
+    { "TriggerActivityMakerHorizontalMuonPlugin",
+      { { "window_length", 8000 },
+        { "adjacency_threshold", 30 },
+        { "adj_tolerance", 3 },
+        { "trigger_on_adjacency", true },
+        { "trigger_on_adc", false },
+        { "trigger_on_n_channels", false } } },
+    { "TriggerActivityMakerHorizontalMuonMultiPlugin",
+      { { "window_length", 8000 },
+        { "adj_tolerance", 3 },
+        { "parameter_sets",
+          nlohmann::json::array({ { { "adjacency_threshold", 20 } },
+                                  { { "adjacency_threshold", 30 } },
+                                  { { "adjacency_threshold", 40 } },
+                                  { { "adjacency_threshold", 30 }, { "prescale", 10 } } }) } } },
+    { "TriggerActivityMakerChannelAdjacencyPlugin",
+      { { "window_length", 8000 }, { "adjacency_threshold", 30 }, { "adj_tolerance", 3 } } },
+    { "TriggerActivityMakerMichelElectronPlugin",
+      { { "window_length", 8000 }, { "adjacency_threshold", 30 }, { "trigger_on_adjacency", true } } },
+    { "TriggerActivityMakerChannelDistancePlugin",
+      { { "window_length", 8000 }, { "max_channel_distance", 50 }, { "min_tps", 20 } } },
+    { "TriggerActivityMakerDBSCANPlugin", { { "eps", 10 }, { "min_pts", 3 } } },
+    { "TriggerActivityMakerPlaneCoincidencePlugin", { { "dump_triggering_tps", false } } },
+    { "TriggerCandidateMakerPrescalePlugin", { { "prescale", 10 } } },
+    { "TriggerCandidateMakerBundleNPlugin", { { "bundle_size", 10 } } },
+    { "TriggerCandidateMakerHorizontalMuonPlugin", { { "trigger_on_adc", true } } },
+    { "TriggerCandidateMakerChannelAdjacencyPlugin", { { "trigger_on_adc", true } } },
+  };
+  return s_configs;
+}
+
+nlohmann::json
+config_for(const std::string& alg_name)
+{
+  auto it = benchmark_configs().find(alg_name);
+  return it == benchmark_configs().end() ? nlohmann::json::object() : it->second;
+}
+
+struct Stream
+{
+  std::string name;
+  std::vector<TriggerPrimitive> tps;
+  std::vector<TriggerActivity> tas;
+};
+
+// A seeded stream with every kind of activity TPGenerator makes, frequent
+// enough for the makers to see plenty of each.
+std::vector<TriggerPrimitive>
+make_synthetic_tps(size_t n_tps)
+{
+  TPGenerator generator;
+  generator.configure({ { "track_rate_hz", 200 },
+                        { "michel_rate_hz", 50 },
+                        { "supernova_rate_hz", 2000 },
+                        { "shower_rate_hz", 5 } });
+  std::vector<TriggerPrimitive> tps;
+  generator.generate(n_tps, tps);
+  return tps;
+}
+
+// A text dump, as written by the makers' dump_tp(). Dumps of triggered windows
+// can overlap, so the TPs are put back in time order, which the makers expect.
+std::vector<TriggerPrimitive>
+read_tps(const std::string& path)
+{
+  std::vector<TriggerPrimitive> tps;
+  std::ifstream file(path);
+  TriggerPrimitive tp;
+  int type = 0;
+  while (file >> tp.time_start >> tp.time_over_threshold >> tp.time_peak >> tp.channel >> tp.adc_integral >>
+         tp.adc_peak >> tp.detid >> type) {
+    tp.type = static_cast<TriggerPrimitive::Type>(type);
+    tps.push_back(tp);
+  }
+  std::stable_sort(tps.begin(), tps.end(), [](const TriggerPrimitive& a, const TriggerPrimitive& b) {
+    return a.time_start < b.time_start;
+  });
+  return tps;
+}
+
+// Group the TPs into fixed-size TAs for the TC makers.
+std::vector<TriggerActivity>
+make_tas(const std::vector<TriggerPrimitive>& tps, size_t tps_per_ta)
+{
+  std::vector<TriggerActivity> tas;
+  for (size_t first = 0; first + tps_per_ta <= tps.size(); first += tps_per_ta) {
+    TriggerActivity& ta = tas.emplace_back();
+    ta.inputs.assign(tps.begin() + first, tps.begin() + first + tps_per_ta);
+    ta.time_start = ta.inputs.front().time_start;
+    ta.time_end = ta.inputs.back().time_start + ta.inputs.back().time_over_threshold;
+    ta.channel_start = ta.inputs.front().channel;
+    ta.channel_end = ta.inputs.front().channel;
+    for (const auto& tp : ta.inputs) {
+      ta.time_end = std::max(ta.time_end, tp.time_start + tp.time_over_threshold);
+      ta.channel_start = std::min(ta.channel_start, tp.channel);
+      ta.channel_end = std::max(ta.channel_end, tp.channel);
+      ta.adc_integral += tp.adc_integral;
+      if (tp.adc_peak > ta.adc_peak) {
+        ta.adc_peak = tp.adc_peak;
+        ta.time_peak = tp.time_peak;
+        ta.channel_peak = tp.channel;
+      }
+    }
+    ta.time_activity = ta.time_peak;
+    ta.type = TriggerActivity::Type::kTPC;
+  }
+  return tas;
+}
+
+#ifdef TRIGGERALGS_ALLOCATION_PROFILING
+
+struct Frame
+{
+  std::string function; // Demangled, if the symbol is exported
+  std::string location; // Module and offset, for addr2line
+  bool in_library = false;
+};
+
+// Whether this is the standard library's code rather than the caller's, eg
+// vector growth.
+bool
+is_library_function(std::string_view function)
+{
+  // Template functions are demangled with their return type first.
+  std::size_t space = function.find(' ');
+  if (space != std::string_view::npos && space < function.find_first_of("<:("))
+    function.remove_prefix(space + 1);
+  for (std::string_view prefix : { "std::", "__gnu_cxx::", "operator new" })
+    if (function.substr(0, prefix.size()) == prefix)
+      return true;
+  return false;
+}
+
+const Frame&
+describe_frame(void* address)
+{
+  static std::map<void*, Frame> s_frames;
+  auto it = s_frames.find(address);
+  if (it != s_frames.end())
+    return it->second;
+
+  // Look up the call instruction rather than the return address after it.
+  const char* call = static_cast<const char*>(address) - 1;
+  Frame frame;
+  char location[64];
+  Dl_info info;
+  if (dladdr(call, &info) == 0 || info.dli_fname == nullptr) {
+    std::snprintf(location, sizeof(location), "%p", static_cast<const void*>(call));
+    frame.location = location;
+  } else {
+    std::string module = info.dli_fname;
+    module = module.substr(module.find_last_of('/') + 1);
+    std::snprintf(location, sizeof(location), "+0x%zx", static_cast<std::size_t>(call - static_cast<const char*>(info.dli_fbase)));
+    frame.location = module + location;
+    if (info.dli_sname != nullptr) {
+      int status = 0;
+      char* demangled = abi::__cxa_demangle(info.dli_sname, nullptr, nullptr, &status);
+      frame.function = status == 0 ? demangled : info.dli_sname;
+      std::free(demangled);
+    }
+    frame.in_library = module.find("libstdc++") != std::string::npos || is_library_function(frame.function);
+  }
+  return s_frames.emplace(address, frame).first->second;
+}
+
+// The allocation sites of a profile, ie the innermost frames of its stacks
+// that are not in the standard library, with the largest counts first.
+nlohmann::json
+allocation_report(const AllocationProfile& profile, std::size_t max_sites)
+{
+  struct Site
+  {
+    const Frame* frame = nullptr;
+    const Frame* caller = nullptr;
+    AllocationCount count;
+  };
+  std::map<std::string, Site> sites;
+  for (const auto& [stack, count] : profile.stacks) {
+    const Frame* frame = nullptr;
+    const Frame* caller = nullptr;
+    for (void* address : stack) {
+      if (address == nullptr)
+        break;
+      const Frame& candidate = describe_frame(address);
+      if (candidate.in_library)
+        continue;
+      if (frame == nullptr) {
+        frame = &candidate;
+      } else {
+        caller = &candidate;
+        break;
+      }
+    }
+    if (frame == nullptr)
+      frame = &describe_frame(stack[0]);
+
+    Site& site = sites[frame->location];
+    if (count.n_allocations > site.count.n_allocations || site.frame == nullptr) {
+      site.frame = frame;
+      site.caller = caller;
+    }
+    site.count.n_allocations += count.n_allocations;
+    site.count.n_bytes += count.n_bytes;
+  }
+
+  std::vector<const Site*> ranked;
+  for (const auto& [location, site] : sites)
+    ranked.push_back(&site);
+  std::sort(ranked.begin(), ranked.end(), [](const Site* a, const Site* b) {
+    return a->count.n_allocations > b->count.n_allocations;
+  });
+  if (ranked.size() > max_sites)
+    ranked.resize(max_sites);
+
+  const double n_calls = std::max<uint64_t>(profile.n_calls, 1);             // NOLINT(build/unsigned)
+  const double n_steady_calls = std::max<uint64_t>(profile.n_steady_calls, 1); // NOLINT(build/unsigned)
+  nlohmann::json report;
+  report["calls"] = profile.n_calls;
+  report["allocating_calls"] = profile.n_allocating_calls;
+  report["allocations"] = profile.total.n_allocations;
+  report["allocations_per_call"] = profile.total.n_allocations / n_calls;
+  report["bytes_per_call"] = profile.total.n_bytes / n_calls;
+  report["max_allocations_in_call"] = profile.max_allocations_in_call;
+  report["steady_state_allocations_per_call"] = profile.steady.n_allocations / n_steady_calls;
+  report["steady_state_bytes_per_call"] = profile.steady.n_bytes / n_steady_calls;
+  report["sites"] = nlohmann::json::array();
+  for (const Site* site : ranked) {
+    nlohmann::json entry;
+    entry["function"] = site->frame->function;
+    entry["location"] = site->frame->location;
+    if (site->caller != nullptr)
+      entry["called_from"] = site->caller->function.empty() ? site->caller->location : site->caller->function;
+    entry["allocations"] = site->count.n_allocations;
+    entry["bytes"] = site->count.n_bytes;
+    entry["allocations_per_call"] = site->count.n_allocations / n_calls;
+    report["sites"].push_back(entry);
+  }
+  return report;
+}
+
+// The makers that allocate the most per call in steady state, and where.
+void
+print_worst_offenders(const nlohmann::json& results, std::size_t max_makers, std::size_t max_sites)
+{
+  std::vector<const nlohmann::json*> ranked;
+  for (const nlohmann::json& entry : results)
+    if (entry.contains("allocation_profile"))
+      ranked.push_back(&entry);
+  std::sort(ranked.begin(), ranked.end(), [](const nlohmann::json* a, const nlohmann::json* b) {
+    return (*a)["allocation_profile"]["steady_state_allocations_per_call"].get<double>() >
+           (*b)["allocation_profile"]["steady_state_allocations_per_call"].get<double>();
+  });
+  if (ranked.size() > max_makers)
+    ranked.resize(max_makers);
+
+  std::fprintf(stderr, "\nMost allocations per call in steady state:\n");
+  for (const nlohmann::json* entry : ranked) {
+    const nlohmann::json& profile = (*entry)["allocation_profile"];
+    std::fprintf(stderr,
+                 "%-48s %-10s %8.2f allocs/call %10.1f B/call, max %llu in one call\n",
+                 (*entry)["algorithm"].get<std::string>().c_str(),
+                 (*entry)["stream"].get<std::string>().c_str(),
+                 profile["steady_state_allocations_per_call"].get<double>(),
+                 profile["steady_state_bytes_per_call"].get<double>(),
+                 profile["max_allocations_in_call"].get<unsigned long long>()); // NOLINT(runtime/int)
+    for (std::size_t i = 0; i < std::min(max_sites, profile["sites"].size()); ++i) {
+      const nlohmann::json& site = profile["sites"][i];
+      std::string function = site["function"].get<std::string>();
+      if (function.size() > 100)
+        function = function.substr(0, 97) + "...";
+      std::fprintf(stderr,
+                   "    %8.2f allocs/call  %s  %s\n",
+                   site["allocations_per_call"].get<double>(),
+                   function.empty() ? "?" : function.c_str(),
+                   site["location"].get<std::string>().c_str());
+    }
+  }
+}
+
+#endif
+
+// Feed the inputs one at a time to a configured maker, flush it, and measure.
+template<class Output, class Maker, class Input>
+nlohmann::json
+run(Maker& maker, const std::vector<Input>& inputs)
+{
+  std::vector<Output> outputs;
+  outputs.reserve(4096);
+  size_t n_outputs = 0;
+
+  const uint64_t allocations_before = s_n_allocations.load(); // NOLINT(build/unsigned)
+  const uint64_t bytes_before = s_allocated_bytes.load();     // NOLINT(build/unsigned)
+  const int64_t live_before = s_live_bytes.load();
+  s_peak_live_bytes.store(live_before);
+
+#ifdef TRIGGERALGS_ALLOCATION_PROFILING
+  AllocationProfile profile;
+  const size_t first_steady_input = inputs.size() / 2;
+  s_profile = &profile;
+#endif
+
+  auto start = std::chrono::steady_clock::now();
+  for (size_t i = 0; i < inputs.size(); ++i) {
+    maker(inputs[i], outputs);
+#ifdef TRIGGERALGS_ALLOCATION_PROFILING
+    {
+      std::lock_guard<std::mutex> lock(s_profile_mutex);
+      profile.end_call(i >= first_steady_input);
+    }
+#endif
+    if (outputs.size() >= 4096) {
+      n_outputs += outputs.size();
+      outputs.clear();
+    }
+  }
+  maker.flush(inputs.back().time_start + 1'000'000, outputs);
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+#ifdef TRIGGERALGS_ALLOCATION_PROFILING
+  {
+    std::lock_guard<std::mutex> lock(s_profile_mutex);
+    profile.end_call(false);
+    s_profile = nullptr;
+  }
+#endif
+  n_outputs += outputs.size();
+
+  nlohmann::json result;
+  result["inputs"] = inputs.size();
+  result["seconds"] = seconds;
+  result["inputs_per_second"] = inputs.size() / seconds;
+  result["ns_per_input"] = 1e9 * seconds / inputs.size();
+  result["outputs"] = n_outputs;
+  result["allocations"] = s_n_allocations.load() - allocations_before;
+  result["allocated_bytes"] = s_allocated_bytes.load() - bytes_before;
+  result["peak_heap_bytes"] = s_peak_live_bytes.load() - live_before;
+#ifdef TRIGGERALGS_ALLOCATION_PROFILING
+  result["allocation_profile"] = allocation_report(profile, 10);
+#endif
+  return result;
+}
+
+template<class Factory, class Input, class Output>
+void
+benchmark_all(const char* kind, const char* unit, const Stream& stream, const std::vector<Input>& inputs, nlohmann::json& results)
+{
+  if (inputs.empty())
+    return;
+
+  for (const std::string& alg_name : Factory::get_registered_algorithms()) {
+    if (std::find(s_skipped.begin(), s_skipped.end(), alg_name) != s_skipped.end())
+      continue;
+
+    nlohmann::json entry;
+    entry["algorithm"] = alg_name;
+    entry["kind"] = kind;
+    entry["input"] = unit;
+    entry["stream"] = stream.name;
+    entry["config"] = config_for(alg_name);
+
+    auto maker = Factory::get_instance()->build_maker(alg_name);
+    try {
+      maker->configure(entry["config"]);
+    } catch (const std::exception&) {
+      entry["status"] = "configuration rejected";
+      results.push_back(entry);
+      continue;
+    }
+
+    entry.update(run<Output>(*maker, inputs));
+    entry["status"] = "ok";
+    std::fprintf(stderr,
+                 "%-48s %-10s %10.3e %ss/s %8.1f ns/%s %8zu outputs\n",
+                 alg_name.c_str(),
+                 stream.name.c_str(),
+                 entry["inputs_per_second"].get<double>(),
+                 unit,
+                 entry["ns_per_input"].get<double>(),
+                 unit,
+                 entry["outputs"].get<size_t>());
+    results.push_back(entry);
+  }
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  size_t n_tps = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 1'000'000;
+
+  std::vector<Stream> streams;
+  streams.push_back({ "synthetic", make_synthetic_tps(n_tps), {} });
+  for (int i = 2; i < argc; ++i) {
+    Stream stream{ argv[i], read_tps(argv[i]), {} };
+    if (stream.tps.empty()) {
+      std::fprintf(stderr, "No TPs read from %s\n", argv[i]);
+      return 1;
+    }
+    streams.push_back(std::move(stream));
+  }
+
+  // Once the TP files are read, which may be named relative to the working
+  // directory, move to a scratch one.
+  std::string scratch_template = (std::filesystem::temp_directory_path() / "benchmark_makers.XXXXXX").string();
+  if (mkdtemp(scratch_template.data()) == nullptr) {
+    std::fprintf(stderr, "Could not make a scratch directory from %s\n", scratch_template.c_str());
+    return 1;
+  }
+  const std::filesystem::path scratch = scratch_template;
+  const std::filesystem::path original_directory = std::filesystem::current_path();
+  std::filesystem::current_path(scratch);
+
+  nlohmann::json report;
+  report["streams"] = nlohmann::json::array();
+  report["results"] = nlohmann::json::array();
+  for (Stream& stream : streams) {
+    stream.tas = make_tas(stream.tps, 16);
+    report["streams"].push_back({ { "name", stream.name }, { "tps", stream.tps.size() }, { "tas", stream.tas.size() } });
+
+    benchmark_all<TriggerActivityFactory, TriggerPrimitive, TriggerActivity>(
+      "TAM", "TP", stream, stream.tps, report["results"]);
+    benchmark_all<TriggerCandidateFactory, TriggerActivity, TriggerCandidate>(
+      "TCM", "TA", stream, stream.tas, report["results"]);
+  }
+
+  std::filesystem::current_path(original_directory);
+  std::filesystem::remove_all(scratch);
+
+  struct rusage usage;
+  getrusage(RUSAGE_SELF, &usage);
+  report["peak_rss_kb"] = usage.ru_maxrss;
+
+#ifdef TRIGGERALGS_ALLOCATION_PROFILING
+  print_worst_offenders(report["results"], 10, 3);
+#endif
+
+  std::cout << report.dump(2) << std::endl;
+  return 0;
+}
@@ -0,0 +1,66 @@
+/**
+ * @file benchmark_michel_electron.cxx
+ *
+ * Times MichelElectron's TA maker per TP as its window slides over a
+ * synthetic stream of noise, tracks and Michel electrons, against the window
+ * length and so the number of TPs it holds. The adjacency threshold is set
+ * out of reach, so that every TP past the first window length asks for the
+ * longest activity of the window and none of them stops it sliding, which is
+ * the maker's steady state: the time per TP should barely grow with the
+ * window.
+ *
+ * Usage: benchmark_michel_electron [n_tps]
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "triggeralgs/MichelElectron/TriggerActivityMakerMichelElectron.hpp"
+#include "triggeralgs/TPGenerator.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace triggeralgs;
+
+int
+main(int argc, char* argv[])
+{
+  std::size_t n_tps = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 200'000;
+
+  std::printf("ns per TP of the MichelElectron TA maker with a sliding window\n");
+  std::printf("%12s %10s %12s %10s\n", "noise Hz/ch", "window", "tps held", "ns/TP");
+
+  for (double noise_rate_hz : { 100.0, 1000.0 }) {
+    TPGenerator generator;
+    generator.configure({ { "noise_rate_hz", noise_rate_hz }, { "track_rate_hz", 200 }, { "michel_rate_hz", 50 } });
+    std::vector<TriggerPrimitive> tps;
+    generator.generate(n_tps, tps);
+
+    for (timestamp_t window_length : { 1000, 5000, 20000, 50000 }) {
+      TriggerActivityMakerMichelElectron maker;
+      maker.configure({ { "window_length", window_length }, { "adjacency_threshold", 60000 } });
+
+      std::vector<TriggerActivity> output_ta;
+      double tps_held = 0;
+      auto start = std::chrono::steady_clock::now();
+      for (const TriggerPrimitive& tp : tps) {
+        maker(tp, output_ta);
+        tps_held += maker.window_occupancy();
+      }
+      double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+      std::printf("%12.0f %10llu %12.0f %10.1f\n",
+                  noise_rate_hz,
+                  static_cast<unsigned long long>(window_length), // NOLINT(runtime/int)
+                  tps_held / n_tps,
+                  1e9 * seconds / n_tps);
+    }
+  }
+  return 0;
+}
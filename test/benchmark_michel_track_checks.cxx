@@ -0,0 +1,169 @@
+/**
+ * @file benchmark_michel_track_checks.cxx
+ *
+ * Times the Bragg peak and kink checks of MichelElectron on one track against
+ * the number of TPs in the track. "first" is the checks as they were at
+ * first, which allocate their intermediate lists and index the TPs with
+ * bounds checks and a modulo; "kernels" is MichelTrackChecks, which runs
+ * branch-free loops over flat arrays that it keeps between calls. The times
+ * are per track, for both checks together.
+ *
+ * Usage: benchmark_michel_track_checks [min_ms_per_point]
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "triggeralgs/MichelElectron/MichelTrackChecks.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+
+using namespace triggeralgs;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double s_min_seconds = 0.05;
+
+bool
+first_bragg_peak(const std::vector<TriggerPrimitive>& trackHits)
+{
+  std::vector<float> adc_means_list;
+  uint16_t convolve_value = 6;
+  for (uint16_t i = 0; i < trackHits.size(); ++i) {
+    float adc_sum = 0;
+    for (uint16_t j = i; j < i + convolve_value; ++j) {
+      int hit = (j) % trackHits.size();
+      adc_sum += trackHits.at(hit).adc_integral;
+    }
+    adc_means_list.push_back(adc_sum / convolve_value);
+  }
+
+  float ped = std::accumulate(adc_means_list.begin(), adc_means_list.end(), 0.0) / adc_means_list.size();
+  float charge = 0;
+  std::vector<float> charge_dumps;
+  for (auto a : adc_means_list) {
+    if (a > ped) {
+      charge += a;
+    } else if (a < ped && charge != 0) {
+      charge_dumps.push_back(charge);
+      charge = 0;
+    }
+  }
+  if (charge_dumps.empty())
+    return false;
+
+  float max_charge = *max_element(charge_dumps.begin(), charge_dumps.end());
+  return max_charge == charge_dumps.front() || max_charge == charge_dumps.back();
+}
+
+bool
+first_kinks(const std::vector<TriggerPrimitive>& finalHits)
+{
+  std::vector<float> runningGradient;
+  std::vector<float> runningMeanGradient;
+  for (std::size_t i = 0; i < finalHits.size() - 2; i++) {
+    if (finalHits.at(i + 2).channel == finalHits.at(i).channel ||
+        (finalHits.at(i + 2).time_start == finalHits.at(i).time_start)) {
+      continue;
+    }
+    int diff = finalHits.at(i + 2).time_start - finalHits.at(i).time_start;
+    if ((std::abs(diff) > 1000) || ((std::abs(finalHits.at(i + 2).channel - finalHits.at(i).channel) > 6))) {
+      continue;
+    }
+    float dz = (finalHits.at(i + 2).channel - finalHits.at(i).channel) * 4.67;
+    long long int dt = finalHits.at(i + 2).time_start - finalHits.at(i).time_start; // NOLINT(runtime/int)
+    float dx = dt * 0.028;
+    runningGradient.push_back(dz / dx);
+  }
+
+  if (runningGradient.size() > 10) {
+    for (std::size_t g = 0; g < runningGradient.size() - 1; g++)
+      runningMeanGradient.push_back((runningGradient.at(g) + runningGradient.at(g + 1)) / 2);
+    if (runningMeanGradient.size() > 10) {
+      float mean = (std::abs(std::accumulate(runningMeanGradient.begin(), runningMeanGradient.end(), 0.0))) /
+                   (runningMeanGradient.size());
+      return (std::abs(runningMeanGradient.front()) + mean > 2.5 * mean) ||
+             ((std::abs(runningMeanGradient.back() + mean)) > 2.5 * mean);
+    }
+  }
+  return false;
+}
+
+// A muon track over adjacent channels, a few skipped, ending in a Bragg peak
+// and a kink.
+std::vector<TriggerPrimitive>
+make_track(std::size_t length)
+{
+  std::mt19937 random(42);
+  std::vector<TriggerPrimitive> track;
+  double time = 1'000'000;
+  int channel = 100;
+  for (std::size_t i = 0; i < length; ++i) {
+    channel += random() % 10 == 0 ? 2 : 1;
+    time += (i + 10 < length ? 3.0 : -8.0) + static_cast<int>(random() % 3) - 1;
+    TriggerPrimitive tp;
+    tp.channel = channel;
+    tp.time_start = static_cast<timestamp_t>(time);
+    tp.adc_integral = 1000 + random() % 400 + (i + 10 < length ? 0 : 3000);
+    track.push_back(tp);
+  }
+  return track;
+}
+
+// The mean time of a call of `check`, which is repeated until at least
+// s_min_seconds have gone by.
+template<class Check>
+double
+ns_per_call(Check check)
+{
+  std::size_t n_calls = 0;
+  Clock::time_point start = Clock::now();
+  double seconds = 0;
+  do {
+    for (int i = 0; i < 10; ++i)
+      check();
+    n_calls += 10;
+    seconds = std::chrono::duration<double>(Clock::now() - start).count();
+  } while (seconds < s_min_seconds);
+  return 1e9 * seconds / n_calls;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  if (argc > 1)
+    s_min_seconds = std::strtod(argv[1], nullptr) / 1000;
+
+  std::printf("ns per track for the Bragg peak and kink checks together\n");
+  std::printf("%8s %12s %12s %10s\n", "tps", "first", "kernels", "speedup");
+
+  MichelTrackChecks checks;
+  for (std::size_t length : { 10, 20, 50, 100, 200, 500, 1000, 2000 }) {
+    std::vector<TriggerPrimitive> track = make_track(length);
+    bool first_result = first_bragg_peak(track) && first_kinks(track);
+    bool kernels_result = checks.has_bragg_peak(track) && checks.has_kinks(track);
+    if (first_result != kernels_result) {
+      std::fprintf(stderr, "The checks disagree on a track of %zu TPs\n", length);
+      return 1;
+    }
+
+    // Both checks run on every call, whatever the first one finds.
+    volatile bool sink = false;
+    double first = ns_per_call([&] { sink = first_bragg_peak(track) ^ first_kinks(track); });
+    double kernels = ns_per_call([&] { sink = checks.has_bragg_peak(track) ^ checks.has_kinks(track); });
+    std::printf("%8zu %12.1f %12.1f %10.1f\n", length, first, kernels, first / kernels);
+  }
+  return 0;
+}
@@ -0,0 +1,383 @@
+/**
+ * @file benchmark_primitives.cxx
+ *
+ * Measures the building blocks of the makers on their own, as a function of
+ * how full they are: TPWindow add/move/reset/n_channels_hit, TAWindow
+ * add/move, dbscan::HitSet::insert, dbscan::neighbours_sorted and
+ * IncrementalDBSCAN::add_primitive, alone and with many clusters open. Each is swept over its occupancy, and
+ * where it matters the spread of channels, and printed as a table of ns per
+ * operation, one row per point of the curve, so that a regression in one of
+ * them shows up before it is lost in the end-to-end maker numbers. The
+ * allocations per TP of IncrementalDBSCAN are counted too, by replacing the
+ * global operator new.
+ *
+ * Usage: benchmark_primitives [min_ms_per_point]
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "triggeralgs/TAWindow.hpp"
+#include "triggeralgs/TPGenerator.hpp"
+#include "triggeralgs/TPWindow.hpp"
+#include "triggeralgs/dbscan/Hit.hpp"
+#include "triggeralgs/dbscan/dbscan.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <new>
+#include <random>
+#include <vector>
+
+using namespace triggeralgs;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double s_min_seconds = 0.02;
+
+// Time `step`, which does n_ops operations, after `setup`, which is not
+// timed, until at least s_min_seconds have gone by in all, and return the
+// mean time per operation.
+template<class Setup, class Step>
+double
+ns_per_op(std::size_t n_ops, Setup setup, Step step)
+{
+  setup();
+  step();
+
+  double timed = 0;
+  std::size_t n_runs = 0;
+  Clock::time_point begin = Clock::now();
+  do {
+    setup();
+    Clock::time_point start = Clock::now();
+    step();
+    timed += std::chrono::duration<double>(Clock::now() - start).count();
+    ++n_runs;
+  } while (n_runs < 3 || std::chrono::duration<double>(Clock::now() - begin).count() < s_min_seconds);
+  return 1e9 * timed / (n_runs * n_ops);
+}
+
+// Keeps a value alive, so that the work producing it is not optimised away.
+volatile uint64_t s_sink = 0; // NOLINT(build/unsigned)
+
+// The number of calls to operator new so far.
+std::size_t s_n_allocations = 0;
+
+// TPs one tick apart, spread over n_channels channels.
+std::vector<TriggerPrimitive>
+make_tps(std::size_t n_tps, int n_channels)
+{
+  std::vector<TriggerPrimitive> tps(n_tps);
+  for (std::size_t i = 0; i < n_tps; ++i) {
+    tps[i].type = TriggerPrimitive::Type::kTPC;
+    tps[i].time_start = 1'000'000 + i;
+    tps[i].time_over_threshold = 10;
+    tps[i].channel = static_cast<channel_t>((i * 7919) % n_channels);
+    tps[i].adc_integral = 1000 + i % 100;
+  }
+  return tps;
+}
+
+void
+benchmark_tp_window()
+{
+  std::printf("TPWindow: ns per operation against the TPs in the window and the channels they cover\n");
+  std::printf("%8s %8s %10s %10s %10s %14s\n", "tps", "channels", "add", "move", "reset", "n_channels_hit");
+
+  for (int n_channels : { 16, 256, 4096 }) {
+    for (std::size_t n_tps : { 16, 64, 256, 1024, 4096, 16384 }) {
+      const std::size_t n_steps = 4096;
+      std::vector<TriggerPrimitive> tps = make_tps(n_tps + n_steps, n_channels);
+      TPWindow window;
+
+      // Fill an empty window.
+      double add = ns_per_op(
+        n_tps, [&] { window.clear(); }, [&] {
+          for (std::size_t i = 0; i < n_tps; ++i)
+            window.add(tps[i]);
+        });
+
+      // Slide a full window on by a TP at a time, so that each move adds one
+      // TP and expires another.
+      const timestamp_t window_length = n_tps;
+      double move = ns_per_op(
+        n_steps,
+        [&] {
+          window.clear();
+          for (std::size_t i = 0; i < n_tps; ++i)
+            window.add(tps[i]);
+        },
+        [&] {
+          for (std::size_t i = n_tps; i < n_tps + n_steps; ++i)
+            window.move(tps[i], window_length);
+        });
+
+      // Empty a full window and start it again.
+      double reset = ns_per_op(
+        1,
+        [&] {
+          window.clear();
+          for (std::size_t i = 0; i < n_tps; ++i)
+            window.add(tps[i]);
+        },
+        [&] { window.reset(tps[n_tps]); });
+
+      // Read through a volatile pointer, so that the query is not hoisted out
+      // of the loop.
+      window.clear();
+      for (std::size_t i = 0; i < n_tps; ++i)
+        window.add(tps[i]);
+      TPWindow* volatile full_window = &window;
+      double n_channels_hit = ns_per_op(
+        n_steps, [] {}, [&] {
+          uint64_t sum = 0; // NOLINT(build/unsigned)
+          for (std::size_t i = 0; i < n_steps; ++i)
+            sum += full_window->n_channels_hit();
+          s_sink = sum;
+        });
+
+      std::printf("%8zu %8d %10.1f %10.1f %10.1f %14.1f\n", n_tps, n_channels, add, move, reset, n_channels_hit);
+    }
+  }
+  std::printf("\n");
+}
+
+void
+benchmark_ta_window()
+{
+  std::printf("TAWindow: ns per operation against the TAs in the window and their TPs\n");
+  std::printf("%8s %8s %10s %10s\n", "tas", "tps/ta", "add", "move");
+
+  for (std::size_t tps_per_ta : { 4, 32, 256 }) {
+    for (std::size_t n_tas : { 4, 16, 64, 256, 1024 }) {
+      const std::size_t n_steps = 1024;
+      std::vector<TriggerPrimitive> tps = make_tps((n_tas + n_steps) * tps_per_ta, 2560);
+      std::vector<TriggerActivity> tas(n_tas + n_steps);
+      for (std::size_t i = 0; i < tas.size(); ++i) {
+        TriggerActivity& ta = tas[i];
+        ta.inputs.assign(tps.begin() + i * tps_per_ta, tps.begin() + (i + 1) * tps_per_ta);
+        ta.time_start = 1'000'000 + 10 * i;
+        ta.adc_integral = 1000;
+      }
+      TAWindow window;
+
+      double add = ns_per_op(
+        n_tas, [&] { window.clear(); }, [&] {
+          for (std::size_t i = 0; i < n_tas; ++i)
+            window.add(tas[i]);
+        });
+
+      const timestamp_t window_length = 10 * n_tas;
+      double move = ns_per_op(
+        n_steps,
+        [&] {
+          window.clear();
+          for (std::size_t i = 0; i < n_tas; ++i)
+            window.add(tas[i]);
+        },
+        [&] {
+          for (std::size_t i = n_tas; i < n_tas + n_steps; ++i)
+            window.move(tas[i], window_length);
+        });
+
+      std::printf("%8zu %8zu %10.1f %10.1f\n", n_tas, tps_per_ta, add, move);
+    }
+  }
+  std::printf("\n");
+}
+
+void
+benchmark_hit_set()
+{
+  std::printf("dbscan::HitSet::insert: ns per insert against the size of the set and the order of the hits\n");
+  std::printf("%8s %10s %10s %10s\n", "hits", "in order", "reversed", "random");
+
+  for (std::size_t n_hits : { 4, 16, 64, 256, 1024, 4096 }) {
+    std::vector<dbscan::Hit> hits;
+    hits.reserve(n_hits);
+    for (std::size_t i = 0; i < n_hits; ++i)
+      hits.emplace_back(static_cast<float>(i), static_cast<int>(i % 64));
+
+    std::vector<dbscan::Hit*> in_order;
+    for (dbscan::Hit& hit : hits)
+      in_order.push_back(&hit);
+    std::vector<dbscan::Hit*> reversed(in_order.rbegin(), in_order.rend());
+    std::vector<dbscan::Hit*> random = in_order;
+    std::shuffle(random.begin(), random.end(), std::mt19937(42));
+
+    double ns[3];
+    int column = 0;
+    for (const std::vector<dbscan::Hit*>* order : { &in_order, &reversed, &random }) {
+      dbscan::HitSet set;
+      ns[column++] = ns_per_op(
+        n_hits, [&] { set.clear(); }, [&] {
+          for (dbscan::Hit* hit : *order)
+            set.insert(hit);
+        });
+    }
+    std::printf("%8zu %10.1f %10.1f %10.1f\n", n_hits, ns[0], ns[1], ns[2]);
+  }
+  std::printf("\n");
+}
+
+void
+benchmark_neighbours_sorted()
+{
+  std::printf("dbscan::neighbours_sorted: ns per search for the latest hit against the hits within eps of it\n");
+  std::printf("%10s %10s %12s\n", "within eps", "neighbours", "ns/search");
+
+  const float eps = 10;
+  const int min_pts = 3;
+  const std::size_t n_hits = 100000;
+  for (int hits_per_eps : { 1, 4, 16, 64, 256, 1024 }) {
+    std::vector<dbscan::Hit> hits;
+    hits.reserve(n_hits + 1);
+    std::mt19937 random(42);
+    for (std::size_t i = 0; i < n_hits; ++i)
+      hits.emplace_back(static_cast<float>(i) * eps / hits_per_eps, static_cast<int>(random() % 32));
+    std::vector<dbscan::Hit*> sorted;
+    for (dbscan::Hit& hit : hits)
+      sorted.push_back(&hit);
+    dbscan::Hit& query = hits.emplace_back(hits.back().time, 16);
+
+    const std::size_t n_searches = 256;
+    int n_neighbours = 0;
+    double search = ns_per_op(
+      n_searches, [] {}, [&] {
+        for (std::size_t i = 0; i < n_searches; ++i) {
+          query.neighbours.clear();
+          n_neighbours = dbscan::neighbours_sorted(sorted, query, eps, min_pts);
+        }
+      });
+    std::printf("%10d %10d %12.1f\n", hits_per_eps, n_neighbours, search);
+  }
+  std::printf("\n");
+}
+
+void
+benchmark_incremental_dbscan()
+{
+  std::printf("IncrementalDBSCAN::add_primitive and trim_hits: ns per TP against the noise rate and eps\n");
+  std::printf("%12s %6s %12s %10s %12s %10s\n", "noise Hz/ch", "eps", "hits held", "clusters", "ns/TP", "allocs/TP");
+
+  const std::size_t n_tps = 100000;
+  for (double noise_rate_hz : { 100.0, 1000.0, 10000.0 }) {
+    TPGenerator generator;
+    generator.configure({ { "noise_rate_hz", noise_rate_hz }, { "track_rate_hz", 200 }, { "shower_rate_hz", 5 } });
+    std::vector<TriggerPrimitive> tps;
+    generator.generate(n_tps, tps);
+
+    for (float eps : { 5.0f, 10.0f, 20.0f }) {
+      std::unique_ptr<dbscan::IncrementalDBSCAN> dbscan;
+      std::vector<dbscan::Cluster> clusters;
+      std::size_t hits_held = 0;
+      std::size_t n_clusters = 0;
+      std::size_t n_allocations = 0;
+      double add = ns_per_op(
+        n_tps,
+        [&] {
+          dbscan = std::make_unique<dbscan::IncrementalDBSCAN>(eps, 3);
+          hits_held = 0;
+          n_clusters = 0;
+        },
+        [&] {
+          std::size_t first_allocation = s_n_allocations;
+          for (std::size_t i = 0; i < n_tps; ++i) {
+            // As the maker does, dropping the hits that can no longer join a cluster.
+            dbscan->add_primitive(tps[i], &clusters);
+            dbscan->trim_hits();
+            if (i % 64 == 0)
+              hits_held += dbscan->n_hits();
+            n_clusters += clusters.size();
+            clusters.clear();
+          }
+          n_allocations = s_n_allocations - first_allocation;
+        });
+      std::printf("%12.0f %6.0f %12.1f %10zu %12.1f %10.2f\n",
+                  noise_rate_hz,
+                  eps,
+                  hits_held * 64.0 / n_tps,
+                  n_clusters,
+                  add,
+                  static_cast<double>(n_allocations) / n_tps);
+    }
+  }
+  std::printf("\n");
+}
+
+void
+benchmark_open_clusters()
+{
+  std::printf("IncrementalDBSCAN::add_point and trim_hits: ns per hit against the number of clusters open\n");
+  std::printf("%10s %12s\n", "clusters", "ns/hit");
+
+  // Parallel tracks on channels far apart, one hit per track per tick, which
+  // keep a cluster each open throughout, plus one short track that completes
+  // every 20 ticks.
+  const std::size_t n_hits = 100000;
+  for (int n_tracks : { 1, 10, 100, 1000 }) {
+    const int n_ticks = n_hits / (n_tracks + 1);
+    std::unique_ptr<dbscan::IncrementalDBSCAN> dbscan;
+    std::vector<dbscan::Cluster> clusters;
+    double add = ns_per_op(
+      static_cast<std::size_t>(n_ticks) * (n_tracks + 1),
+      [&] { dbscan = std::make_unique<dbscan::IncrementalDBSCAN>(2.5, 3); },
+      [&] {
+        for (int tick = 0; tick < n_ticks; ++tick) {
+          for (int track = 0; track < n_tracks; ++track)
+            dbscan->add_point(tick, 10 * track + tick % 2, &clusters);
+          dbscan->add_point(tick, tick % 20 < 10 ? -10 : -1000, &clusters);
+          dbscan->trim_hits();
+          clusters.clear();
+        }
+      });
+    std::printf("%10d %12.1f\n", n_tracks, add);
+  }
+  std::printf("\n");
+}
+
+} // namespace
+
+void*
+operator new(std::size_t size)
+{
+  ++s_n_allocations;
+  if (void* p = std::malloc(size == 0 ? 1 : size))
+    return p;
+  throw std::bad_alloc();
+}
+
+void
+operator delete(void* p) noexcept
+{
+  std::free(p);
+}
+
+void
+operator delete(void* p, std::size_t) noexcept
+{
+  std::free(p);
+}
+
+int
+main(int argc, char* argv[])
+{
+  if (argc > 1)
+    s_min_seconds = std::strtod(argv[1], nullptr) / 1000;
+
+  benchmark_tp_window();
+  benchmark_ta_window();
+  benchmark_hit_set();
+  benchmark_neighbours_sorted();
+  benchmark_incremental_dbscan();
+  benchmark_open_clusters();
+  return 0;
+}
@@ -0,0 +1,125 @@
+/**
+ * @file benchmark_reorder_buffer.cxx
+ *
+ * Measures the insert and release cost per TP of ReorderBuffer on a stream
+ * merged from several links, each delivering its time-ordered TPs in blocks,
+ * so that the merged stream is out of order by up to a block's duration. A
+ * small fraction of TPs is delayed past the maximum lateness, to be dropped.
+ *
+ * Usage: benchmark_reorder_buffer [n_tps] [block_size]
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "triggeralgs/ReorderBuffer.hpp"
+#include "triggeralgs/TriggerPrimitive.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+using namespace triggeralgs;
+
+namespace {
+
+// Mean spacing of the TPs on one link, in ticks.
+const timestamp_t tp_spacing = 32;
+
+std::vector<TriggerPrimitive>
+make_stream(size_t n_tps, size_t n_links, size_t block_size, timestamp_t straggler_delay)
+{
+  std::mt19937_64 rng(1234);
+  std::uniform_int_distribution<timestamp_t> jitter(0, tp_spacing - 1);
+  std::uniform_int_distribution<int> straggler(0, 999);
+
+  // Each link's TPs in time order, all links on the same clock.
+  std::vector<std::vector<TriggerPrimitive>> links(n_links);
+  for (size_t link = 0; link < n_links; ++link) {
+    for (size_t i = 0; i < n_tps / n_links; ++i) {
+      timestamp_t time = 1'000'000 + i * tp_spacing + jitter(rng);
+      TriggerPrimitive tp;
+      tp.time_start = time;
+      tp.time_over_threshold = 10;
+      tp.time_peak = time + 5;
+      tp.channel = static_cast<channel_t>(link * 256 + i % 256);
+      tp.adc_integral = 1000;
+      tp.adc_peak = 100;
+      links[link].push_back(tp);
+    }
+  }
+
+  // Interleave the links block by block, then hold back one TP in a thousand.
+  std::vector<TriggerPrimitive> stream;
+  stream.reserve(n_tps);
+  for (size_t block = 0; block * block_size < n_tps / n_links; ++block)
+    for (const auto& link : links)
+      for (size_t i = block * block_size; i < std::min(link.size(), (block + 1) * block_size); ++i)
+        stream.push_back(link[i]);
+
+  for (size_t i = 0; i < stream.size(); ++i) {
+    if (straggler(rng) != 0)
+      continue;
+    size_t j = i;
+    while (j + 1 < stream.size() && stream[j + 1].time_start < stream[i].time_start + straggler_delay)
+      ++j;
+    std::rotate(stream.begin() + i, stream.begin() + i + 1, stream.begin() + j + 1);
+  }
+  return stream;
+}
+
+void
+run(size_t n_tps, size_t n_links, size_t block_size)
+{
+  // A block of one link spans about block_size * tp_spacing ticks.
+  const timestamp_t max_lateness = 2 * block_size * tp_spacing;
+  std::vector<TriggerPrimitive> stream = make_stream(n_tps, n_links, block_size, 4 * max_lateness);
+
+  ReorderBuffer<TriggerPrimitive> buffer(max_lateness, 1 << 16);
+  timestamp_t previous = 0;
+  uint64_t checksum = 0; // NOLINT(build/unsigned)
+  bool in_order = true;
+  auto release = [&](const TriggerPrimitive& tp) {
+    in_order &= tp.time_start >= previous;
+    previous = tp.time_start;
+    checksum += tp.time_start;
+  };
+
+  auto start = std::chrono::steady_clock::now();
+  for (const TriggerPrimitive& tp : stream)
+    buffer.push(tp, release);
+  buffer.drain(release);
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  const auto& counters = buffer.counters();
+  std::printf("%3zu links  max lateness %7llu ticks  %6.2f ns/TP  %7.1f MTP/s  max buffered %6zu  late %6llu"
+              "  overflow %llu%s\n",
+              n_links,
+              static_cast<unsigned long long>(max_lateness), // NOLINT(runtime/int)
+              1e9 * seconds / stream.size(),
+              1e-6 * stream.size() / seconds,
+              counters.max_buffered,
+              static_cast<unsigned long long>(counters.n_late),     // NOLINT(runtime/int)
+              static_cast<unsigned long long>(counters.n_overflow), // NOLINT(runtime/int)
+              in_order && counters.n_released + counters.n_late == stream.size() ? "" : "  OUT OF ORDER");
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  size_t n_tps = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4'000'000;
+  size_t block_size = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 64;
+
+  std::printf("%zu TPs, blocks of %zu TPs per link\n", n_tps, block_size);
+  for (size_t n_links : { 1, 2, 4, 8, 16, 32 })
+    run(n_tps, n_links, block_size);
+
+  return 0;
+}
@@ -0,0 +1,154 @@
+/**
+ * @file benchmark_sharding.cxx
+ *
+ * Measures how the throughput of ShardedTriggerActivityMaker scales with the
+ * number of shards, each on its own pinned thread. Each sharded run is compared
+ * with the same instances run one after the other on the caller's thread, over
+ * the same split of the stream, so that both do the same work. The stream
+ * interleaves the TPs of many detector elements (detids), each with its own
+ * noise and tracks.
+ *
+ * Usage: benchmark_sharding [algorithm] [n_tps] [max_shards]
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "triggeralgs/ShardedTriggerActivityMaker.hpp"
+#include "triggeralgs/TriggerActivityFactory.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace triggeralgs;
+
+namespace {
+
+const detid_t n_detids = 64;
+
+// Time-ordered TPs spread over n_detids detector elements, with a short
+// track on one of them every few thousand TPs.
+std::vector<TriggerPrimitive>
+make_tps(size_t n_tps)
+{
+  std::vector<TriggerPrimitive> tps(n_tps);
+  uint64_t state = 0x2545F4914F6CDD1DULL; // NOLINT(build/unsigned)
+  auto next = [&state]() {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+  };
+
+  timestamp_t time = 1'000'000;
+  size_t track_left = 0;
+  detid_t track_detid = 0;
+  channel_t track_channel = 0;
+  for (auto& tp : tps) {
+    time += next() % 4;
+    tp.type = TriggerPrimitive::Type::kTPC;
+    tp.time_start = time;
+    tp.time_over_threshold = 10 + next() % 40;
+    tp.time_peak = tp.time_start + tp.time_over_threshold / 2;
+    tp.adc_integral = 500 + next() % 5000;
+    tp.adc_peak = 20 + next() % 200;
+
+    if (track_left == 0 && next() % 4000 == 0) {
+      track_left = 60;
+      track_detid = next() % n_detids;
+      track_channel = next() % 2000;
+    }
+    if (track_left != 0) {
+      --track_left;
+      tp.detid = track_detid;
+      tp.channel = track_channel++;
+    } else {
+      tp.detid = next() % n_detids;
+      tp.channel = next() % 2560;
+    }
+  }
+  return tps;
+}
+
+struct Result
+{
+  double seconds = 0;
+  size_t n_tas = 0;
+};
+
+Result
+run(TriggerActivityMaker& maker, const std::vector<TriggerPrimitive>& tps)
+{
+  std::vector<TriggerActivity> output_ta;
+  output_ta.reserve(tps.size() / 10);
+  auto start = std::chrono::steady_clock::now();
+  for (const TriggerPrimitive& tp : tps)
+    maker(tp, output_ta);
+  maker.flush(tps.back().time_start + 1, output_ta);
+  Result result;
+  result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  result.n_tas = output_ta.size();
+  return result;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  std::string algorithm = argc > 1 ? argv[1] : "TriggerActivityMakerDBSCANPlugin";
+  size_t n_tps = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 4'000'000;
+  size_t max_shards = argc > 3 ? std::strtoull(argv[3], nullptr, 10) : std::thread::hardware_concurrency();
+  max_shards = std::max<size_t>(max_shards, 1);
+
+  std::vector<TriggerPrimitive> tps = make_tps(n_tps);
+  nlohmann::json config = { { "algorithm", algorithm }, { "shard_by", "detid" }, { "pin_threads", true } };
+
+  std::printf("%s, %zu TPs on %u detids, %u cores\n",
+              algorithm.c_str(),
+              tps.size(),
+              static_cast<unsigned>(n_detids),
+              std::thread::hardware_concurrency());
+
+  for (size_t n_shards = 1; n_shards <= max_shards; n_shards *= 2) {
+    ShardedTriggerActivityMaker sharded;
+    config["n_shards"] = n_shards;
+    sharded.configure(config);
+
+    // The same shards in series.
+    Result serial;
+    for (size_t shard = 0; shard < n_shards; ++shard) {
+      std::vector<TriggerPrimitive> shard_tps;
+      for (const TriggerPrimitive& tp : tps)
+        if (sharded.shard_of(tp) == shard)
+          shard_tps.push_back(tp);
+      if (shard_tps.empty())
+        continue;
+      std::unique_ptr<TriggerActivityMaker> single = TriggerActivityFactory::get_instance()->build_maker(algorithm);
+      single->configure(config);
+      Result result = run(*single, shard_tps);
+      serial.seconds += result.seconds;
+      serial.n_tas += result.n_tas;
+    }
+
+    Result parallel = run(sharded, tps);
+    std::printf("%3zu shards  serial %8.2f MTP/s  sharded %8.2f MTP/s  %7.2f ns/TP  %8zu TAs  speedup %5.2fx%s\n",
+                n_shards,
+                1e-6 * tps.size() / serial.seconds,
+                1e-6 * tps.size() / parallel.seconds,
+                1e9 * parallel.seconds / tps.size(),
+                parallel.n_tas,
+                serial.seconds / parallel.seconds,
+                serial.n_tas == parallel.n_tas ? "" : "  TA COUNT MISMATCH");
+  }
+
+  return 0;
+}
@@ -0,0 +1,360 @@
+/**
+ * @file benchmark_sliding_window.cxx
+ *
+ * Compares the SlidingWindow instantiations (TPWindow, TAWindow and the
+ * ADCSimpleWindow window) with the hand-written window classes they replace,
+ * by sliding each over the same synthetic stream and reading the aggregates
+ * after every step, as the makers do.
+ *
+ * Usage: benchmark_sliding_window [n_tps] [window_length]
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "triggeralgs/ChannelOccupancy.hpp"
+#include "triggeralgs/SlidingWindow.hpp"
+#include "triggeralgs/SlidingWindowAggregators.hpp"
+#include "triggeralgs/TAWindow.hpp"
+#include "triggeralgs/TPWindow.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+using namespace triggeralgs;
+
+namespace legacy {
+
+// The windows as they were written before SlidingWindow, trimmed to what the
+// benchmark calls.
+
+// ADCSimpleWindow's window: a vector of TPs, erased from the front.
+class ADCWindow
+{
+public:
+  bool is_empty() const { return tp_list.empty(); }
+  void add(TriggerPrimitive const& input_tp)
+  {
+    adc_integral += input_tp.adc_integral;
+    tp_list.push_back(input_tp);
+  }
+  void move(TriggerPrimitive const& input_tp, timestamp_t const& window_length)
+  {
+    uint32_t n_tps_to_erase = 0;
+    for (auto tp : tp_list) {
+      if (!(input_tp.time_start - tp.time_start < window_length)) {
+        n_tps_to_erase++;
+        adc_integral -= tp.adc_integral;
+      } else
+        break;
+    }
+    tp_list.erase(tp_list.begin(), tp_list.begin() + n_tps_to_erase);
+    if (tp_list.size() != 0) {
+      time_start = tp_list.front().time_start;
+      add(input_tp);
+    } else
+      reset(input_tp);
+  }
+  void reset(TriggerPrimitive const& input_tp)
+  {
+    tp_list.clear();
+    time_start = input_tp.time_start;
+    adc_integral = input_tp.adc_integral;
+    tp_list.push_back(input_tp);
+  }
+
+  timestamp_t time_start = 0;
+  uint32_t adc_integral = 0;
+  std::vector<TriggerPrimitive> tp_list;
+};
+
+// TPWindow: a power-of-two ring of TPs plus channel occupancy.
+class TPWindow
+{
+public:
+  bool is_empty() const { return m_size == 0; }
+  void add(TriggerPrimitive const& input_tp)
+  {
+    adc_integral += input_tp.adc_integral;
+    m_channel_occupancy.add(input_tp.channel);
+    if (m_size == m_tps.size())
+      grow();
+    m_tps[slot(m_size)] = input_tp;
+    ++m_size;
+  }
+  uint16_t n_channels_hit() const { return m_channel_occupancy.n_channels_hit(); }
+  void move(TriggerPrimitive const& input_tp, timestamp_t const& window_length)
+  {
+    while (m_size != 0 && !(input_tp.time_start - m_tps[m_head].time_start < window_length)) {
+      adc_integral -= m_tps[m_head].adc_integral;
+      m_channel_occupancy.remove(m_tps[m_head].channel);
+      m_head = (m_head + 1) & (m_tps.size() - 1);
+      --m_size;
+    }
+    if (m_size != 0) {
+      time_start = m_tps[m_head].time_start;
+      add(input_tp);
+    } else
+      reset(input_tp);
+  }
+  void reset(TriggerPrimitive const& input_tp)
+  {
+    m_channel_occupancy.clear();
+    m_head = 0;
+    m_size = 0;
+    adc_integral = 0;
+    time_start = input_tp.time_start;
+    add(input_tp);
+  }
+
+  timestamp_t time_start = 0;
+  uint32_t adc_integral = 0;
+
+private:
+  std::size_t slot(std::size_t i) const { return (m_head + i) & (m_tps.size() - 1); }
+  void grow()
+  {
+    std::vector<TriggerPrimitive> grown(m_tps.empty() ? 64 : 2 * m_tps.size());
+    for (std::size_t i = 0; i < m_size; ++i)
+      grown[i] = m_tps[slot(i)];
+    m_tps.swap(grown);
+    m_head = 0;
+  }
+
+  std::vector<TriggerPrimitive> m_tps;
+  std::size_t m_head = 0;
+  std::size_t m_size = 0;
+  ChannelOccupancy m_channel_occupancy;
+};
+
+// TAWindow: pooled TAs with their distinct channels, ordered by index.
+class TAWindow
+{
+public:
+  bool is_empty() const { return m_order.empty(); }
+  void add(const TriggerActivity& input_ta)
+  {
+    std::size_t slot;
+    if (m_free.empty()) {
+      slot = m_pool.size();
+      m_pool.emplace_back();
+    } else {
+      slot = m_free.back();
+      m_free.pop_back();
+    }
+    Entry& entry = m_pool[slot];
+    entry.ta = input_ta;
+    entry.channels.clear();
+    for (const TriggerPrimitive& tp : input_ta.inputs)
+      entry.channels.push_back(tp.channel);
+    std::sort(entry.channels.begin(), entry.channels.end());
+    entry.channels.erase(std::unique(entry.channels.begin(), entry.channels.end()), entry.channels.end());
+    for (channel_t channel : entry.channels)
+      m_channel_occupancy.add(channel);
+    adc_integral += input_ta.adc_integral;
+
+    if (m_order.empty() || !(input_ta.time_start < m_pool[m_order.back()].ta.time_start)) {
+      m_order.push_back(slot);
+      return;
+    }
+    auto insert_at = std::upper_bound(
+      m_order.begin(), m_order.end(), input_ta.time_start, [this](timestamp_t time, std::size_t index) {
+        return time < m_pool[index].ta.time_start;
+      });
+    m_order.insert(insert_at, slot);
+  }
+  uint16_t n_channels_hit() const { return m_channel_occupancy.n_channels_hit(); }
+  void move(TriggerActivity const& input_ta, timestamp_t const& window_length)
+  {
+    while (!m_order.empty() && !(input_ta.time_start - m_pool[m_order.front()].ta.time_start < window_length)) {
+      const Entry& entry = m_pool[m_order.front()];
+      adc_integral -= entry.ta.adc_integral;
+      for (channel_t channel : entry.channels)
+        m_channel_occupancy.remove(channel);
+      m_free.push_back(m_order.front());
+      m_order.pop_front();
+    }
+    if (!m_order.empty()) {
+      time_start = m_pool[m_order.front()].ta.time_start;
+      add(input_ta);
+    } else
+      reset(input_ta);
+  }
+  void reset(TriggerActivity const& input_ta)
+  {
+    m_free.insert(m_free.end(), m_order.begin(), m_order.end());
+    m_order.clear();
+    m_channel_occupancy.clear();
+    adc_integral = 0;
+    time_start = input_ta.time_start;
+    add(input_ta);
+  }
+
+  timestamp_t time_start = 0;
+  uint64_t adc_integral = 0; // NOLINT(build/unsigned)
+
+private:
+  struct Entry
+  {
+    TriggerActivity ta;
+    std::vector<channel_t> channels;
+  };
+
+  std::vector<Entry> m_pool;
+  std::vector<std::size_t> m_free;
+  std::deque<std::size_t> m_order;
+  ChannelOccupancy m_channel_occupancy;
+};
+
+} // namespace legacy
+
+namespace {
+
+// Same stream as benchmark_batch: time-ordered TPs with uniform channels.
+std::vector<TriggerPrimitive>
+make_tps(size_t n_tps)
+{
+  std::vector<TriggerPrimitive> tps(n_tps);
+  uint64_t state = 0x2545F4914F6CDD1DULL; // NOLINT(build/unsigned)
+  auto next = [&state]() {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+  };
+
+  timestamp_t time = 1'000'000;
+  for (auto& tp : tps) {
+    time += next() % 32;
+    tp.type = TriggerPrimitive::Type::kTPC;
+    tp.time_start = time;
+    tp.time_over_threshold = 10 + next() % 40;
+    tp.time_peak = tp.time_start + tp.time_over_threshold / 2;
+    tp.channel = next() % 2560;
+    tp.adc_integral = 500 + next() % 5000;
+    tp.adc_peak = 20 + next() % 200;
+    tp.detid = 0;
+  }
+  return tps;
+}
+
+// Group the TPs into TAs of 16, swapping neighbours now and then so the TA
+// windows see some out of order input.
+std::vector<TriggerActivity>
+make_tas(const std::vector<TriggerPrimitive>& tps)
+{
+  std::vector<TriggerActivity> tas;
+  for (size_t first = 0; first + 16 <= tps.size(); first += 16) {
+    TriggerActivity& ta = tas.emplace_back();
+    ta.inputs.assign(tps.begin() + first, tps.begin() + first + 16);
+    ta.time_start = ta.inputs.front().time_start;
+    for (const auto& tp : ta.inputs)
+      ta.adc_integral += tp.adc_integral;
+  }
+  for (size_t i = 7; i < tas.size(); i += 13)
+    std::swap(tas[i - 1], tas[i]);
+  return tas;
+}
+
+struct Result
+{
+  double seconds = 0;
+  uint64_t checksum = 0; // NOLINT(build/unsigned)
+};
+
+// Read the aggregates a maker would look at after every step.
+template<class Window>
+uint64_t // NOLINT(build/unsigned)
+observe(const Window& window)
+{
+  if constexpr (std::is_same_v<Window, legacy::ADCWindow> ||
+                std::is_same_v<Window, SlidingWindow<TriggerPrimitive, ADCSum<uint32_t>>>)
+    return window.adc_integral + window.time_start;
+  else
+    return window.adc_integral + window.time_start + window.n_channels_hit();
+}
+
+template<class Window, class Input>
+Result
+slide(const std::vector<Input>& inputs, timestamp_t window_length)
+{
+  Window window;
+  Result result;
+  auto start = std::chrono::steady_clock::now();
+  for (const Input& input : inputs) {
+    if (window.is_empty())
+      window.reset(input);
+    else
+      window.move(input, window_length);
+    result.checksum += observe(window);
+  }
+  result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  return result;
+}
+
+template<class Legacy, class Current, class Input>
+void
+compare(const char* name, const std::vector<Input>& inputs, timestamp_t window_length)
+{
+  Result legacy = slide<Legacy>(inputs, window_length);
+  Result current = slide<Current>(inputs, window_length);
+  std::printf("%-16s legacy %7.2f ns/input  SlidingWindow %7.2f ns/input  speedup %5.2fx%s\n",
+              name,
+              1e9 * legacy.seconds / inputs.size(),
+              1e9 * current.seconds / inputs.size(),
+              legacy.seconds / current.seconds,
+              legacy.checksum == current.checksum ? "" : "  MISMATCH");
+}
+
+// Cost of the aggregates that no window uses yet.
+template<class Window>
+void
+time_only(const char* name, const std::vector<TriggerPrimitive>& inputs, timestamp_t window_length)
+{
+  Window window;
+  uint64_t checksum = 0; // NOLINT(build/unsigned)
+  auto start = std::chrono::steady_clock::now();
+  for (const TriggerPrimitive& input : inputs) {
+    if (window.is_empty())
+      window.reset(input);
+    else
+      window.move(input, window_length);
+    checksum += window.adc_integral + window.time_over_threshold + window.adc_peak();
+  }
+  double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+  std::printf("%-16s                          SlidingWindow %7.2f ns/input  (checksum %llu)\n",
+              name,
+              1e9 * seconds / inputs.size(),
+              static_cast<unsigned long long>(checksum)); // NOLINT(runtime/int)
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  size_t n_tps = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 2'000'000;
+  timestamp_t window_length = argc > 2 ? std::strtoull(argv[2], nullptr, 10) : 8000;
+
+  std::vector<TriggerPrimitive> tps = make_tps(n_tps);
+  std::vector<TriggerActivity> tas = make_tas(tps);
+
+  std::printf("%zu TPs, %zu TAs, window length %llu ticks\n",
+              tps.size(),
+              tas.size(),
+              static_cast<unsigned long long>(window_length)); // NOLINT(runtime/int)
+  compare<legacy::ADCWindow, SlidingWindow<TriggerPrimitive, ADCSum<uint32_t>>>("ADCSimpleWindow", tps, window_length);
+  compare<legacy::TPWindow, TPWindow>("TPWindow", tps, window_length);
+  compare<legacy::TAWindow, TAWindow>("TAWindow", tas, 16 * window_length);
+  time_only<SlidingWindow<TriggerPrimitive, ADCSum<uint32_t>, TOTSum, PeakADC>>("ADC+TOT+peak", tps, window_length);
+
+  return 0;
+}
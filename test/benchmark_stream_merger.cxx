@@ -0,0 +1,119 @@
+/**
+ * @file benchmark_stream_merger.cxx
+ *
+ * Measures the throughput of StreamMerger merging 2 to 64 TA streams into one.
+ * Each input makes time-ordered TAs with random gaps, which arrive in chunks
+ * of a few TAs per input in turn, each followed by the input's watermark, as
+ * from TA makers on separate links. Also checks that the merged stream is in
+ * time order and complete.
+ *
+ * Usage: benchmark_stream_merger [n_tas]
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "triggeralgs/StreamMerger.hpp"
+#include "triggeralgs/TriggerActivity.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace triggeralgs;
+
+namespace {
+
+const size_t chunk_size = 16;
+
+struct Stream
+{
+  std::vector<TriggerActivity> tas;
+  std::vector<timestamp_t> watermarks; // After each chunk
+};
+
+// n_inputs streams sharing the same clock, each with n_per_input TAs.
+std::vector<Stream>
+make_streams(size_t n_inputs, size_t n_per_input)
+{
+  uint64_t state = 0x9E3779B97F4A7C15ULL; // NOLINT(build/unsigned)
+  auto next = [&state]() {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    return state;
+  };
+
+  std::vector<Stream> streams(n_inputs);
+  for (Stream& stream : streams) {
+    stream.tas.resize(n_per_input);
+    timestamp_t time = 1'000'000;
+    for (size_t i = 0; i < n_per_input; ++i) {
+      time += next() % (2 * 64 * n_inputs);
+      TriggerActivity& ta = stream.tas[i];
+      ta.time_start = time;
+      ta.time_end = time + 200;
+      ta.channel_start = static_cast<channel_t>(next() % 2560);
+      ta.adc_integral = 1000 + next() % 10000;
+      // The watermark after a chunk is the start of the next chunk's first TA.
+      if (i % chunk_size == 0 && i != 0)
+        stream.watermarks.push_back(time);
+    }
+    stream.watermarks.push_back(time + 1);
+  }
+  return streams;
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  size_t n_tas = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4'000'000;
+
+  std::printf("%8s %12s %10s %14s %10s %8s %s\n", "inputs", "TAs", "ns/TA", "M TAs/s", "max held", "late", "order");
+  for (size_t n_inputs = 2; n_inputs <= 64; n_inputs *= 2) {
+    const size_t n_per_input = n_tas / n_inputs;
+    std::vector<Stream> streams = make_streams(n_inputs, n_per_input);
+
+    StreamMerger<TriggerActivity> merger(n_inputs);
+    timestamp_t last_time = 0;
+    size_t n_out = 0;
+    bool in_order = true;
+    auto check = [&](TriggerActivity&& ta) {
+      in_order &= ta.time_start >= last_time;
+      last_time = ta.time_start;
+      ++n_out;
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    for (size_t first = 0, chunk = 0; first < n_per_input; first += chunk_size, ++chunk) {
+      const size_t last = std::min(first + chunk_size, n_per_input);
+      for (size_t input = 0; input < n_inputs; ++input) {
+        const Stream& stream = streams[input];
+        for (size_t i = first; i < last; ++i)
+          merger.push(input, stream.tas[i]);
+        merger.advance(input, stream.watermarks[chunk]);
+        merger.release(check);
+      }
+    }
+    merger.drain(check);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const size_t n_in = n_inputs * n_per_input;
+    std::printf("%8zu %12zu %10.2f %14.2f %10zu %8llu %s\n",
+                n_inputs,
+                n_in,
+                1e9 * seconds / n_in,
+                1e-6 * n_in / seconds,
+                merger.counters().max_buffered,
+                static_cast<unsigned long long>(merger.counters().n_late), // NOLINT(runtime/int)
+                in_order && n_out == n_in ? "ok" : "WRONG");
+  }
+
+  return 0;
+}
@@ -0,0 +1,67 @@
+/**
+ * @file benchmark_tp_generator.cxx
+ *
+ * Measures how fast TPGenerator makes TPs, for a few mixes of activity, to
+ * check that it can drive the maker benchmarks without being their
+ * bottleneck.
+ *
+ * Usage: benchmark_tp_generator [n_tps]
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "triggeralgs/TPGenerator.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+using namespace triggeralgs;
+
+int
+main(int argc, char* argv[])
+{
+  size_t n_tps = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 10'000'000;
+
+  const std::vector<std::pair<std::string, nlohmann::json>> mixes = {
+    { "noise", { { "track_rate_hz", 0 }, { "michel_rate_hz", 0 }, { "shower_rate_hz", 0 } } },
+    { "default", nlohmann::json::object() },
+    { "muons", { { "track_rate_hz", 1000 }, { "michel_rate_hz", 100 } } },
+    { "supernova", { { "supernova_rate_hz", 100000 } } },
+    { "showers", { { "shower_rate_hz", 1000 } } },
+  };
+
+  // Touch the memory up front, so that the first mix does not pay for it.
+  std::vector<TriggerPrimitive> tps(n_tps);
+  std::printf("%-10s %12s %10s %10s %10s %10s %10s %10s\n",
+              "mix", "TPs", "ns/TP", "MTP/s", "tracks", "michels", "sn events", "showers");
+  for (const auto& [name, config] : mixes) {
+    TPGenerator generator;
+    generator.configure(config);
+    tps.clear();
+
+    auto start = std::chrono::steady_clock::now();
+    generator.generate(n_tps, tps);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    const TPGenerator::Counters& counters = generator.counters();
+    std::printf("%-10s %12zu %10.2f %10.2f %10llu %10llu %10llu %10llu\n",
+                name.c_str(),
+                tps.size(),
+                1e9 * seconds / tps.size(),
+                1e-6 * tps.size() / seconds,
+                static_cast<unsigned long long>(counters.n_tracks),           // NOLINT(runtime/int)
+                static_cast<unsigned long long>(counters.n_michels),          // NOLINT(runtime/int)
+                static_cast<unsigned long long>(counters.n_supernova_events), // NOLINT(runtime/int)
+                static_cast<unsigned long long>(counters.n_showers));         // NOLINT(runtime/int)
+  }
+
+  return 0;
+}
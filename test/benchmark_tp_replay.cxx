@@ -0,0 +1,174 @@
+/**
+ * @file benchmark_tp_replay.cxx
+ *
+ * Measures how fast TPs can be replayed from a binary TP file through
+ * TPFileReader's spans, against the bandwidth of copying and of reading the
+ * same TPs in memory, and how fast convert_tp_text_file() parses a text dump
+ * against reading it with an ifstream.
+ *
+ * The files are written to the temporary directory, or to the one given, and
+ * read back while they are in the page cache, so the replay is limited by
+ * memory rather than by the disk.
+ *
+ * Usage: benchmark_tp_replay [n_tps] [directory]
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "triggeralgs/TPFile.hpp"
+#include "triggeralgs/TPGenerator.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+using namespace triggeralgs;
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+double
+seconds_since(Clock::time_point start)
+{
+  return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// Touch every TP, as a maker would, so that the reads cannot be skipped.
+uint64_t // NOLINT(build/unsigned)
+consume(Span<const TriggerPrimitive> tps)
+{
+  uint64_t sum = 0; // NOLINT(build/unsigned)
+  for (const TriggerPrimitive& tp : tps)
+    sum += tp.time_start + tp.adc_integral + static_cast<uint64_t>(tp.channel); // NOLINT(build/unsigned)
+  return sum;
+}
+
+void
+report(const char* name, std::size_t n_tps, std::size_t bytes, double seconds)
+{
+  std::printf("%-34s %8.1f MTP/s %8.2f GB/s\n", name, n_tps / seconds / 1e6, bytes / seconds / 1e9);
+}
+
+void
+replay(const std::string& path, TPFileReader::Access access, bool prefetch, const char* name, std::size_t batch_size)
+{
+  Clock::time_point start = Clock::now();
+  TPFileReader reader(path, access);
+  uint64_t sum = 0; // NOLINT(build/unsigned)
+  for (std::size_t first = 0; first < reader.size(); first += batch_size) {
+    if (prefetch)
+      reader.prefetch(first + 4 * batch_size, batch_size);
+    sum += consume(reader.tps(first, batch_size));
+  }
+  double seconds = seconds_since(start);
+  report(name, reader.size(), reader.size() * sizeof(TriggerPrimitive), seconds);
+  if (sum == 42)
+    std::printf("\n");
+}
+
+} // namespace
+
+int
+main(int argc, char* argv[])
+{
+  size_t n_tps = argc > 1 ? std::strtoull(argv[1], nullptr, 10) : 4'000'000;
+  std::filesystem::path directory = argc > 2 ? std::filesystem::path(argv[2]) : std::filesystem::temp_directory_path();
+  const std::string binary_path = (directory / "benchmark_tp_replay.bin").string();
+  const std::string text_path = (directory / "benchmark_tp_replay.txt").string();
+  const std::string converted_path = (directory / "benchmark_tp_replay_converted.bin").string();
+  const std::size_t batch_size = 4096;
+
+  std::vector<TriggerPrimitive> tps;
+  tps.reserve(n_tps);
+  TPGenerator generator;
+  generator.generate(n_tps, tps);
+  const std::size_t bytes = tps.size() * sizeof(TriggerPrimitive);
+  std::printf("%zu TPs of %zu bytes, %.1f MB, in batches of %zu\n\n",
+              tps.size(),
+              sizeof(TriggerPrimitive),
+              bytes / 1e6,
+              batch_size);
+
+  // Write the binary file.
+  Clock::time_point start = Clock::now();
+  {
+    TPFileWriter writer(binary_path);
+    writer.write(Span<const TriggerPrimitive>(tps.data(), tps.size()));
+  }
+  report("write binary", tps.size(), bytes, seconds_since(start));
+
+  // The references: copying, and reading, the same TPs in memory.
+  std::vector<TriggerPrimitive> copy(tps.size());
+  for (int pass = 0; pass < 2; ++pass) {
+    start = Clock::now();
+    std::memcpy(copy.data(), tps.data(), bytes);
+    double seconds = seconds_since(start);
+    if (pass == 1)
+      report("memcpy", tps.size(), bytes, seconds);
+  }
+  start = Clock::now();
+  uint64_t sum = consume(Span<const TriggerPrimitive>(copy.data(), copy.size())); // NOLINT(build/unsigned)
+  report("read in memory", tps.size(), bytes, seconds_since(start));
+  copy = std::vector<TriggerPrimitive>();
+
+  // Replay from the file. The first pass pulls the file into the page cache
+  // if writing it did not leave it there.
+  replay(binary_path, TPFileReader::Access::kSequential, false, "replay (warm-up)", batch_size);
+  replay(binary_path, TPFileReader::Access::kNormal, false, "replay", batch_size);
+  replay(binary_path, TPFileReader::Access::kSequential, false, "replay sequential", batch_size);
+  replay(binary_path, TPFileReader::Access::kSequential, true, "replay sequential with prefetch", batch_size);
+  replay(binary_path, TPFileReader::Access::kPopulate, false, "replay populated", batch_size);
+
+  // Text dumps, in dump_tp()'s format.
+  {
+    std::ofstream text(text_path);
+    for (const TriggerPrimitive& tp : tps)
+      text << tp.time_start << " " << tp.time_over_threshold << " " << tp.time_peak << " " << tp.channel << " "
+           << tp.adc_integral << " " << tp.adc_peak << " " << tp.detid << " " << static_cast<int>(tp.type) << "\n";
+  }
+  const std::size_t text_bytes = std::filesystem::file_size(text_path);
+  std::printf("\nText dump of %.1f MB\n", text_bytes / 1e6);
+
+  start = Clock::now();
+  std::size_t n_converted = convert_tp_text_file(text_path, converted_path);
+  report("convert text (from_chars)", n_converted, text_bytes, seconds_since(start));
+
+  start = Clock::now();
+  {
+    std::vector<TriggerPrimitive> read;
+    std::ifstream file(text_path);
+    TriggerPrimitive tp;
+    int type = 0;
+    while (file >> tp.time_start >> tp.time_over_threshold >> tp.time_peak >> tp.channel >> tp.adc_integral >>
+           tp.adc_peak >> tp.detid >> type) {
+      tp.type = static_cast<TriggerPrimitive::Type>(type);
+      read.push_back(tp);
+    }
+    report("read text (ifstream)", read.size(), text_bytes, seconds_since(start));
+  }
+
+  TPFileReader converted(converted_path);
+  bool same = converted.size() == tps.size();
+  for (std::size_t i = 0; same && i < tps.size(); ++i) {
+    const TriggerPrimitive& tp = converted.tps()[i];
+    same = tp.time_start == tps[i].time_start && tp.channel == tps[i].channel &&
+           tp.adc_integral == tps[i].adc_integral && tp.detid == tps[i].detid;
+  }
+  if (!same) {
+    std::fprintf(stderr, "The converted file does not match the generated TPs\n");
+    return 1;
+  }
+
+  std::filesystem::remove(binary_path);
+  std::filesystem::remove(text_path);
+  std::filesystem::remove(converted_path);
+  return sum == 42 ? 1 : 0;
+}
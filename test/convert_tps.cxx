@@ -0,0 +1,38 @@
+/**
+ * @file convert_tps.cxx
+ *
+ * Converts a text TP dump into a binary TP file, for replay through
+ * TPFileReader.
+ *
+ * Usage: convert_tps <text_file> <binary_file>
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+#include "triggeralgs/Issues.hpp"
+#include "triggeralgs/TPFile.hpp"
+
+#include <cstdio>
+#include <exception>
+
+using namespace triggeralgs;
+
+int
+main(int argc, char* argv[])
+{
+  if (argc != 3) {
+    std::fprintf(stderr, "Usage: %s <text_file> <binary_file>\n", argv[0]);
+    return 1;
+  }
+
+  try {
+    std::size_t n_tps = convert_tp_text_file(argv[1], argv[2]);
+    std::printf("Wrote %zu TPs to %s\n", n_tps, argv[2]);
+  } catch (const std::exception& e) {
+    std::fprintf(stderr, "%s\n", e.what());
+    return 1;
+  }
+  return 0;
+}
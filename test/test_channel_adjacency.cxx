@@ -0,0 +1,197 @@
+/**
+ * @file test_channel_adjacency.cxx
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE channel_adjacency
+
+#include "triggeralgs/ChannelAdjacency/TriggerActivityMakerChannelAdjacency.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+const timestamp_t window_length = 8000;
+
+// The tracks that ChannelAdjacency took out of a window before it walked the
+// channels once: sort the window by channel, take the first run longer than
+// the threshold, leave out every TP on its channels, and start again, until
+// no run is long enough. TPs on the same channel stay in window order.
+std::vector<std::vector<TriggerPrimitive>>
+take_tracks_one_by_one(std::vector<TriggerPrimitive> window, std::size_t threshold, unsigned int tolerance)
+{
+  std::vector<std::vector<TriggerPrimitive>> tracks;
+  while (true) {
+    std::vector<TriggerPrimitive> sorted = window;
+    std::stable_sort(sorted.begin(), sorted.end(), [](const TriggerPrimitive& a, const TriggerPrimitive& b) {
+      return a.channel < b.channel;
+    });
+
+    std::vector<TriggerPrimitive> run;
+    std::vector<TriggerPrimitive> track;
+    unsigned int tol_count = 0;
+    for (std::size_t i = 0; i < sorted.size(); ++i) {
+      std::size_t next = (i + 1) % sorted.size();
+      unsigned int channel = sorted[i].channel;
+      unsigned int next_channel = next == 0 ? channel - 1 : sorted[next].channel;
+      if (next_channel == channel)
+        continue;
+      if (run.empty())
+        run.push_back(sorted[i]);
+      if (next_channel - channel == 1) {
+        run.push_back(sorted[next]);
+      } else if (next_channel - channel > 0 && next_channel - channel <= 5 && tol_count < tolerance) {
+        run.push_back(sorted[next]);
+        tol_count += next_channel - channel - 1;
+      } else if (run.size() > threshold) {
+        track = run;
+        break;
+      } else {
+        tol_count = 0;
+        run.clear();
+      }
+    }
+    if (track.empty())
+      return tracks;
+
+    window.erase(std::remove_if(window.begin(),
+                                window.end(),
+                                [&](const TriggerPrimitive& tp) {
+                                  return std::any_of(track.begin(), track.end(), [&](const TriggerPrimitive& t) {
+                                    return t.channel == tp.channel;
+                                  });
+                                }),
+                 window.end());
+    tracks.push_back(std::move(track));
+  }
+}
+
+// A window's worth of TPs: tracks over adjacent channels, some with missing
+// channels and some with several TPs on a channel, and noise.
+std::vector<TriggerPrimitive>
+make_window(std::mt19937& random)
+{
+  std::vector<TriggerPrimitive> tps;
+  auto add_tp = [&](int channel) {
+    TriggerPrimitive tp;
+    tp.type = TriggerPrimitive::Type::kTPC;
+    tp.time_start = 1'000'000 + random() % (window_length - 100);
+    tp.time_peak = tp.time_start + random() % 10;
+    tp.time_over_threshold = 5 + random() % 20;
+    tp.channel = channel;
+    tp.adc_integral = 500 + random() % 2000;
+    tp.adc_peak = 20 + random() % 200;
+    tps.push_back(tp);
+  };
+
+  int n_tracks = random() % 6;
+  for (int track = 0; track < n_tracks; ++track) {
+    int first_channel = random() % 400;
+    int length = 5 + random() % 60;
+    for (int channel = first_channel; channel < first_channel + length; ++channel) {
+      if (random() % 8 == 0)
+        channel += random() % 4;
+      add_tp(channel);
+      if (random() % 6 == 0)
+        add_tp(channel);
+    }
+  }
+  int n_noise = random() % 40;
+  for (int i = 0; i < n_noise; ++i)
+    add_tp(random() % 500);
+
+  std::stable_sort(tps.begin(), tps.end(), [](const TriggerPrimitive& a, const TriggerPrimitive& b) {
+    return a.time_start < b.time_start;
+  });
+  return tps;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(same_tracks_as_taking_them_one_by_one)
+{
+  std::mt19937 random(42);
+  std::size_t n_tracks = 0;
+  for (uint16_t threshold : { 0, 3, 15, 30 }) {
+    for (uint16_t tolerance : { 0, 3, 10 }) {
+      for (int n = 0; n < 300; ++n) {
+        std::vector<TriggerPrimitive> window = make_window(random);
+        if (window.empty())
+          continue;
+
+        TriggerActivityMakerChannelAdjacency maker;
+        maker.configure({ { "window_length", window_length },
+                          { "adjacency_threshold", threshold },
+                          { "adj_tolerance", tolerance } });
+        std::vector<TriggerActivity> output_ta;
+        for (const TriggerPrimitive& tp : window)
+          maker(tp, output_ta);
+        BOOST_REQUIRE(output_ta.empty());
+        // The next TP completes the window.
+        TriggerPrimitive closing = window.back();
+        closing.time_start = window.front().time_start + window_length;
+        maker(closing, output_ta);
+
+        std::vector<std::vector<TriggerPrimitive>> tracks = take_tracks_one_by_one(window, threshold, tolerance);
+        BOOST_REQUIRE_EQUAL(output_ta.size(), tracks.size());
+        for (std::size_t i = 0; i < tracks.size(); ++i) {
+          const TriggerActivity& ta = output_ta[i];
+          BOOST_REQUIRE_EQUAL(ta.inputs.size(), tracks[i].size());
+          uint32_t adc_integral = 0; // NOLINT(build/unsigned)
+          for (std::size_t j = 0; j < tracks[i].size(); ++j) {
+            BOOST_TEST(ta.inputs[j].channel == tracks[i][j].channel);
+            BOOST_TEST(ta.inputs[j].time_start == tracks[i][j].time_start);
+            adc_integral += tracks[i][j].adc_integral;
+          }
+          BOOST_TEST(ta.adc_integral == adc_integral);
+          BOOST_TEST(ta.channel_start == tracks[i].front().channel);
+          BOOST_TEST(ta.channel_end == tracks[i].back().channel);
+        }
+        n_tracks += tracks.size();
+      }
+    }
+  }
+  BOOST_TEST_MESSAGE(n_tracks << " tracks compared");
+  BOOST_TEST(n_tracks > 1000u);
+}
+
+BOOST_AUTO_TEST_CASE(prescale_counts_every_track)
+{
+  // Three tracks far apart: with a prescale of 2, only the second makes a TA.
+  TriggerActivityMakerChannelAdjacency maker;
+  maker.configure({ { "window_length", window_length }, { "adjacency_threshold", 10 }, { "prescale", 2 } });
+  std::vector<TriggerActivity> output_ta;
+  timestamp_t time = 1'000'000;
+  for (int track = 0; track < 3; ++track) {
+    for (int channel = 100 * track; channel < 100 * track + 20; ++channel) {
+      TriggerPrimitive tp;
+      tp.time_start = time++;
+      tp.channel = channel;
+      tp.adc_integral = 1000;
+      maker(tp, output_ta);
+    }
+  }
+  TriggerPrimitive closing;
+  closing.time_start = 1'000'000 + window_length;
+  closing.channel = 1000;
+  maker(closing, output_ta);
+
+  BOOST_REQUIRE_EQUAL(output_ta.size(), 1u);
+  BOOST_TEST(output_ta[0].channel_start == 100);
+  BOOST_TEST(output_ta[0].channel_end == 119);
+}
+
+} /* namespace triggeralgs */
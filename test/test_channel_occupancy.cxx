@@ -0,0 +1,179 @@
+/**
+ * @file test_channel_occupancy.cxx
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE channel_occupancy
+
+#include "triggeralgs/ChannelOccupancy.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+// The adjacency of HorizontalMuon before ChannelOccupancy: sort the channels
+// of every hit, and scan them. `span` is set to the first and last channels
+// of the first longest run.
+uint16_t
+sort_and_scan(std::vector<int> channels,
+              unsigned int max_step,
+              unsigned int tolerance,
+              std::pair<int, int>* span = nullptr)
+{
+  std::sort(channels.begin(), channels.end());
+  uint16_t adj = 1;
+  uint16_t max = 0;
+  unsigned int tol_count = 0;
+  int run_start = channels.empty() ? 0 : channels.front();
+  for (std::size_t i = 0; i < channels.size(); ++i) {
+    unsigned int channel = channels[i];
+    unsigned int next_channel = channels[(i + 1) % channels.size()];
+    if (next_channel == 0)
+      next_channel = channel - 1;
+    if (next_channel == channel) {
+      continue;
+    } else if (next_channel == channel + 1) {
+      ++adj;
+    } else if (next_channel >= channel + 2 && next_channel <= channel + max_step && tol_count < tolerance) {
+      ++adj;
+      tol_count += next_channel - channel;
+    } else {
+      if (adj > max && span != nullptr)
+        *span = { run_start, static_cast<int>(channel) };
+      max = std::max(max, adj);
+      adj = 1;
+      tol_count = 0;
+      run_start = channels[(i + 1) % channels.size()];
+    }
+  }
+  return max;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(small_cases)
+{
+  ChannelOccupancy occupancy;
+  BOOST_TEST(occupancy.longest_adjacent_run(5, 3) == 0);
+  occupancy.add(100);
+  BOOST_TEST(occupancy.longest_adjacent_run(5, 3) == 0);
+  for (channel_t channel : { 101, 102, 104, 107, 120, 121 })
+    occupancy.add(channel);
+  BOOST_TEST(occupancy.longest_adjacent_run(5, 2) == 4); // 100..104, then the tolerance is used up
+  BOOST_TEST(occupancy.longest_adjacent_run(5, 10) == 5); // 100..107
+  occupancy.add(103);
+  BOOST_TEST(occupancy.longest_adjacent_run(5, 10) == 6);
+  occupancy.add(103);
+  occupancy.remove(103);
+  BOOST_TEST(occupancy.longest_adjacent_run(5, 10) == 6);
+  occupancy.remove(103);
+  occupancy.remove(104);
+  BOOST_TEST(occupancy.longest_adjacent_run(5, 10) == 4); // 100..102, 107
+  BOOST_TEST(occupancy.longest_adjacent_run(5, 0) == 3);
+  occupancy.clear();
+  BOOST_TEST(occupancy.longest_adjacent_run(5, 0) == 0);
+  occupancy.add(0);
+  BOOST_TEST(occupancy.longest_adjacent_run(5, 0) == 1);
+
+  // Of two runs of the same length, the one on the lower channels.
+  occupancy.clear();
+  for (channel_t channel : { 200, 201, 202, 210, 211, 212, 213, 220, 221, 222, 223 })
+    occupancy.add(channel);
+  ChannelOccupancy::AdjacentRun run = occupancy.longest_adjacent_span(5, 0);
+  BOOST_TEST(run.length == 4);
+  BOOST_TEST(run.first_channel == 210);
+  BOOST_TEST(run.last_channel == 213);
+  BOOST_TEST(occupancy.hit_count(run.first_channel, run.last_channel) == 4u);
+  occupancy.remove(211);
+  run = occupancy.longest_adjacent_span(5, 0);
+  BOOST_TEST(run.first_channel == 220);
+  BOOST_TEST(occupancy.lowest_hit_channel() == 200);
+}
+
+// A window sliding over hits in clusters and on lone channels, checking the
+// kept segments against walking every channel and against the original
+// sort-and-scan after each step.
+BOOST_AUTO_TEST_CASE(sliding_window)
+{
+  std::mt19937 random(42);
+  for (int trial = 0; trial < 20; ++trial) {
+    const int n_channels = 64 << (trial % 6);
+    const std::size_t window_size = 1 + random() % 300;
+    const channel_t max_step = 1 + trial % 6;
+    const uint16_t tolerance = trial % 5;
+
+    ChannelOccupancy occupancy;
+    std::deque<int> window;
+    int track_channel = random() % n_channels;
+    for (int step = 0; step < 3000; ++step) {
+      int channel = 0;
+      if (random() % 3 == 0) {
+        channel = random() % n_channels;
+      } else {
+        track_channel = std::clamp<int>(track_channel + static_cast<int>(random() % 7) - 3, 0, n_channels - 1);
+        channel = track_channel;
+      }
+      occupancy.add(channel);
+      window.push_back(channel);
+      while (window.size() > window_size) {
+        occupancy.remove(window.front());
+        window.pop_front();
+      }
+      if (random() % 500 == 0) {
+        occupancy.clear();
+        window.clear();
+      }
+      if (random() % 3 != 0)
+        continue;
+
+      // Now and then another max_step or tolerance, as another caller might use.
+      channel_t call_max_step = random() % 20 == 0 ? max_step + 1 : max_step;
+      uint16_t incremental = occupancy.longest_adjacent_run(call_max_step, tolerance);
+      BOOST_REQUIRE_EQUAL(incremental, occupancy.scan_adjacent_run(call_max_step, tolerance));
+      if (window.empty())
+        continue;
+      std::pair<int, int> span;
+      BOOST_REQUIRE_EQUAL(
+        incremental, sort_and_scan(std::vector<int>(window.begin(), window.end()), call_max_step, tolerance, &span));
+
+      // And the run it measures is the first of that length.
+      ChannelOccupancy::AdjacentRun run = occupancy.longest_adjacent_span(call_max_step, tolerance);
+      BOOST_REQUIRE_EQUAL(run.length, incremental);
+      if (run.length > 1 || (run.length == 1 && occupancy.n_channels_hit() > 1)) {
+        BOOST_REQUIRE_EQUAL(run.first_channel, span.first);
+        BOOST_REQUIRE_EQUAL(run.last_channel, span.second);
+      }
+    }
+  }
+}
+
+// Channels below and above those seen so far grow the arrays.
+BOOST_AUTO_TEST_CASE(growing)
+{
+  ChannelOccupancy occupancy;
+  std::vector<channel_t> hit;
+  for (channel_t channel : { 1000, 1001, 1003, 900, 901, 902, 5000, 5001, 899, 10, 11, 12, 13 }) {
+    occupancy.add(channel);
+    hit.push_back(channel);
+    BOOST_REQUIRE_EQUAL(occupancy.longest_adjacent_run(5, 4), occupancy.scan_adjacent_run(5, 4));
+  }
+  BOOST_TEST(occupancy.longest_adjacent_run(5, 4) == 4);
+  for (channel_t channel : hit) {
+    occupancy.remove(channel);
+    BOOST_REQUIRE_EQUAL(occupancy.longest_adjacent_run(5, 4), occupancy.scan_adjacent_run(5, 4));
+  }
+}
+
+} /* namespace triggeralgs */
@@ -0,0 +1,330 @@
+/**
+ * @file test_dbscan.cxx
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE dbscan
+
+#include "triggeralgs/TPGenerator.hpp"
+#include "triggeralgs/dbscan/Hit.hpp"
+#include "triggeralgs/dbscan/HitPool.hpp"
+#include "triggeralgs/dbscan/dbscan.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <limits>
+#include <random>
+#include <thread>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+// The position of each of a hit's neighbours in the stream.
+std::vector<std::size_t>
+neighbour_positions(const dbscan::Hit& hit, const std::unordered_map<const dbscan::Hit*, std::size_t>& positions)
+{
+  std::vector<std::size_t> neighbours;
+  for (const dbscan::Hit* neighbour : hit.neighbours)
+    neighbours.push_back(positions.at(neighbour));
+  return neighbours;
+}
+
+// Add the same stream of hits, in time order with ties, to neighbours_sorted()
+// over a vector of hits and to a HitIndex, each with its own copy of the
+// hits, and check that every hit gets the same neighbours in the same order.
+// Every `trim_every` hits, both forget the hits earlier than some time.
+void
+check_same_neighbours(float eps, int n_channels, int first_channel, std::size_t trim_every)
+{
+  const int min_pts = 3;
+  std::mt19937 random(42);
+  std::deque<dbscan::Hit> sorted_hits;
+  std::deque<dbscan::Hit> indexed_hits;
+  std::vector<dbscan::Hit*> sorted;
+  dbscan::HitIndex index(eps);
+
+  float time = 0;
+  std::size_t n_neighbours = 0;
+  for (std::size_t i = 0; i < 10000; ++i) {
+    if (random() % 3 == 0)
+      time += (random() % 8) * 0.5f;
+    int chan = first_channel + static_cast<int>(random() % n_channels);
+
+    dbscan::Hit& sorted_hit = sorted_hits.emplace_back(time, chan);
+    sorted.push_back(&sorted_hit);
+    int n_sorted = dbscan::neighbours_sorted(sorted, sorted_hit, eps, min_pts);
+
+    dbscan::Hit& indexed_hit = indexed_hits.emplace_back(time, chan);
+    index.add(&indexed_hit);
+    int n_indexed = index.neighbours(indexed_hit, min_pts);
+
+    BOOST_REQUIRE_EQUAL(n_indexed, n_sorted);
+    n_neighbours += n_sorted;
+
+    if (trim_every != 0 && i % trim_every == 0) {
+      auto last_it = std::lower_bound(sorted.begin(), sorted.end(), time - 3 * eps, dbscan::time_comp_lower);
+      index.drop_oldest(last_it - sorted.begin());
+      sorted.erase(sorted.begin(), last_it);
+    }
+  }
+
+  std::unordered_map<const dbscan::Hit*, std::size_t> sorted_positions;
+  std::unordered_map<const dbscan::Hit*, std::size_t> indexed_positions;
+  for (std::size_t i = 0; i < sorted_hits.size(); ++i) {
+    sorted_positions[&sorted_hits[i]] = i;
+    indexed_positions[&indexed_hits[i]] = i;
+  }
+  for (std::size_t i = 0; i < sorted_hits.size(); ++i) {
+    BOOST_REQUIRE(neighbour_positions(indexed_hits[i], indexed_positions) ==
+                  neighbour_positions(sorted_hits[i], sorted_positions));
+    BOOST_REQUIRE(indexed_hits[i].connectedness == sorted_hits[i].connectedness);
+  }
+  BOOST_TEST_MESSAGE("eps " << eps << ", " << n_channels << " channels from " << first_channel << ": "
+                            << n_neighbours << " neighbours");
+  BOOST_TEST(n_neighbours > 0u);
+}
+
+// Run IncrementalDBSCAN over a long track, which keeps one cluster open and
+// every hit since its start held, among noise on other channels, then noise
+// alone. Return the hits of each cluster, as channel and time, and check
+// that the hits are given up once the track is over.
+std::vector<std::vector<std::pair<int, float>>>
+cluster_track_and_noise(std::size_t chunk_size, std::size_t& max_hits)
+{
+  dbscan::IncrementalDBSCAN dbscan(2.5, 3, chunk_size);
+  std::mt19937 random(3);
+  std::vector<dbscan::Cluster> completed;
+  std::vector<std::vector<std::pair<int, float>>> clusters;
+  max_hits = 0;
+  for (int tick = 0; tick < 30000; ++tick) {
+    float time = tick;
+    if (tick < 20000) {
+      dbscan.add_point(time, 100 + tick % 3, &completed);
+    }
+    dbscan.add_point(time, 1000 + random() % 10000, &completed);
+    for (const dbscan::Cluster& cluster : completed) {
+      std::vector<std::pair<int, float>>& hits = clusters.emplace_back();
+      for (const dbscan::Hit* hit : cluster.hits)
+        hits.emplace_back(hit->chan, hit->time);
+    }
+    completed.clear();
+    dbscan.trim_hits();
+    max_hits = std::max(max_hits, dbscan.n_hits());
+  }
+  dbscan.flush(std::numeric_limits<timestamp_t>::max(), &completed);
+  BOOST_TEST(completed.empty());
+  BOOST_TEST(dbscan.n_hits() < 100u);
+  BOOST_TEST(dbscan.get_pool().n_chunks() <= 100 / chunk_size + 3);
+  return clusters;
+}
+
+// The index of a cluster with the channel and time of each of its hits.
+using ClusterHits = std::pair<int, std::vector<std::pair<int, float>>>;
+
+// Cluster a stream of TPs as the DBSCAN maker does.
+std::vector<ClusterHits>
+cluster_stream(const std::vector<TriggerPrimitive>& tps)
+{
+  dbscan::IncrementalDBSCAN dbscan(10, 3);
+  std::vector<dbscan::Cluster> completed;
+  std::vector<ClusterHits> clusters;
+  for (std::size_t i = 0; i < tps.size(); ++i) {
+    dbscan.add_primitive(tps[i], &completed);
+    if (i % 1000 == 0)
+      dbscan.flush(tps[i].time_start, &completed);
+    for (const dbscan::Cluster& cluster : completed) {
+      ClusterHits& hits = clusters.emplace_back(cluster.index, std::vector<std::pair<int, float>>());
+      for (const dbscan::Hit* hit : cluster.hits)
+        hits.second.emplace_back(hit->chan, hit->time);
+    }
+    completed.clear();
+    dbscan.trim_hits();
+  }
+  return clusters;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(hit_set_keeps_hits_sorted_and_unique)
+{
+  std::mt19937 random(5);
+  std::deque<dbscan::Hit> hits;
+  for (int i = 0; i < 100; ++i)
+    hits.emplace_back(static_cast<float>(random() % 30), i);
+
+  // Fill sets on and past their inline room, in any order, and check them
+  // against a sorted copy. A hit goes before the hits already in at the
+  // same time.
+  for (std::size_t n_hits : { 3, 10, 11, 40, 100 }) {
+    dbscan::HitSet set;
+    std::vector<dbscan::Hit*> expected;
+    for (std::size_t i = 0; i < 3 * n_hits; ++i) {
+      dbscan::Hit* hit = &hits[random() % n_hits];
+      set.insert(hit);
+      if (std::find(expected.begin(), expected.end(), hit) == expected.end()) {
+        auto it = std::lower_bound(expected.begin(), expected.end(), hit->time, dbscan::time_comp_lower);
+        expected.insert(it, hit);
+      }
+      BOOST_REQUIRE(std::vector<dbscan::Hit*>(set.begin(), set.end()) == expected);
+    }
+
+    dbscan::HitSet copy(set);
+    dbscan::HitSet moved(std::move(set));
+    BOOST_TEST(std::vector<dbscan::Hit*>(copy.begin(), copy.end()) == expected);
+    BOOST_TEST(std::vector<dbscan::Hit*>(moved.begin(), moved.end()) == expected);
+    BOOST_TEST(set.size() == 0u); // NOLINT(bugprone-use-after-move)
+    copy = moved;
+    moved.clear();
+    moved.insert(&hits[0]);
+    BOOST_TEST(copy.size() == expected.size());
+    BOOST_TEST(moved.size() == 1u);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(pool_keeps_hits_in_place)
+{
+  dbscan::HitPool pool(16);
+  std::vector<dbscan::Hit*> hits;
+  std::size_t n_released = 0;
+  for (int i = 0; i < 1000; ++i) {
+    hits.push_back(&pool.allocate(i, i % 7));
+    if (i % 50 == 49) {
+      // Keep between 20 and 70 hits, which is two to five chunks
+      pool.release(pool.size() - 20);
+      n_released = i + 1 - 20;
+      BOOST_TEST(pool.n_chunks() <= 4u);
+    }
+    BOOST_TEST(pool.n_chunks() <= 6u);
+    BOOST_REQUIRE_EQUAL(pool.size(), i + 1 - n_released);
+    for (std::size_t j = n_released; j <= static_cast<std::size_t>(i); ++j) {
+      BOOST_REQUIRE_EQUAL(&pool[j - n_released], hits[j]);
+      BOOST_REQUIRE_EQUAL(hits[j]->time, j);
+      BOOST_REQUIRE_EQUAL(hits[j]->generation, j);
+      BOOST_REQUIRE(pool.is_kept(*hits[j]));
+    }
+  }
+  BOOST_TEST(pool.count_before(990.5) == 11u);
+
+  // Released hits are stale. The last chunk, half full, stays to take the
+  // next hits, and one other is kept spare
+  const dbscan::Hit& last = *hits.back();
+  pool.release(pool.size());
+  BOOST_TEST(pool.empty());
+  BOOST_TEST(!pool.is_kept(last));
+  BOOST_TEST(pool.n_chunks() == 2u);
+  dbscan::Hit& next = pool.allocate(1000, 0);
+  BOOST_TEST(pool.is_kept(next));
+  BOOST_TEST(!pool.is_kept(last));
+  BOOST_TEST(next.generation == 1000u);
+}
+
+BOOST_AUTO_TEST_CASE(clusters_do_not_depend_on_the_chunk_size)
+{
+  // More hits than the 10000 that used to go round before being reused are
+  // held at once
+  std::size_t max_hits = 0;
+  auto one_chunk = cluster_track_and_noise(1 << 16, max_hits);
+  BOOST_TEST(max_hits > 30000u);
+  for (std::size_t chunk_size : { 1, 7, 1024 }) {
+    BOOST_TEST(cluster_track_and_noise(chunk_size, max_hits) == one_chunk);
+  }
+  BOOST_TEST_MESSAGE(one_chunk.size() << " clusters, the first of " << one_chunk.front().size() << " hits");
+  BOOST_TEST(one_chunk.front().size() == 20000u);
+}
+
+BOOST_AUTO_TEST_CASE(clusters_complete_in_the_order_they_were_made)
+{
+  // Tracks on channels far apart that start in order and whose last hits
+  // come in reverse order, and two tracks that start apart and meet, which
+  // become one cluster. All are still open until a hit long after.
+  dbscan::IncrementalDBSCAN dbscan(2.5, 3);
+  std::vector<dbscan::Cluster> completed;
+  for (int tick = 0; tick < 200; ++tick) {
+    dbscan.add_point(tick, 1950 + tick / 4, &completed);
+    dbscan.add_point(tick, 2050 - tick / 4, &completed);
+    for (int track = 9; track >= 0; --track) {
+      float time = tick < 199 ? tick : 199 + 0.1f * (10 - track);
+      if (tick >= 2 * track)
+        dbscan.add_point(time, 100 * track + tick % 2, &completed);
+    }
+  }
+  BOOST_TEST(completed.empty());
+  dbscan.add_point(1000, 0, &completed);
+
+  BOOST_REQUIRE_EQUAL(completed.size(), 11u);
+  for (std::size_t i = 0; i < completed.size(); ++i) {
+    if (i > 0)
+      BOOST_TEST(completed[i].index > completed[i - 1].index);
+    BOOST_TEST((completed[i].completeness == dbscan::Completeness::kComplete));
+    if ((*completed[i].hits.begin())->chan >= 1900)
+      BOOST_TEST(completed[i].hits.size() == 400u);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(instances_run_concurrently)
+{
+  // One instance per stream, as with one DBSCAN maker per APA, first one
+  // after the other and then all at once on their own threads, more of
+  // them than there are cores. Each numbers its clusters the same way
+  // whatever the others do.
+  const std::size_t n_instances = std::max(8u, 2 * std::thread::hardware_concurrency());
+  std::vector<std::vector<TriggerPrimitive>> streams(n_instances);
+  std::vector<std::vector<ClusterHits>> expected(n_instances);
+  for (std::size_t i = 0; i < n_instances; ++i) {
+    TPGenerator generator;
+    generator.configure({ { "seed", i + 1 }, { "noise_rate_hz", 2000 }, { "track_rate_hz", 500 } });
+    generator.generate(10000, streams[i]);
+    expected[i] = cluster_stream(streams[i]);
+    BOOST_REQUIRE(!expected[i].empty());
+  }
+
+  for (int round = 0; round < 3; ++round) {
+    std::vector<std::vector<ClusterHits>> results(n_instances);
+    std::atomic<bool> go{ false };
+    std::vector<std::thread> threads;
+    for (std::size_t i = 0; i < n_instances; ++i) {
+      threads.emplace_back([&, i] {
+        while (!go.load(std::memory_order_acquire))
+          std::this_thread::yield();
+        results[i] = cluster_stream(streams[i]);
+      });
+    }
+    go.store(true, std::memory_order_release);
+    for (std::thread& thread : threads)
+      thread.join();
+    for (std::size_t i = 0; i < n_instances; ++i)
+      BOOST_TEST((results[i] == expected[i]), "instance " << i << " in round " << round);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(index_finds_the_same_neighbours)
+{
+  for (float eps : { 0.5f, 2.5f, 10.0f, 25.0f }) {
+    for (int n_channels : { 5, 100, 3000 }) {
+      check_same_neighbours(eps, n_channels, 0, 0);
+      check_same_neighbours(eps, n_channels, -n_channels / 2, 0);
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(index_forgets_dropped_hits)
+{
+  for (float eps : { 2.5f, 10.0f }) {
+    check_same_neighbours(eps, 100, -20, 1);
+    check_same_neighbours(eps, 100, -20, 97);
+  }
+}
+
+} /* namespace triggeralgs */
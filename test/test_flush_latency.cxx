@@ -0,0 +1,185 @@
+/**
+ * @file test_flush_latency.cxx
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE flush_latency
+
+#include "triggeralgs/TriggerActivityFactory.hpp"
+#include "triggeralgs/TriggerActivityMaker.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+const timestamp_t burst_spacing = 100000;
+const timestamp_t heartbeat_interval = 500;
+
+// A sparse stream: short tracks across 40 adjacent channels, far apart in time,
+// with a lone noise TP half way between each pair of tracks.
+std::vector<TriggerPrimitive>
+make_sparse_stream()
+{
+  std::vector<TriggerPrimitive> tps;
+  for (int burst = 0; burst < 10; ++burst) {
+    // Offset the tracks so they do not line up with the heartbeats.
+    timestamp_t burst_start = burst_spacing * (burst + 1) + 137 * burst;
+    for (int i = 0; i < 40; ++i) {
+      TriggerPrimitive tp;
+      tp.type = TriggerPrimitive::Type::kTPC;
+      tp.algorithm = TriggerPrimitive::Algorithm::kSimpleThreshold;
+      tp.time_start = burst_start + 10 * i;
+      tp.time_peak = tp.time_start + 2;
+      tp.time_over_threshold = 5;
+      tp.adc_integral = 1000;
+      tp.adc_peak = 100;
+      tp.channel = 100 * burst + i;
+      tp.detid = 0;
+      tps.push_back(tp);
+    }
+    TriggerPrimitive noise = tps.back();
+    noise.time_start = burst_start + burst_spacing / 2;
+    noise.time_peak = noise.time_start + 2;
+    noise.channel = 5000 + burst;
+    tps.push_back(noise);
+  }
+  return tps;
+}
+
+struct EmittedTA
+{
+  TriggerActivity ta;
+  timestamp_t emitted_at; // Stream time of the TP or heartbeat that sent the TA out
+};
+
+// Feed the stream to a fresh maker, flushing every `heartbeat` ticks of stream time
+// (never, if zero) and once more well after the last TP.
+std::vector<EmittedTA>
+run(const std::string& plugin, const nlohmann::json& config, timestamp_t heartbeat)
+{
+  std::unique_ptr<TriggerActivityMaker> maker = TriggerActivityFactory::get_instance()->build_maker(plugin);
+  BOOST_REQUIRE(maker);
+  maker->configure(config);
+
+  std::vector<EmittedTA> emitted;
+  std::vector<TriggerActivity> output_ta;
+  auto collect = [&](timestamp_t now) {
+    for (auto& ta : output_ta)
+      emitted.push_back({ std::move(ta), now });
+    output_ta.clear();
+  };
+
+  const std::vector<TriggerPrimitive> tps = make_sparse_stream();
+  timestamp_t next_heartbeat = heartbeat;
+  for (const TriggerPrimitive& tp : tps) {
+    while (heartbeat != 0 && next_heartbeat <= tp.time_start) {
+      maker->flush(next_heartbeat, output_ta);
+      collect(next_heartbeat);
+      next_heartbeat += heartbeat;
+    }
+    (*maker)(tp, output_ta);
+    collect(tp.time_start);
+  }
+
+  timestamp_t end = tps.back().time_start + burst_spacing;
+  maker->flush(end, output_ta);
+  collect(end);
+
+  return emitted;
+}
+
+// The stream time at which no later TP can change a TA any more.
+using ReadyTime = std::function<timestamp_t(const TriggerActivity&)>;
+
+// A sliding window is complete one window length after it starts.
+ReadyTime
+window_ready(timestamp_t window_length)
+{
+  return [=](const TriggerActivity& ta) { return ta.time_start + window_length; };
+}
+
+void
+check_latency(const std::string& plugin, const nlohmann::json& config, const ReadyTime& ready_time)
+{
+  BOOST_TEST_MESSAGE("Checking " << plugin);
+
+  std::vector<EmittedTA> with_heartbeats = run(plugin, config, heartbeat_interval);
+  std::vector<EmittedTA> without_heartbeats = run(plugin, config, 0);
+
+  // Every track makes a TA.
+  BOOST_REQUIRE_GE(with_heartbeats.size(), 10u);
+
+  // Heartbeats only change when the TAs go out, not what they are.
+  BOOST_REQUIRE_EQUAL(with_heartbeats.size(), without_heartbeats.size());
+  for (size_t i = 0; i < with_heartbeats.size(); ++i) {
+    BOOST_TEST(with_heartbeats[i].ta.time_start == without_heartbeats[i].ta.time_start);
+    BOOST_TEST(with_heartbeats[i].ta.adc_integral == without_heartbeats[i].ta.adc_integral);
+    BOOST_TEST(with_heartbeats[i].ta.inputs.size() == without_heartbeats[i].ta.inputs.size());
+  }
+
+  // With heartbeats a TA must go out within one heartbeat interval of being ready,
+  // while without them it waits for the next TP.
+  timestamp_t worst_with = 0;
+  timestamp_t worst_without = 0;
+  for (size_t i = 0; i < with_heartbeats.size(); ++i) {
+    timestamp_t ready = ready_time(with_heartbeats[i].ta);
+
+    BOOST_REQUIRE_GE(with_heartbeats[i].emitted_at, ready);
+    worst_with = std::max(worst_with, with_heartbeats[i].emitted_at - ready);
+    worst_without = std::max(worst_without, without_heartbeats[i].emitted_at - ready);
+  }
+  BOOST_TEST_MESSAGE("  worst emission delay: " << worst_with << " ticks with heartbeats, " << worst_without
+                                                << " without");
+  BOOST_TEST(worst_with <= heartbeat_interval);
+  BOOST_TEST(worst_without > heartbeat_interval);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(adc_simple_window_flush_latency)
+{
+  nlohmann::json config = { { "window_length", 1000 }, { "adc_threshold", 20000 } };
+  check_latency("TriggerActivityMakerADCSimpleWindowPlugin", config, window_ready(1000));
+}
+
+BOOST_AUTO_TEST_CASE(horizontal_muon_flush_latency)
+{
+  nlohmann::json config = { { "window_length", 1000 }, { "adjacency_threshold", 15 } };
+  check_latency("TriggerActivityMakerHorizontalMuonPlugin", config, window_ready(1000));
+}
+
+BOOST_AUTO_TEST_CASE(channel_adjacency_flush_latency)
+{
+  nlohmann::json config = { { "window_length", 1000 }, { "adjacency_threshold", 15 } };
+  check_latency("TriggerActivityMakerChannelAdjacencyPlugin", config, window_ready(1000));
+}
+
+BOOST_AUTO_TEST_CASE(dbscan_flush_latency)
+{
+  // A cluster is out of reach of new hits 2*eps after its last hit, with eps in
+  // units of 100 ticks.
+  nlohmann::json config = { { "eps", 10 }, { "min_pts", 3 } };
+  check_latency("TriggerActivityMakerDBSCANPlugin", config, [](const TriggerActivity& ta) {
+    timestamp_t last_tp = 0;
+    for (const auto& tp : ta.inputs)
+      last_tp = std::max(last_tp, tp.time_start);
+    return last_tp + 2000;
+  });
+}
+
+} /* namespace triggeralgs */
@@ -0,0 +1,55 @@
+/**
+ * @file test_hit_pool_stale.cxx
+ *
+ * Built with its own copy of the pool, with TRIGGERALGS_HITPOOL_CHECK_STALE,
+ * rather than against the library, which is built without it.
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE hit_pool_stale
+
+#include "triggeralgs/dbscan/Hit.hpp"
+#include "triggeralgs/dbscan/HitPool.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <vector>
+
+#ifndef TRIGGERALGS_HITPOOL_CHECK_STALE
+#error "test_hit_pool_stale must be built with TRIGGERALGS_HITPOOL_CHECK_STALE"
+#endif
+
+namespace triggeralgs {
+
+BOOST_AUTO_TEST_CASE(released_hits_stay_stale)
+{
+  dbscan::HitPool pool(16);
+  std::vector<dbscan::Hit*> hits;
+  for (int i = 0; i < 1000; ++i) {
+    hits.push_back(&pool.allocate(i, i % 7));
+    if (i % 50 == 49)
+      pool.release(pool.size() - 20);
+  }
+
+  // No chunk given up is reused or freed: only the last, half full, is left
+  const dbscan::Hit& last = *hits.back();
+  pool.release(pool.size());
+  BOOST_TEST(pool.n_chunks() == 1u);
+  BOOST_TEST(!pool.is_kept(last));
+
+  // So after as many new hits as would have filled a reused chunk, every hit
+  // released is still there to be seen as stale
+  for (int i = 0; i < 16; ++i)
+    BOOST_TEST(pool.is_kept(pool.allocate(1000 + i, 0)));
+  for (const dbscan::Hit* hit : hits) {
+    BOOST_REQUIRE(!pool.is_kept(*hit));
+  }
+  BOOST_TEST(hits.front()->generation == 0u);
+  BOOST_TEST(pool.size() == 16u);
+}
+
+} /* namespace triggeralgs */
@@ -0,0 +1,185 @@
+/**
+ * @file test_horizontal_muon_multi.cxx
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE horizontal_muon_multi
+
+#include "triggeralgs/HorizontalMuon/TriggerActivityMakerHorizontalMuon.hpp"
+#include "triggeralgs/HorizontalMuon/TriggerActivityMakerHorizontalMuonMulti.hpp"
+#include "triggeralgs/Issues.hpp"
+#include "triggeralgs/TPGenerator.hpp"
+#include "triggeralgs/TriggerActivityFactory.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <memory>
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+// Sets that trigger on each of HorizontalMuon's conditions, often enough for
+// their windows to part, with and without prescales.
+nlohmann::json
+make_parameter_sets()
+{
+  return nlohmann::json::array({
+    { { "adjacency_threshold", 15 } },
+    { { "adjacency_threshold", 10 } },
+    { { "adjacency_threshold", 10 }, { "prescale", 3 } },
+    { { "adjacency_threshold", 30 }, { "prescale", 2 } },
+    { { "trigger_on_adjacency", false }, { "trigger_on_adc", true }, { "adc_threshold", 60000 } },
+    { { "trigger_on_n_channels", true }, { "n_channels_threshold", 40 }, { "prescale", 2 } },
+    { { "trigger_on_tot", true }, { "tot_threshold", 40 } },
+    { { "adjacency_threshold", 15 } },
+  });
+}
+
+std::vector<TriggerPrimitive>
+make_stream(std::size_t n_tps)
+{
+  TPGenerator generator;
+  generator.configure({ { "noise_rate_hz", 200 }, { "track_rate_hz", 500 }, { "shower_rate_hz", 20 } });
+  std::vector<TriggerPrimitive> tps;
+  generator.generate(n_tps, tps);
+  return tps;
+}
+
+// Feed the stream to a maker, flushing every `heartbeat` ticks of stream
+// time (never, if zero), and call `collect` after each call.
+template<class Maker, class Output, class Collect>
+void
+run(Maker& maker, const std::vector<TriggerPrimitive>& tps, timestamp_t heartbeat, Output& output, Collect collect)
+{
+  timestamp_t next_heartbeat = tps.front().time_start + heartbeat;
+  for (const TriggerPrimitive& tp : tps) {
+    while (heartbeat != 0 && next_heartbeat <= tp.time_start) {
+      maker.flush(next_heartbeat, output);
+      collect();
+      next_heartbeat += heartbeat;
+    }
+    maker(tp, output);
+    collect();
+  }
+  maker.flush(tps.back().time_start + 100000, output);
+  collect();
+}
+
+void
+check_same_tas(const std::vector<TriggerActivity>& multi, const std::vector<TriggerActivity>& single)
+{
+  BOOST_REQUIRE_EQUAL(multi.size(), single.size());
+  for (std::size_t i = 0; i < multi.size(); ++i) {
+    BOOST_TEST(multi[i].time_start == single[i].time_start);
+    BOOST_TEST(multi[i].time_end == single[i].time_end);
+    BOOST_TEST(multi[i].channel_start == single[i].channel_start);
+    BOOST_TEST(multi[i].channel_end == single[i].channel_end);
+    BOOST_TEST(multi[i].adc_integral == single[i].adc_integral);
+    BOOST_REQUIRE_EQUAL(multi[i].inputs.size(), single[i].inputs.size());
+    for (std::size_t j = 0; j < multi[i].inputs.size(); ++j) {
+      BOOST_TEST(multi[i].inputs[j].time_start == single[i].inputs[j].time_start);
+      BOOST_TEST(multi[i].inputs[j].channel == single[i].inputs[j].channel);
+    }
+  }
+}
+
+// Each parameter set of the multi maker makes the TAs that HorizontalMuon
+// configured with it alone does.
+void
+check_against_horizontal_muon(timestamp_t heartbeat)
+{
+  const std::vector<TriggerPrimitive> tps = make_stream(200000);
+  nlohmann::json sets = make_parameter_sets();
+
+  TriggerActivityMakerHorizontalMuonMulti multi;
+  multi.configure({ { "window_length", 8000 }, { "parameter_sets", sets } });
+  BOOST_REQUIRE_EQUAL(multi.n_parameter_sets(), sets.size());
+
+  std::vector<std::vector<TriggerActivity>> multi_tas;
+  std::size_t max_windows = 0;
+  run(multi, tps, heartbeat, multi_tas, [&] { max_windows = std::max(max_windows, multi.n_windows()); });
+  BOOST_TEST_MESSAGE("Heartbeat " << heartbeat << ": at most " << max_windows << " windows for " << sets.size()
+                                  << " parameter sets");
+  BOOST_TEST(max_windows <= sets.size());
+
+  std::size_t n_tas = 0;
+  for (std::size_t k = 0; k < sets.size(); ++k) {
+    nlohmann::json config = sets[k];
+    config["window_length"] = 8000;
+    TriggerActivityMakerHorizontalMuon single;
+    single.configure(config);
+    std::vector<TriggerActivity> single_tas;
+    run(single, tps, heartbeat, single_tas, [] {});
+
+    BOOST_TEST_MESSAGE("Parameter set " << k << ": " << single_tas.size() << " TAs");
+    check_same_tas(multi_tas[k], single_tas);
+    n_tas += single_tas.size();
+  }
+  BOOST_TEST(n_tas > 0u);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(same_tas_as_horizontal_muon)
+{
+  check_against_horizontal_muon(0);
+}
+
+BOOST_AUTO_TEST_CASE(same_tas_as_horizontal_muon_with_flushes)
+{
+  check_against_horizontal_muon(2000);
+}
+
+BOOST_AUTO_TEST_CASE(single_output_tags_the_parameter_sets)
+{
+  const std::vector<TriggerPrimitive> tps = make_stream(50000);
+  nlohmann::json config = { { "parameter_sets", make_parameter_sets() } };
+
+  TriggerActivityMakerHorizontalMuonMulti tagged;
+  tagged.configure(config);
+  std::vector<TriggerActivity> all_tas;
+  std::vector<std::size_t> all_sets;
+  run(tagged, tps, 0, all_tas, [&] {
+    all_sets.insert(all_sets.end(), tagged.output_sets().begin(), tagged.output_sets().end());
+  });
+  BOOST_REQUIRE_EQUAL(all_tas.size(), all_sets.size());
+
+  TriggerActivityMakerHorizontalMuonMulti split;
+  split.configure(config);
+  std::vector<std::vector<TriggerActivity>> split_tas;
+  run(split, tps, 0, split_tas, [] {});
+
+  std::vector<std::vector<TriggerActivity>> regrouped(split_tas.size());
+  for (std::size_t i = 0; i < all_tas.size(); ++i)
+    regrouped[all_sets[i]].push_back(all_tas[i]);
+  for (std::size_t k = 0; k < split_tas.size(); ++k)
+    check_same_tas(regrouped[k], split_tas[k]);
+}
+
+BOOST_AUTO_TEST_CASE(factory_and_configuration)
+{
+  std::unique_ptr<TriggerActivityMaker> maker =
+    TriggerActivityFactory::get_instance()->build_maker("TriggerActivityMakerHorizontalMuonMultiPlugin");
+  BOOST_REQUIRE(maker);
+
+  // Without parameter sets, the top level is the only one.
+  TriggerActivityMakerHorizontalMuonMulti multi;
+  multi.configure({ { "adjacency_threshold", 20 } });
+  BOOST_TEST(multi.n_parameter_sets() == 1u);
+
+  BOOST_CHECK_THROW(multi.configure({ { "parameter_sets", nlohmann::json::array() } }), BadConfiguration);
+  BOOST_CHECK_THROW(multi.configure({ { "parameter_sets", 3 } }), BadConfiguration);
+  BOOST_CHECK_THROW(multi.configure({ { "parameter_sets", nlohmann::json::array({ { { "prescale", 0 } } }) } }),
+                    BadConfiguration);
+}
+
+} /* namespace triggeralgs */
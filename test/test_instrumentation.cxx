@@ -0,0 +1,122 @@
+/**
+ * @file test_instrumentation.cxx
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE instrumentation
+
+#include "triggeralgs/Histogram.hpp"
+#include "triggeralgs/InstrumentedMaker.hpp"
+#include "triggeralgs/TriggerActivityFactory.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace triggeralgs {
+
+BOOST_AUTO_TEST_CASE(histogram_buckets)
+{
+  // Small values are exact.
+  for (uint64_t value = 0; value < Histogram::sub_buckets; ++value) { // NOLINT(build/unsigned)
+    BOOST_TEST(Histogram::lowest_in_bucket(Histogram::bucket_of(value)) == value);
+    BOOST_TEST(Histogram::highest_in_bucket(Histogram::bucket_of(value)) == value);
+  }
+
+  // Every value falls within its bucket, which is at most 1/32 of it wide.
+  std::mt19937_64 random(42);
+  for (int i = 0; i < 100000; ++i) {
+    uint64_t value = random() >> (random() % 64); // NOLINT(build/unsigned)
+    std::size_t bucket = Histogram::bucket_of(value);
+    BOOST_REQUIRE_LT(bucket, Histogram::n_buckets);
+    BOOST_REQUIRE_LE(Histogram::lowest_in_bucket(bucket), value);
+    BOOST_REQUIRE_GE(Histogram::highest_in_bucket(bucket), value);
+    BOOST_REQUIRE_LE(Histogram::highest_in_bucket(bucket) - Histogram::lowest_in_bucket(bucket),
+                     Histogram::lowest_in_bucket(bucket) / Histogram::sub_buckets);
+  }
+  BOOST_TEST(Histogram::bucket_of(UINT64_MAX) == Histogram::n_buckets - 1);
+}
+
+BOOST_AUTO_TEST_CASE(histogram_quantiles)
+{
+  Histogram histogram;
+  for (uint64_t value = 1; value <= 100000; ++value) // NOLINT(build/unsigned)
+    histogram.record(value);
+
+  BOOST_TEST(histogram.count() == 100000u);
+  BOOST_TEST(histogram.min() == 1u);
+  BOOST_TEST(histogram.max() == 100000u);
+  BOOST_TEST(histogram.mean() == 50000.5);
+  BOOST_TEST(histogram.value_at_quantile(0.5) >= 50000u);
+  BOOST_TEST(histogram.value_at_quantile(0.5) <= 50000u * 33 / 32);
+  BOOST_TEST(histogram.value_at_quantile(0.99) >= 99000u);
+  BOOST_TEST(histogram.value_at_quantile(0.99) <= 99000u * 33 / 32);
+  BOOST_TEST(histogram.value_at_quantile(1.0) == 100000u);
+
+  histogram.reset();
+  BOOST_TEST(histogram.count() == 0u);
+  BOOST_TEST(histogram.value_at_quantile(0.5) == 0u);
+}
+
+BOOST_AUTO_TEST_CASE(instrumented_maker)
+{
+  std::unique_ptr<TriggerActivityMaker> plain =
+    TriggerActivityFactory::get_instance()->build_maker("TriggerActivityMakerADCSimpleWindowPlugin");
+  BOOST_REQUIRE(plain);
+  InstrumentedTriggerActivityMaker maker(std::move(plain));
+  maker.configure(nlohmann::json{ { "window_length", 1000 }, { "adc_threshold", 20000 } });
+
+  // Tracks of 40 TPs, one every 10 ticks, every 100000 ticks.
+  std::vector<TriggerPrimitive> tps;
+  for (int track = 0; track < 10; ++track) {
+    for (int i = 0; i < 40; ++i) {
+      TriggerPrimitive tp;
+      tp.type = TriggerPrimitive::Type::kTPC;
+      tp.time_start = 100000 * (track + 1) + 10 * i;
+      tp.time_over_threshold = 5;
+      tp.adc_integral = 1000;
+      tp.channel = i;
+      tps.push_back(tp);
+    }
+  }
+
+  std::vector<TriggerActivity> output_ta;
+  for (const TriggerPrimitive& tp : tps)
+    maker(tp, output_ta);
+  maker(Span<const TriggerPrimitive>(tps.data(), 0), output_ta);
+  maker.flush(tps.back().time_start + 100000, output_ta);
+
+  BOOST_REQUIRE(maker.stats());
+  MakerStats::Report report = maker.stats()->poll();
+  BOOST_TEST(report.n_inputs == tps.size());
+  BOOST_TEST(report.n_calls == tps.size() + 1);
+  BOOST_TEST(report.n_outputs == output_ta.size());
+  BOOST_TEST(report.n_outputs >= 10u);
+  BOOST_TEST(report.input_rate_hz > 0);
+  BOOST_TEST(report.call_time_ns.count == report.n_calls);
+
+  // The window never holds more than a track's worth of TPs.
+  BOOST_TEST(report.window_occupancy.max > 0u);
+  BOOST_TEST(report.window_occupancy.max <= 40u);
+
+  // Each TA goes out with the TP that closes its window, one window length or
+  // so after it starts, or at the final flush.
+  BOOST_TEST(report.emission_lag_ticks.min >= 1000u);
+  BOOST_TEST(report.emission_lag_ticks.max <= 101000u);
+
+  // The rates cover only what happened since the previous poll.
+  MakerStats::Report again = maker.stats()->poll();
+  BOOST_TEST(again.n_inputs == report.n_inputs);
+  BOOST_TEST(again.input_rate_hz == 0);
+}
+
+} /* namespace triggeralgs */
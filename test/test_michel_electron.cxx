@@ -0,0 +1,297 @@
+/**
+ * @file test_michel_electron.cxx
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE michel_electron
+
+#include "triggeralgs/MichelElectron/MichelTrackChecks.hpp"
+#include "triggeralgs/MichelElectron/TriggerActivityMakerMichelElectron.hpp"
+#include "triggeralgs/TPGenerator.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <random>
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+// MichelElectron before it kept the track between TPs: a plain window, whose
+// longest activity is found by sorting it by channel and scanning it on every
+// TP that does not fit in the window.
+class SortAndScanMichelElectron
+{
+public:
+  SortAndScanMichelElectron(timestamp_t window_length, uint16_t adjacency_threshold, uint16_t adj_tolerance)
+    : m_window_length(window_length)
+    , m_adjacency_threshold(adjacency_threshold)
+    , m_adj_tolerance(adj_tolerance)
+  {}
+
+  void operator()(const TriggerPrimitive& input_tp, std::vector<TriggerActivity>& output_ta)
+  {
+    if (m_window.empty()) {
+      reset(input_tp);
+    } else if (input_tp.time_start - m_time_start < m_window_length) {
+      m_window.push_back(input_tp);
+    } else if (longest_activity().size() > m_adjacency_threshold) {
+      if (is_michel(longest_activity())) {
+        output_ta.push_back(construct_ta());
+        reset(input_tp);
+      }
+    } else {
+      while (!m_window.empty() && !(input_tp.time_start - m_window.front().time_start < m_window_length))
+        m_window.pop_front();
+      if (m_window.empty()) {
+        reset(input_tp);
+      } else {
+        m_time_start = m_window.front().time_start;
+        m_window.push_back(input_tp);
+      }
+    }
+  }
+
+  void flush(timestamp_t until, std::vector<TriggerActivity>& output_ta)
+  {
+    if (m_window.empty() || until < m_time_start || until - m_time_start < m_window_length)
+      return;
+    std::vector<TriggerPrimitive> track_hits = longest_activity();
+    if (track_hits.size() > m_adjacency_threshold && is_michel(track_hits)) {
+      output_ta.push_back(construct_ta());
+      m_window.clear();
+    }
+  }
+
+  // A copy of the scan of the old maker, sorting with stable_sort as the new
+  // one does, so that TPs on one channel stay in the order they came.
+  std::vector<TriggerPrimitive> longest_activity() const
+  {
+    std::vector<TriggerPrimitive> trackHits;
+    std::vector<TriggerPrimitive> finalHits;
+
+    uint16_t adj = 1;
+    uint16_t max = 0;
+    unsigned int channel = 0;
+    unsigned int next_channel = 0;
+    unsigned int next = 0;
+    unsigned int tol_count = 0;
+
+    std::vector<TriggerPrimitive> hitList(m_window.begin(), m_window.end());
+    std::stable_sort(hitList.begin(), hitList.end(), [](const TriggerPrimitive& a, const TriggerPrimitive& b) {
+      return a.channel < b.channel;
+    });
+
+    for (std::size_t i = 0; i < hitList.size(); ++i) {
+      next = (i + 1) % hitList.size();
+      channel = hitList.at(i).channel;
+      next_channel = hitList.at(next).channel;
+
+      if (trackHits.size() == 0)
+        trackHits.push_back(hitList.at(i));
+
+      if (next_channel == 0)
+        next_channel = channel - 1;
+
+      if (next_channel == channel) {
+        trackHits.push_back(hitList.at(next));
+        continue;
+      } else if (next_channel == channel + 1) {
+        trackHits.push_back(hitList.at(next));
+        ++adj;
+      } else if (((next_channel == channel + 2) || (next_channel == channel + 3) || (next_channel == channel + 4) ||
+                  (next_channel == channel + 5)) &&
+                 (tol_count < m_adj_tolerance)) {
+        trackHits.push_back(hitList.at(next));
+        ++adj;
+        tol_count += next_channel - channel;
+      } else {
+        if (adj > max) {
+          max = adj;
+          finalHits = trackHits;
+        }
+        adj = 1;
+        tol_count = 0;
+        trackHits.clear();
+      }
+    }
+    return finalHits;
+  }
+
+private:
+  void reset(const TriggerPrimitive& input_tp)
+  {
+    m_window.assign(1, input_tp);
+    m_time_start = input_tp.time_start;
+  }
+
+  bool is_michel(const std::vector<TriggerPrimitive>& track_hits)
+  {
+    return m_checks.has_bragg_peak(track_hits) && m_checks.has_kinks(track_hits);
+  }
+
+  TriggerActivity construct_ta() const
+  {
+    TriggerActivity ta;
+    ta.time_start = m_time_start;
+    ta.time_end = m_window.back().time_start + m_window.back().time_over_threshold;
+    ta.channel_start = m_window.back().channel;
+    for (const TriggerPrimitive& tp : m_window)
+      ta.adc_integral += tp.adc_integral;
+    ta.inputs.assign(m_window.begin(), m_window.end());
+    return ta;
+  }
+
+  std::deque<TriggerPrimitive> m_window;
+  timestamp_t m_time_start = 0;
+  timestamp_t m_window_length;
+  uint16_t m_adjacency_threshold;
+  uint16_t m_adj_tolerance;
+  MichelTrackChecks m_checks;
+};
+
+// Muon tracks ending in Michel electrons, among noise. With `first_channel`
+// 0 and few channels, many TPs land on channel 0 and the tracks start there.
+std::vector<TriggerPrimitive>
+make_stream(unsigned seed, int first_channel, int n_channels)
+{
+  TPGenerator generator;
+  generator.configure({ { "seed", seed },
+                        { "first_channel", first_channel },
+                        { "n_channels", n_channels },
+                        { "noise_rate_hz", 50 + 20 * (seed % 10) },
+                        { "track_rate_hz", 300 },
+                        { "michel_rate_hz", 300 } });
+  std::vector<TriggerPrimitive> tps;
+  generator.generate(2000, tps);
+  return tps;
+}
+
+// Tracks that all start on channel 0, with several TPs on it, some of them
+// broken by gaps, among noise on the first few channels.
+std::vector<TriggerPrimitive>
+make_channel_0_stream(std::mt19937& random)
+{
+  std::vector<TriggerPrimitive> tps;
+  timestamp_t time = 1'000'000;
+  auto add_tp = [&](channel_t channel, uint32_t adc) { // NOLINT(build/unsigned)
+    TriggerPrimitive tp;
+    tp.type = TriggerPrimitive::Type::kTPC;
+    tp.time_start = time;
+    tp.time_over_threshold = 5 + random() % 20;
+    tp.time_peak = tp.time_start + random() % 10;
+    tp.channel = channel;
+    tp.adc_integral = adc;
+    tp.adc_peak = static_cast<uint16_t>(adc / 10);
+    tps.push_back(tp);
+    time += random() % 30;
+  };
+
+  for (int track = 0; track < 40; ++track) {
+    for (int i = random() % 5; i > 0; --i)
+      add_tp(random() % 8, 300 + random() % 500);
+    int length = 10 + random() % 40;
+    for (channel_t channel = 0; channel < length; ++channel) {
+      if (channel != 0 && random() % 10 == 0)
+        channel += random() % 5;
+      // Charge rising along the track, as towards a Bragg peak.
+      add_tp(channel, 500 + 40 * channel + random() % 300);
+      if (channel == 0 || random() % 5 == 0)
+        add_tp(channel, 500 + random() % 300);
+    }
+    time += 2000 + random() % 20000;
+  }
+  return tps;
+}
+
+std::size_t
+check_same_tas(const std::vector<TriggerPrimitive>& tps,
+               timestamp_t window_length,
+               uint16_t threshold,
+               uint16_t tolerance,
+               timestamp_t flush_interval)
+{
+  TriggerActivityMakerMichelElectron maker;
+  maker.configure(
+    { { "window_length", window_length }, { "adjacency_threshold", threshold }, { "adj_tolerance", tolerance } });
+  SortAndScanMichelElectron reference(window_length, threshold, tolerance);
+
+  std::vector<TriggerActivity> output_ta, expected_ta;
+  timestamp_t next_flush = tps.front().time_start + flush_interval;
+  for (const TriggerPrimitive& tp : tps) {
+    while (flush_interval != 0 && next_flush <= tp.time_start) {
+      maker.flush(next_flush, output_ta);
+      reference.flush(next_flush, expected_ta);
+      next_flush += flush_interval;
+    }
+    maker(tp, output_ta);
+    reference(tp, expected_ta);
+  }
+
+  BOOST_REQUIRE_EQUAL(output_ta.size(), expected_ta.size());
+  for (std::size_t i = 0; i < output_ta.size(); ++i) {
+    const TriggerActivity& ta = output_ta[i];
+    const TriggerActivity& expected = expected_ta[i];
+    BOOST_TEST(ta.time_start == expected.time_start);
+    BOOST_TEST(ta.time_end == expected.time_end);
+    BOOST_TEST(ta.channel_start == expected.channel_start);
+    BOOST_TEST(ta.adc_integral == expected.adc_integral);
+    BOOST_REQUIRE_EQUAL(ta.inputs.size(), expected.inputs.size());
+    for (std::size_t j = 0; j < ta.inputs.size(); ++j) {
+      BOOST_TEST(ta.inputs[j].channel == expected.inputs[j].channel);
+      BOOST_TEST(ta.inputs[j].time_start == expected.inputs[j].time_start);
+    }
+  }
+  return output_ta.size();
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(same_tas_as_sorting_and_scanning)
+{
+  std::size_t n_tas = 0;
+  for (unsigned seed = 1; seed <= 20; ++seed) {
+    std::vector<TriggerPrimitive> tps = make_stream(seed, 100, 2560);
+    for (uint16_t threshold : { 5, 15, 30 })
+      for (uint16_t tolerance : { 0, 3, 10 })
+        for (timestamp_t flush_interval : { 0, 700 })
+          n_tas += check_same_tas(tps, 3000 + 1000 * (seed % 4), threshold, tolerance, flush_interval);
+  }
+  BOOST_TEST_MESSAGE(n_tas << " TAs compared");
+  BOOST_TEST(n_tas > 20u);
+}
+
+BOOST_AUTO_TEST_CASE(same_tas_when_crowded_near_channel_0)
+{
+  std::size_t n_tas = 0;
+  for (unsigned seed = 1; seed <= 20; ++seed) {
+    std::vector<TriggerPrimitive> tps = make_stream(seed, 0, 40 + 10 * (seed % 5));
+    for (uint16_t threshold : { 5, 15, 30 })
+      for (uint16_t tolerance : { 0, 3, 10 })
+        for (timestamp_t flush_interval : { 0, 700 })
+          n_tas += check_same_tas(tps, 3000 + 1000 * (seed % 4), threshold, tolerance, flush_interval);
+  }
+
+  std::mt19937 random(7);
+  for (int n = 0; n < 20; ++n) {
+    std::vector<TriggerPrimitive> tps = make_channel_0_stream(random);
+    for (uint16_t threshold : { 5, 15, 30 })
+      for (uint16_t tolerance : { 0, 3, 10 })
+        for (timestamp_t flush_interval : { 0, 700 })
+          n_tas += check_same_tas(tps, 2000, threshold, tolerance, flush_interval);
+  }
+  BOOST_TEST_MESSAGE(n_tas << " TAs compared");
+  BOOST_TEST(n_tas > 40u);
+}
+
+} /* namespace triggeralgs */
@@ -0,0 +1,187 @@
+/**
+ * @file test_michel_track_checks.cxx
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE michel_track_checks
+
+#include "triggeralgs/MichelElectron/MichelTrackChecks.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <numeric>
+#include <random>
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+// MichelElectron's Bragg peak check as it was at first, save for returning
+// false without any cluster of charge instead of reading past the end.
+bool
+reference_bragg_peak(const std::vector<TriggerPrimitive>& trackHits)
+{
+  std::vector<float> adc_means_list;
+  uint16_t convolve_value = 6;
+  for (uint16_t i = 0; i < trackHits.size(); ++i) {
+    float adc_sum = 0;
+    for (uint16_t j = i; j < i + convolve_value; ++j) {
+      int hit = (j) % trackHits.size();
+      adc_sum += trackHits.at(hit).adc_integral;
+    }
+    adc_means_list.push_back(adc_sum / convolve_value);
+  }
+
+  float ped = std::accumulate(adc_means_list.begin(), adc_means_list.end(), 0.0) / adc_means_list.size();
+  float charge = 0;
+  std::vector<float> charge_dumps;
+  for (auto a : adc_means_list) {
+    if (a > ped) {
+      charge += a;
+    } else if (a < ped && charge != 0) {
+      charge_dumps.push_back(charge);
+      charge = 0;
+    }
+  }
+  if (charge_dumps.empty())
+    return false;
+
+  float max_charge = *max_element(charge_dumps.begin(), charge_dumps.end());
+  return max_charge == charge_dumps.front() || max_charge == charge_dumps.back();
+}
+
+// MichelElectron's kink check as it was at first.
+bool
+reference_kinks(const std::vector<TriggerPrimitive>& finalHits)
+{
+  std::vector<float> runningGradient;
+  std::vector<float> runningMeanGradient;
+  for (std::size_t i = 0; i < finalHits.size() - 2; i++) {
+    if (finalHits.at(i + 2).channel == finalHits.at(i).channel ||
+        (finalHits.at(i + 2).time_start == finalHits.at(i).time_start)) {
+      continue;
+    }
+    int diff = finalHits.at(i + 2).time_start - finalHits.at(i).time_start;
+    if ((std::abs(diff) > 1000) || ((std::abs(finalHits.at(i + 2).channel - finalHits.at(i).channel) > 6))) {
+      continue;
+    }
+    float dz = (finalHits.at(i + 2).channel - finalHits.at(i).channel) * 4.67;
+    long long int dt = finalHits.at(i + 2).time_start - finalHits.at(i).time_start; // NOLINT(runtime/int)
+    float dx = dt * 0.028;
+    runningGradient.push_back(dz / dx);
+  }
+
+  if (runningGradient.size() > 10) {
+    for (std::size_t g = 0; g < runningGradient.size() - 1; g++)
+      runningMeanGradient.push_back((runningGradient.at(g) + runningGradient.at(g + 1)) / 2);
+    if (runningMeanGradient.size() > 10) {
+      float mean = (std::abs(std::accumulate(runningMeanGradient.begin(), runningMeanGradient.end(), 0.0))) /
+                   (runningMeanGradient.size());
+      return (std::abs(runningMeanGradient.front()) + mean > 2.5 * mean) ||
+             ((std::abs(runningMeanGradient.back() + mean)) > 2.5 * mean);
+    }
+  }
+  return false;
+}
+
+// A track in order of channel: a straight line in channel and time that may
+// bend near its end, with some channels skipped or hit twice, the odd TP far
+// off the line, and charge that may rise towards one end.
+std::vector<TriggerPrimitive>
+make_track(std::mt19937& random, std::size_t length)
+{
+  std::vector<TriggerPrimitive> track;
+  double slope = (static_cast<int>(random() % 41) - 20) / 2.0;
+  std::size_t bend = length - random() % (length / 4 + 1);
+  double bent_slope = (static_cast<int>(random() % 81) - 40) / 2.0;
+  uint32_t adc_scale = random() % 4 == 0 ? 5'000'000 : 2000; // NOLINT(build/unsigned)
+  int peak_end = random() % 3;
+  double time = 1'000'000'000;
+  int channel = random() % 1000;
+  for (std::size_t i = 0; i < length; ++i) {
+    int step = random() % 8 == 0 ? random() % 3 : 1;
+    channel += step;
+    time += (i < bend ? slope : bent_slope) * step + static_cast<int>(random() % 5) - 2;
+    TriggerPrimitive tp;
+    tp.channel = channel;
+    tp.time_start = static_cast<timestamp_t>(time);
+    if (random() % 30 == 0)
+      tp.time_start += random() % 3000;
+    tp.adc_integral = adc_scale / 2 + random() % adc_scale;
+    if ((peak_end == 1 && i + 8 > length) || (peak_end == 2 && i < 8))
+      tp.adc_integral *= 4;
+    track.push_back(tp);
+  }
+  return track;
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(same_results_as_the_first_checks)
+{
+  std::mt19937 random(42);
+  MichelTrackChecks checks;
+  std::size_t n_bragg = 0;
+  std::size_t n_kinks = 0;
+  std::size_t n_tracks = 0;
+  for (std::size_t length : { 3, 5, 8, 13, 20, 40, 100, 300, 1000 }) {
+    for (int n = 0; n < 1000; ++n) {
+      std::vector<TriggerPrimitive> track = make_track(random, length);
+      bool bragg = checks.has_bragg_peak(track);
+      BOOST_REQUIRE_EQUAL(bragg, reference_bragg_peak(track));
+      bool kinks = checks.has_kinks(track);
+      BOOST_REQUIRE_EQUAL(kinks, reference_kinks(track));
+      n_bragg += bragg;
+      n_kinks += kinks;
+      ++n_tracks;
+    }
+  }
+  BOOST_TEST_MESSAGE(n_tracks << " tracks, " << n_bragg << " with a Bragg peak, " << n_kinks << " with kinks");
+  BOOST_TEST(n_bragg > n_tracks / 10);
+  BOOST_TEST(n_bragg < n_tracks * 9 / 10);
+  BOOST_TEST(n_kinks > n_tracks / 10);
+  BOOST_TEST(n_kinks < n_tracks * 9 / 10);
+}
+
+BOOST_AUTO_TEST_CASE(tracks_spanning_more_than_2_to_the_31_ticks)
+{
+  std::mt19937 random(7);
+  MichelTrackChecks checks;
+  for (int n = 0; n < 200; ++n) {
+    std::vector<TriggerPrimitive> track = make_track(random, 60);
+    // Shifting a TP by 2^32 ticks keeps its time difference to the others the
+    // same as an int, but not as a long long.
+    track[random() % track.size()].time_start += timestamp_t(1) << 32;
+    BOOST_REQUIRE_EQUAL(checks.has_kinks(track), reference_kinks(track));
+  }
+}
+
+BOOST_AUTO_TEST_CASE(short_and_flat_tracks)
+{
+  MichelTrackChecks checks;
+  std::vector<TriggerPrimitive> track;
+  BOOST_TEST(!checks.has_bragg_peak(track));
+  BOOST_TEST(!checks.has_kinks(track));
+
+  // Equal charges leave no clusters above the baseline, and a straight line
+  // has no kinks.
+  for (int channel = 0; channel < 20; ++channel) {
+    TriggerPrimitive tp;
+    tp.channel = channel;
+    tp.time_start = 1000 + 10 * channel;
+    tp.adc_integral = 1000;
+    track.push_back(tp);
+    BOOST_TEST(!checks.has_bragg_peak(track));
+    BOOST_TEST(!checks.has_kinks(track));
+  }
+}
+
+} /* namespace triggeralgs */
@@ -0,0 +1,265 @@
+/**
+ * @file test_reorder_buffer.cxx
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE reorder_buffer
+
+#include "triggeralgs/ReorderBuffer.hpp"
+#include "triggeralgs/TriggerPrimitive.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <random>
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+// A TP starting at `time`, told apart from the others by its channel.
+TriggerPrimitive
+make_tp(timestamp_t time, channel_t id)
+{
+  TriggerPrimitive tp;
+  tp.time_start = time;
+  tp.channel = id;
+  return tp;
+}
+
+// Times around a steady rise, each up to `jitter` ticks off, with many ties.
+std::vector<TriggerPrimitive>
+jittered_stream(std::size_t n, timestamp_t jitter, unsigned seed)
+{
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<timestamp_t> offset(0, jitter);
+  std::vector<TriggerPrimitive> tps;
+  for (std::size_t i = 0; i < n; ++i)
+    tps.push_back(make_tp(1000 + 2 * (i / 3) + offset(rng), static_cast<channel_t>(i)));
+  return tps;
+}
+
+bool
+earlier(const TriggerPrimitive& a, const TriggerPrimitive& b)
+{
+  return a.time_start < b.time_start;
+}
+
+void
+check_accounting(const ReorderBuffer<TriggerPrimitive>& buffer)
+{
+  const auto& counters = buffer.counters();
+  BOOST_TEST(counters.n_released + counters.n_late + buffer.size() == counters.n_received);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(releases_in_time_order_and_ties_in_arrival_order)
+{
+  std::vector<TriggerPrimitive> input = jittered_stream(5000, 20, 1);
+
+  // The jitter is within max_lateness and the capacity is never reached, so
+  // nothing is late or released early, and the output is the input stably
+  // sorted by time.
+  ReorderBuffer<TriggerPrimitive> buffer(20, 1000);
+  std::vector<TriggerPrimitive> output;
+  auto release = [&](const TriggerPrimitive& tp) { output.push_back(tp); };
+  for (const TriggerPrimitive& tp : input) {
+    BOOST_TEST(buffer.push(tp, release));
+    BOOST_TEST(buffer.size() <= 1000);
+  }
+  buffer.drain(release);
+
+  std::stable_sort(input.begin(), input.end(), earlier);
+  BOOST_TEST_REQUIRE(output.size() == input.size());
+  for (std::size_t i = 0; i < input.size(); ++i) {
+    BOOST_TEST(output[i].time_start == input[i].time_start);
+    BOOST_TEST(output[i].channel == input[i].channel);
+  }
+  BOOST_TEST(buffer.counters().n_late == 0);
+  BOOST_TEST(buffer.counters().n_overflow == 0);
+  BOOST_TEST(buffer.is_empty());
+  check_accounting(buffer);
+}
+
+BOOST_AUTO_TEST_CASE(holds_items_for_max_lateness)
+{
+  ReorderBuffer<TriggerPrimitive> buffer(10, 100);
+  std::vector<TriggerPrimitive> output;
+  auto release = [&](const TriggerPrimitive& tp) { output.push_back(tp); };
+
+  buffer.push(make_tp(100, 0), release);
+  buffer.push(make_tp(109, 1), release);
+  BOOST_TEST(output.empty());
+  buffer.push(make_tp(110, 2), release); // 100 can no longer be overtaken
+  BOOST_TEST_REQUIRE(output.size() == 1);
+  BOOST_TEST(output[0].channel == 0);
+  buffer.push(make_tp(105, 3), release); // Late against 110, but not against what was released
+  buffer.push(make_tp(120, 4), release);
+  BOOST_TEST_REQUIRE(output.size() == 4);
+  BOOST_TEST(output[1].channel == 3);
+  BOOST_TEST(output[2].channel == 1);
+  BOOST_TEST(output[3].channel == 2);
+  BOOST_TEST(buffer.counters().n_late == 0);
+}
+
+BOOST_AUTO_TEST_CASE(drops_items_starting_before_one_released)
+{
+  ReorderBuffer<TriggerPrimitive> buffer(10, 100);
+  std::vector<TriggerPrimitive> output;
+  auto release = [&](const TriggerPrimitive& tp) { output.push_back(tp); };
+
+  buffer.push(make_tp(100, 0), release);
+  buffer.push(make_tp(110, 1), release);
+  BOOST_TEST_REQUIRE(output.size() == 1);
+  BOOST_TEST(!buffer.push(make_tp(99, 2), release));
+  BOOST_TEST(buffer.push(make_tp(100, 3), release)); // A tie with the last released is in order
+  BOOST_TEST(buffer.counters().n_late == 1);
+  BOOST_TEST(buffer.counters().n_received == 4);
+  check_accounting(buffer);
+
+  buffer.drain(release);
+  BOOST_TEST(output.size() == 3);
+  BOOST_TEST(output[1].channel == 3);
+  check_accounting(buffer);
+}
+
+BOOST_AUTO_TEST_CASE(releases_the_earliest_when_full)
+{
+  ReorderBuffer<TriggerPrimitive> buffer(1000000, 4);
+  std::vector<TriggerPrimitive> output;
+  auto release = [&](const TriggerPrimitive& tp) { output.push_back(tp); };
+
+  for (timestamp_t time : { 50, 40, 60, 30 })
+    buffer.push(make_tp(time, static_cast<channel_t>(time)), release);
+  BOOST_TEST(output.empty());
+
+  buffer.push(make_tp(70, 70), release); // Full: 30 goes early
+  BOOST_TEST_REQUIRE(output.size() == 1);
+  BOOST_TEST(output[0].time_start == 30);
+  buffer.push(make_tp(35, 35), release); // Full, and the input is the earliest
+  BOOST_TEST_REQUIRE(output.size() == 2);
+  BOOST_TEST(output[1].time_start == 35);
+  BOOST_TEST(buffer.size() == 4);
+  BOOST_TEST(buffer.counters().n_overflow == 2);
+  BOOST_TEST(buffer.counters().max_buffered == 4);
+
+  BOOST_TEST(!buffer.push(make_tp(34, 34), release)); // Starts before 35, released early
+  buffer.drain(release);
+  std::vector<timestamp_t> times;
+  for (const TriggerPrimitive& tp : output)
+    times.push_back(tp.time_start);
+  BOOST_TEST(times == (std::vector<timestamp_t>{ 30, 35, 40, 50, 60, 70 }), boost::test_tools::per_element());
+  BOOST_TEST(buffer.counters().n_late == 1);
+  check_accounting(buffer);
+}
+
+BOOST_AUTO_TEST_CASE(release_until_is_a_watermark)
+{
+  ReorderBuffer<TriggerPrimitive> buffer(1000, 100);
+  std::vector<TriggerPrimitive> output;
+  auto release = [&](const TriggerPrimitive& tp) { output.push_back(tp); };
+
+  for (timestamp_t time : { 130, 100, 120, 150, 110 })
+    buffer.push(make_tp(time, static_cast<channel_t>(time)), release);
+  BOOST_TEST(output.empty());
+
+  buffer.release_until(130, release); // Releases what starts before 130, not 130 itself
+  BOOST_TEST_REQUIRE(output.size() == 3);
+  BOOST_TEST(output[0].time_start == 100);
+  BOOST_TEST(output[1].time_start == 110);
+  BOOST_TEST(output[2].time_start == 120);
+  BOOST_TEST(buffer.size() == 2);
+
+  // Inputs before the watermark are late, even with nothing released there.
+  BOOST_TEST(!buffer.push(make_tp(125, 125), release));
+  BOOST_TEST(buffer.push(make_tp(130, 131), release));
+
+  // A watermark earlier than the last releases nothing and keeps the later one.
+  buffer.release_until(50, release);
+  BOOST_TEST(output.size() == 3);
+  BOOST_TEST(!buffer.push(make_tp(129, 129), release));
+
+  // The watermark counts as stream time, so items max_lateness behind it go
+  // on the next push.
+  buffer.release_until(1140, release);
+  BOOST_TEST(output.size() == 6);
+  buffer.push(make_tp(1140, 1140), release);
+  BOOST_TEST(output.size() == 6);
+  buffer.push(make_tp(2140, 2140), release);
+  BOOST_TEST(output.size() == 7);
+
+  BOOST_TEST(buffer.counters().n_late == 2);
+  check_accounting(buffer);
+}
+
+BOOST_AUTO_TEST_CASE(every_item_is_released_or_late)
+{
+  // Jitter beyond max_lateness and a small capacity, so that some items are
+  // late and some released early.
+  std::vector<TriggerPrimitive> input = jittered_stream(20000, 200, 2);
+  ReorderBuffer<TriggerPrimitive> buffer(50, 16);
+  std::vector<TriggerPrimitive> output;
+  auto release = [&](const TriggerPrimitive& tp) { output.push_back(tp); };
+  std::size_t n_rejected = 0;
+  for (std::size_t i = 0; i < input.size(); ++i) {
+    if (!buffer.push(input[i], release))
+      ++n_rejected;
+    if (i % 1000 == 999)
+      buffer.release_until(input[i].time_start, release);
+    check_accounting(buffer);
+  }
+  buffer.drain(release);
+
+  const auto& counters = buffer.counters();
+  BOOST_TEST(counters.n_late > 0);
+  BOOST_TEST(counters.n_overflow > 0);
+  BOOST_TEST(counters.n_late == n_rejected);
+  BOOST_TEST(counters.n_released == output.size());
+  BOOST_TEST(counters.n_released + counters.n_late == counters.n_received);
+  BOOST_TEST(counters.n_received == input.size());
+  BOOST_TEST(counters.max_buffered <= 16);
+  BOOST_TEST(std::is_sorted(output.begin(), output.end(), earlier));
+}
+
+BOOST_AUTO_TEST_CASE(configure_starts_again)
+{
+  ReorderBuffer<TriggerPrimitive> buffer(10, 4);
+  std::vector<TriggerPrimitive> output;
+  auto release = [&](const TriggerPrimitive& tp) { output.push_back(tp); };
+  for (timestamp_t time = 1000; time < 1010; ++time)
+    buffer.push(make_tp(time, 0), release);
+  buffer.push(make_tp(5, 0), release);
+  buffer.release_until(5000, release);
+  BOOST_TEST(buffer.counters().n_received == 11);
+
+  // After a reconfigure, as at a new run, early times are not late, the
+  // counters start from zero and nothing is released before max_lateness.
+  buffer.configure(100, 8);
+  output.clear();
+  BOOST_TEST(buffer.is_empty());
+  BOOST_TEST(buffer.counters().n_received == 0);
+  BOOST_TEST(buffer.counters().n_released == 0);
+  BOOST_TEST(buffer.counters().n_late == 0);
+  BOOST_TEST(buffer.counters().n_overflow == 0);
+  BOOST_TEST(buffer.counters().max_buffered == 0);
+
+  BOOST_TEST(buffer.push(make_tp(20, 1), release));
+  BOOST_TEST(buffer.push(make_tp(10, 2), release));
+  BOOST_TEST(buffer.push(make_tp(10, 3), release));
+  BOOST_TEST(output.empty());
+  buffer.drain(release);
+  BOOST_TEST_REQUIRE(output.size() == 3);
+  BOOST_TEST(output[0].channel == 2);
+  BOOST_TEST(output[1].channel == 3);
+  BOOST_TEST(output[2].channel == 1);
+  BOOST_TEST(buffer.counters().n_late == 0);
+  check_accounting(buffer);
+}
+
+} /* namespace triggeralgs */
@@ -0,0 +1,279 @@
+/**
+ * @file test_sharding.cxx
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE sharding
+
+#include "triggeralgs/Issues.hpp"
+#include "triggeralgs/ShardedTriggerActivityMaker.hpp"
+#include "triggeralgs/SPSCQueue.hpp"
+#include "triggeralgs/TPGenerator.hpp"
+#include "triggeralgs/TriggerActivityFactory.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+const std::size_t max_shards = 5;
+
+// The time-ordered TPs of several detector elements, each with its own noise
+// and tracks.
+std::vector<TriggerPrimitive>
+make_stream()
+{
+  std::vector<TriggerPrimitive> tps;
+  for (detid_t detid = 0; detid < 7; ++detid) {
+    TPGenerator generator;
+    generator.configure(
+      { { "seed", detid + 1 }, { "detid", detid }, { "noise_rate_hz", 2000 }, { "track_rate_hz", 200 } });
+    generator.generate(1500, tps);
+  }
+  std::stable_sort(tps.begin(), tps.end(), [](const TriggerPrimitive& a, const TriggerPrimitive& b) {
+    return a.time_start < b.time_start;
+  });
+  return tps;
+}
+
+nlohmann::json
+make_config(const std::string& algorithm, const std::string& shard_by, std::size_t n_shards)
+{
+  return { { "algorithm", algorithm }, { "shard_by", shard_by }, { "channel_range", 64 }, { "n_shards", n_shards },
+           { "queue_size", 16 },       { "prescale", 3 },         { "min_pts", 3 },        { "eps", 10 } };
+}
+
+// The TAs of each shard, in the order that shard made them.
+std::vector<std::vector<TriggerActivity>>
+split_by_shard(const ShardedTriggerActivityMaker& sharded, const std::vector<TriggerActivity>& tas)
+{
+  std::vector<std::vector<TriggerActivity>> by_shard(sharded.n_shards());
+  for (const TriggerActivity& ta : tas) {
+    BOOST_REQUIRE(!ta.inputs.empty());
+    by_shard[sharded.shard_of(ta.inputs.front())].push_back(ta);
+  }
+  return by_shard;
+}
+
+// The TAs of new, unsharded makers, one per shard, each fed the first `n_tps`
+// TPs of its shard in turn, then flushed at `until` unless it is zero.
+std::vector<std::vector<TriggerActivity>>
+run_in_turn(const ShardedTriggerActivityMaker& sharded,
+            const nlohmann::json& config,
+            const std::vector<TriggerPrimitive>& tps,
+            std::size_t n_tps,
+            timestamp_t until)
+{
+  std::vector<std::vector<TriggerActivity>> by_shard(sharded.n_shards());
+  for (std::size_t shard = 0; shard < sharded.n_shards(); ++shard) {
+    std::unique_ptr<TriggerActivityMaker> maker =
+      TriggerActivityFactory::get_instance()->build_maker(config["algorithm"].get<std::string>());
+    maker->configure(config);
+    for (std::size_t i = 0; i < n_tps; ++i)
+      if (sharded.shard_of(tps[i]) == shard)
+        (*maker)(tps[i], by_shard[shard]);
+    if (until != 0)
+      maker->flush(until, by_shard[shard]);
+  }
+  return by_shard;
+}
+
+void
+check_same(const std::vector<std::vector<TriggerActivity>>& sharded,
+           const std::vector<std::vector<TriggerActivity>>& in_turn)
+{
+  BOOST_REQUIRE(sharded.size() == in_turn.size());
+  for (std::size_t shard = 0; shard < sharded.size(); ++shard) {
+    BOOST_TEST_CONTEXT("shard " << shard)
+    {
+      BOOST_TEST_REQUIRE(sharded[shard].size() == in_turn[shard].size());
+      for (std::size_t i = 0; i < sharded[shard].size(); ++i) {
+        const TriggerActivity& a = sharded[shard][i];
+        const TriggerActivity& b = in_turn[shard][i];
+        BOOST_TEST(a.time_start == b.time_start);
+        BOOST_TEST(a.time_end == b.time_end);
+        BOOST_TEST(a.channel_start == b.channel_start);
+        BOOST_TEST(a.channel_end == b.channel_end);
+        BOOST_TEST(a.adc_integral == b.adc_integral);
+        BOOST_TEST(a.inputs.size() == b.inputs.size());
+      }
+    }
+  }
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(queue_keeps_order_across_threads)
+{
+  SPSCQueue<int> queue(5);
+  BOOST_TEST(queue.capacity() == 8);
+
+  const int n_items = 100000;
+  std::thread producer([&] {
+    for (int i = 0; i < n_items; ++i)
+      while (!queue.try_push(i))
+        std::this_thread::yield();
+  });
+  int expected = 0;
+  int item;
+  while (expected < n_items) {
+    if (!queue.try_pop(item)) {
+      std::this_thread::yield();
+      continue;
+    }
+    BOOST_REQUIRE(item == expected);
+    ++expected;
+  }
+  producer.join();
+  BOOST_TEST(queue.is_empty());
+  BOOST_TEST(!queue.try_pop(item));
+}
+
+BOOST_AUTO_TEST_CASE(needs_shards_to_send_to)
+{
+  TriggerPrimitive tp;
+  tp.channel = 100;
+  std::vector<TriggerActivity> output_ta;
+
+  ShardedTriggerActivityMaker sharded;
+  BOOST_TEST(sharded.n_shards() == 0u);
+  BOOST_CHECK_THROW(sharded.shard_of(tp), BadConfiguration);
+  BOOST_CHECK_THROW(sharded(tp, output_ta), BadConfiguration);
+
+  // A rejected configuration leaves no shards, even after a good one.
+  nlohmann::json config = make_config("TriggerActivityMakerPrescalePlugin", "channel", 3);
+  sharded.configure(config);
+  BOOST_TEST(sharded.shard_of(tp) == 1u);
+  config["channel_range"] = 0;
+  BOOST_CHECK_THROW(sharded.configure(config), BadConfiguration);
+  BOOST_TEST(sharded.n_shards() == 0u);
+  BOOST_CHECK_THROW(sharded.shard_of(tp), BadConfiguration);
+  config["channel_range"] = 64;
+  config["n_shards"] = 0;
+  BOOST_CHECK_THROW(sharded.configure(config), BadConfiguration);
+  BOOST_CHECK_THROW(sharded.shard_of(tp), BadConfiguration);
+}
+
+BOOST_AUTO_TEST_CASE(output_matches_the_shards_run_in_turn)
+{
+  const std::vector<TriggerPrimitive> tps = make_stream();
+  const timestamp_t until = tps.back().time_start + 1;
+
+  for (std::string algorithm : { "TriggerActivityMakerPrescalePlugin", "TriggerActivityMakerDBSCANPlugin" }) {
+    for (std::string shard_by : { "detid", "channel" }) {
+      for (std::size_t n_shards = 1; n_shards <= max_shards; ++n_shards) {
+        BOOST_TEST_CONTEXT(algorithm << " by " << shard_by << ", " << n_shards << " shards")
+        {
+          nlohmann::json config = make_config(algorithm, shard_by, n_shards);
+          ShardedTriggerActivityMaker sharded;
+          sharded.configure(config);
+          BOOST_TEST(sharded.n_shards() == n_shards);
+
+          std::vector<TriggerActivity> output_ta;
+          for (const TriggerPrimitive& tp : tps)
+            sharded(tp, output_ta);
+          sharded.flush(until, output_ta);
+
+          std::vector<std::vector<TriggerActivity>> in_turn = run_in_turn(sharded, config, tps, tps.size(), until);
+          BOOST_TEST(!in_turn.front().empty());
+          check_same(split_by_shard(sharded, output_ta), in_turn);
+        }
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(flush_and_drain_return_everything_made_before_them)
+{
+  const std::vector<TriggerPrimitive> tps = make_stream();
+  const std::size_t half = tps.size() / 2;
+  const timestamp_t until = tps.back().time_start + 1;
+
+  for (std::string shard_by : { "detid", "channel" }) {
+    for (std::size_t n_shards = 1; n_shards <= max_shards; ++n_shards) {
+      BOOST_TEST_CONTEXT("by " << shard_by << ", " << n_shards << " shards")
+      {
+        nlohmann::json config = make_config("TriggerActivityMakerDBSCANPlugin", shard_by, n_shards);
+        ShardedTriggerActivityMaker sharded;
+        sharded.configure(config);
+
+        // Every TA made from the first half, without flushing.
+        std::vector<TriggerActivity> output_ta;
+        for (std::size_t i = 0; i < half; ++i)
+          sharded(tps[i], output_ta);
+        sharded.drain(output_ta);
+        check_same(split_by_shard(sharded, output_ta), run_in_turn(sharded, config, tps, half, 0));
+
+        // A second drain has nothing left to return.
+        std::size_t n_drained = output_ta.size();
+        sharded.drain(output_ta);
+        BOOST_TEST(output_ta.size() == n_drained);
+
+        // Then every TA, flushed out.
+        for (std::size_t i = half; i < tps.size(); ++i)
+          sharded(tps[i], output_ta);
+        sharded.flush(until, output_ta);
+        check_same(split_by_shard(sharded, output_ta), run_in_turn(sharded, config, tps, tps.size(), until));
+      }
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(stops_with_full_queues)
+{
+  const std::vector<TriggerPrimitive> tps = make_stream();
+  const timestamp_t until = tps.back().time_start + 1;
+
+  for (std::string shard_by : { "detid", "channel" }) {
+    for (std::size_t n_shards = 1; n_shards <= max_shards; ++n_shards) {
+      BOOST_TEST_CONTEXT("by " << shard_by << ", " << n_shards << " shards")
+      {
+        // A TA for every TP, through queues of two, so that the shards block
+        // on their output queues and the caller on their input queues.
+        nlohmann::json config = make_config("TriggerActivityMakerPrescalePlugin", shard_by, n_shards);
+        config["prescale"] = 1;
+        config["queue_size"] = 2;
+
+        std::vector<TriggerActivity> output_ta;
+        {
+          ShardedTriggerActivityMaker sharded;
+          sharded.configure(config);
+          for (std::size_t i = 0; i < 200; ++i)
+            sharded(tps[i], output_ta);
+          std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        } // Stopped by the destructor.
+
+        ShardedTriggerActivityMaker sharded;
+        sharded.configure(config);
+        for (std::size_t i = 0; i < 200; ++i)
+          sharded(tps[i], output_ta);
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+        // Reconfiguring stops the old shards, and the new ones start afresh.
+        config["prescale"] = 2;
+        sharded.configure(config);
+        output_ta.clear();
+        for (const TriggerPrimitive& tp : tps)
+          sharded(tp, output_ta);
+        sharded.flush(until, output_ta);
+        check_same(split_by_shard(sharded, output_ta), run_in_turn(sharded, config, tps, tps.size(), until));
+      }
+    }
+  }
+}
+
+} /* namespace triggeralgs */
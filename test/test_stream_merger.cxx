@@ -0,0 +1,243 @@
+/**
+ * @file test_stream_merger.cxx
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE stream_merger
+
+#include "triggeralgs/StreamMerger.hpp"
+#include "triggeralgs/TriggerActivity.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <limits>
+#include <random>
+#include <utility>
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+// A TA starting at `time`, told apart from the others by its first channel.
+TriggerActivity
+make_ta(timestamp_t time, channel_t id)
+{
+  TriggerActivity ta;
+  ta.time_start = time;
+  ta.channel_start = id;
+  return ta;
+}
+
+std::vector<timestamp_t>
+times_of(const std::vector<TriggerActivity>& tas)
+{
+  std::vector<timestamp_t> times;
+  for (const TriggerActivity& ta : tas)
+    times.push_back(ta.time_start);
+  return times;
+}
+
+// The merge done the slow way: release the earliest queued item, the lowest
+// input first on a tie, while it starts no later than every watermark of an
+// input with nothing queued.
+class SlowMerger
+{
+public:
+  explicit SlowMerger(std::size_t n_inputs)
+    : m_queues(n_inputs)
+    , m_watermarks(n_inputs, 0)
+  {}
+
+  bool push(std::size_t input, const TriggerActivity& ta)
+  {
+    if (ta.time_start < m_watermarks[input])
+      return false;
+    m_watermarks[input] = ta.time_start;
+    m_queues[input].push_back(ta);
+    return true;
+  }
+
+  void advance(std::size_t input, timestamp_t until) { m_watermarks[input] = std::max(m_watermarks[input], until); }
+
+  void release(std::vector<TriggerActivity>& output)
+  {
+    while (true) {
+      timestamp_t held_until = std::numeric_limits<timestamp_t>::max();
+      std::size_t earliest = m_queues.size();
+      for (std::size_t i = 0; i < m_queues.size(); ++i) {
+        if (m_queues[i].empty())
+          held_until = std::min(held_until, m_watermarks[i]);
+        else if (earliest == m_queues.size() || m_queues[i].front().time_start < m_queues[earliest].front().time_start)
+          earliest = i;
+      }
+      if (earliest == m_queues.size() || m_queues[earliest].front().time_start > held_until)
+        return;
+      output.push_back(m_queues[earliest].front());
+      m_queues[earliest].pop_front();
+    }
+  }
+
+private:
+  std::vector<std::deque<TriggerActivity>> m_queues;
+  std::vector<timestamp_t> m_watermarks;
+};
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(one_input_passes_straight_through)
+{
+  StreamMerger<TriggerActivity> merger(1);
+  std::vector<TriggerActivity> output;
+  auto release = [&](TriggerActivity&& ta) { output.push_back(std::move(ta)); };
+
+  for (timestamp_t time : { 10, 20, 20, 35 }) {
+    BOOST_TEST(merger.push(0, make_ta(time, 0)));
+    merger.release(release);
+    BOOST_TEST(merger.size() == 0);
+  }
+  BOOST_TEST(!merger.push(0, make_ta(30, 0)));
+  BOOST_TEST(times_of(output) == (std::vector<timestamp_t>{ 10, 20, 20, 35 }), boost::test_tools::per_element());
+  BOOST_TEST(merger.counters().n_released == 4);
+  BOOST_TEST(merger.counters().n_late == 1);
+  BOOST_TEST(merger.counters().max_buffered == 1);
+}
+
+BOOST_AUTO_TEST_CASE(late_only_against_its_own_watermark)
+{
+  StreamMerger<TriggerActivity> merger(3);
+  std::vector<TriggerActivity> output;
+  auto release = [&](TriggerActivity&& ta) { output.push_back(std::move(ta)); };
+
+  BOOST_TEST(merger.push(0, make_ta(100, 0)));
+  merger.advance(1, 500);
+  BOOST_TEST(merger.watermark(1) == 500);
+  BOOST_TEST(!merger.push(1, make_ta(50, 1)));  // Before input 1's watermark
+  BOOST_TEST(merger.push(2, make_ta(50, 2)));   // Input 2's watermark is still 0
+  BOOST_TEST(!merger.push(0, make_ta(99, 0)));  // Before input 0's last item
+  BOOST_TEST(merger.push(0, make_ta(100, 3)));  // A tie with it is in order
+  merger.advance(0, 50);                        // Watermarks only move up
+  BOOST_TEST(merger.watermark(0) == 100);
+  BOOST_TEST(merger.counters().n_late == 2);
+
+  merger.drain(release);
+  BOOST_TEST(times_of(output) == (std::vector<timestamp_t>{ 50, 100, 100 }), boost::test_tools::per_element());
+  BOOST_TEST(output[1].channel_start == 0);
+  BOOST_TEST(output[2].channel_start == 3);
+  BOOST_TEST(merger.counters().n_released == 3);
+}
+
+BOOST_AUTO_TEST_CASE(empty_input_holds_back_the_others)
+{
+  StreamMerger<TriggerActivity> merger(3);
+  std::vector<TriggerActivity> output;
+  auto release = [&](TriggerActivity&& ta) { output.push_back(std::move(ta)); };
+
+  merger.push(0, make_ta(10, 0));
+  merger.push(0, make_ta(30, 0));
+  merger.push(1, make_ta(20, 1));
+  merger.push(1, make_ta(40, 1));
+  merger.release(release);
+  BOOST_TEST(output.empty()); // Input 2 could still produce anything from 0
+  BOOST_TEST(merger.size() == 4);
+
+  merger.advance(2, 15);
+  merger.release(release);
+  BOOST_TEST(times_of(output) == (std::vector<timestamp_t>{ 10 }), boost::test_tools::per_element());
+
+  // An item starting at an empty input's watermark goes first: anything the
+  // input produces later starts no earlier.
+  merger.advance(2, 20);
+  merger.release(release);
+  BOOST_TEST(times_of(output) == (std::vector<timestamp_t>{ 10, 20 }), boost::test_tools::per_element());
+
+  // Once input 2 is closed, input 0 holds back 40 at its own watermark, 30.
+  merger.close(2);
+  merger.release(release);
+  BOOST_TEST(times_of(output) == (std::vector<timestamp_t>{ 10, 20, 30 }), boost::test_tools::per_element());
+  BOOST_TEST(merger.watermark(0) == 30);
+
+  merger.close(0);
+  merger.release(release);
+  BOOST_TEST(times_of(output) == (std::vector<timestamp_t>{ 10, 20, 30, 40 }), boost::test_tools::per_element());
+  BOOST_TEST(merger.size() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(ties_between_queued_items_go_to_the_lower_input)
+{
+  StreamMerger<TriggerActivity> merger(4);
+  std::vector<TriggerActivity> output;
+  auto release = [&](TriggerActivity&& ta) { output.push_back(std::move(ta)); };
+
+  merger.push(3, make_ta(7, 3));
+  merger.push(1, make_ta(7, 1));
+  merger.push(2, make_ta(7, 2));
+  merger.advance(0, 7);
+  merger.release(release);
+  BOOST_TEST_REQUIRE(output.size() == 3);
+  BOOST_TEST(output[0].channel_start == 1);
+  BOOST_TEST(output[1].channel_start == 2);
+  BOOST_TEST(output[2].channel_start == 3);
+}
+
+BOOST_AUTO_TEST_CASE(matches_the_slow_merge)
+{
+  for (std::size_t n_inputs : { 1, 2, 3, 5, 7, 8, 13 }) {
+    BOOST_TEST_CONTEXT(n_inputs << " inputs")
+    {
+      std::mt19937 rng(static_cast<unsigned>(n_inputs));
+      std::vector<timestamp_t> next_time(n_inputs, 0);
+      StreamMerger<TriggerActivity> merger(n_inputs);
+      SlowMerger slow(n_inputs);
+      std::vector<TriggerActivity> output, expected;
+      auto release = [&](TriggerActivity&& ta) { output.push_back(std::move(ta)); };
+
+      for (int step = 0; step < 20000; ++step) {
+        std::size_t input = rng() % n_inputs;
+        unsigned what = rng() % 20;
+        if (what == 0) {
+          timestamp_t until = next_time[input] + rng() % 50;
+          merger.advance(input, until);
+          slow.advance(input, until);
+        } else if (what == 1 && next_time[input] > 30) {
+          // Late against its own input.
+          TriggerActivity ta = make_ta(next_time[input] - 1 - rng() % 30, static_cast<channel_t>(step));
+          BOOST_TEST(!slow.push(input, ta));
+          BOOST_TEST(!merger.push(input, ta));
+        } else {
+          next_time[input] += rng() % 8; // Many ties, within and across inputs
+          TriggerActivity ta = make_ta(next_time[input], static_cast<channel_t>(step));
+          BOOST_TEST(merger.push(input, ta) == slow.push(input, ta));
+        }
+        next_time[input] = std::max(next_time[input], merger.watermark(input));
+
+        if (rng() % 4 == 0) {
+          merger.release(release);
+          slow.release(expected);
+          BOOST_TEST_REQUIRE(output.size() == expected.size());
+        }
+      }
+      merger.drain(release);
+      for (std::size_t i = 0; i < n_inputs; ++i)
+        slow.advance(i, std::numeric_limits<timestamp_t>::max());
+      slow.release(expected);
+
+      BOOST_TEST_REQUIRE(output.size() == expected.size());
+      for (std::size_t i = 0; i < output.size(); ++i) {
+        BOOST_TEST(output[i].time_start == expected[i].time_start);
+        BOOST_TEST(output[i].channel_start == expected[i].channel_start);
+      }
+      BOOST_TEST(merger.size() == 0);
+      BOOST_TEST(merger.counters().n_released == output.size());
+      BOOST_TEST(merger.counters().n_late > 0);
+    }
+  }
+}
+
+} /* namespace triggeralgs */
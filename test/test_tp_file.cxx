@@ -0,0 +1,186 @@
+/**
+ * @file test_tp_file.cxx
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE tp_file
+
+#include "triggeralgs/Issues.hpp"
+#include "triggeralgs/TPFile.hpp"
+#include "triggeralgs/TPGenerator.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+std::string
+temp_path(const std::string& name)
+{
+  return (std::filesystem::temp_directory_path() / ("test_tp_file_" + name)).string();
+}
+
+void
+check_same(const TriggerPrimitive& a, const TriggerPrimitive& b)
+{
+  BOOST_REQUIRE_EQUAL(a.time_start, b.time_start);
+  BOOST_REQUIRE_EQUAL(a.time_over_threshold, b.time_over_threshold);
+  BOOST_REQUIRE_EQUAL(a.time_peak, b.time_peak);
+  BOOST_REQUIRE_EQUAL(a.channel, b.channel);
+  BOOST_REQUIRE_EQUAL(a.adc_integral, b.adc_integral);
+  BOOST_REQUIRE_EQUAL(a.adc_peak, b.adc_peak);
+  BOOST_REQUIRE_EQUAL(a.detid, b.detid);
+  BOOST_REQUIRE(a.type == b.type);
+}
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(write_and_read)
+{
+  std::vector<TriggerPrimitive> tps;
+  TPGenerator generator;
+  generator.generate(100000, tps);
+
+  const std::string path = temp_path("write_and_read.bin");
+  TPFileWriter writer(path);
+  writer.write(Span<const TriggerPrimitive>(tps.data(), 1000));
+  writer.write(Span<const TriggerPrimitive>(tps.data() + 1000, tps.size() - 1000));
+  writer.close();
+
+  for (TPFileReader::Access access : { TPFileReader::Access::kNormal,
+                                       TPFileReader::Access::kSequential,
+                                       TPFileReader::Access::kRandom,
+                                       TPFileReader::Access::kPopulate }) {
+    TPFileReader reader(path, access);
+    BOOST_REQUIRE_EQUAL(reader.size(), tps.size());
+    for (std::size_t first = 0; first < reader.size(); first += 4096) {
+      reader.prefetch(first + 4096, 4096);
+      Span<const TriggerPrimitive> batch = reader.tps(first, 4096);
+      BOOST_REQUIRE_EQUAL(batch.size(), std::min<std::size_t>(4096, tps.size() - first));
+      for (std::size_t i = 0; i < batch.size(); ++i)
+        check_same(batch[i], tps[first + i]);
+    }
+    BOOST_TEST(reader.tps(tps.size() - 10, 100).size() == 10u);
+    BOOST_TEST(reader.tps(tps.size() + 10, 100).empty());
+  }
+
+  TPFileWriter empty_writer(path);
+  empty_writer.close();
+  TPFileReader empty(path);
+  BOOST_TEST(empty.is_open());
+  BOOST_TEST(empty.size() == 0u);
+  empty.prefetch(0, 100);
+
+  std::filesystem::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(convert_text)
+{
+  std::vector<TriggerPrimitive> tps;
+  TPGenerator generator;
+  generator.generate(10000, tps);
+
+  // As written by dump_tp(), with some blank lines and stray whitespace.
+  const std::string text_path = temp_path("convert_text.txt");
+  {
+    std::ofstream text(text_path);
+    for (std::size_t i = 0; i < tps.size(); ++i) {
+      const TriggerPrimitive& tp = tps[i];
+      if (i % 1000 == 0)
+        text << "\n";
+      text << tp.time_start << " " << tp.time_over_threshold << " " << tp.time_peak << " " << tp.channel << " "
+           << tp.adc_integral << " " << tp.adc_peak << " " << tp.detid << " " << static_cast<int>(tp.type)
+           << (i % 3 == 0 ? " \r\n" : "\n");
+    }
+    text << tps.back().time_start + 1 << " 1 2 3 4 5 6 1"; // No final newline
+  }
+
+  const std::string binary_path = temp_path("convert_text.bin");
+  BOOST_REQUIRE_EQUAL(convert_tp_text_file(text_path, binary_path), tps.size() + 1);
+
+  TPFileReader reader(binary_path);
+  BOOST_REQUIRE_EQUAL(reader.size(), tps.size() + 1);
+  for (std::size_t i = 0; i < tps.size(); ++i)
+    check_same(reader.tps()[i], tps[i]);
+  BOOST_TEST(reader.tps()[tps.size()].time_start == tps.back().time_start + 1);
+  BOOST_TEST(reader.tps()[tps.size()].detid == 6u);
+
+  std::filesystem::remove(text_path);
+  std::filesystem::remove(binary_path);
+}
+
+BOOST_AUTO_TEST_CASE(bad_files)
+{
+  const std::string path = temp_path("bad_files");
+  const std::string binary_path = temp_path("bad_files.bin");
+
+  BOOST_CHECK_THROW(TPFileReader(temp_path("does_not_exist")), TPFileError);
+
+  // Malformed text lines.
+  for (const char* line : { "1 2 3 4 5 6 7\n", "1 2 3 4 5 6 7 8 9\n", "1 2 x 4 5 6 7 8\n", "1 2 3 4 5 70000 7 8\n" }) {
+    {
+      std::ofstream text(path);
+      text << "1 2 3 4 5 6 7 1\n" << line;
+    }
+    BOOST_CHECK_THROW(convert_tp_text_file(path, binary_path), TPFileError);
+    BOOST_TEST(!std::filesystem::exists(binary_path)); // Not left half written
+  }
+
+  // Not a binary TP file.
+  {
+    std::ofstream text(path);
+    text << "1 2 3 4 5 6 7 1\n";
+  }
+  BOOST_CHECK_THROW(TPFileReader reader(path), TPFileError);
+
+  // A truncated one.
+  {
+    std::vector<TriggerPrimitive> tps(10);
+    TPFileWriter writer(binary_path);
+    writer.write(Span<const TriggerPrimitive>(tps.data(), tps.size()));
+  }
+  std::filesystem::resize_file(binary_path, sizeof(TPFileHeader) + 5 * sizeof(TriggerPrimitive) - 1);
+  BOOST_CHECK_THROW(TPFileReader reader(binary_path), TPFileError);
+
+  // One written with another TP layout.
+  {
+    TPFileHeader header;
+    header.record_size += 8;
+    std::ofstream binary(binary_path, std::ios::binary);
+    binary.write(reinterpret_cast<const char*>(&header), sizeof(header));
+  }
+  BOOST_CHECK_THROW(TPFileReader reader(binary_path), TPFileError);
+
+  std::filesystem::remove(path);
+  std::filesystem::remove(binary_path);
+}
+
+BOOST_AUTO_TEST_CASE(close_errors)
+{
+  // Writes to /dev/full are buffered, then fail when flushed on closing.
+  if (!std::filesystem::exists("/dev/full"))
+    return;
+  std::vector<TriggerPrimitive> tps(10);
+  {
+    TPFileWriter writer("/dev/full");
+    writer.write(Span<const TriggerPrimitive>(tps.data(), tps.size()));
+    BOOST_CHECK_THROW(writer.close(), TPFileError);
+  }
+  {
+    TPFileWriter writer("/dev/full");
+    writer.write(Span<const TriggerPrimitive>(tps.data(), tps.size()));
+  } // The destructor logs the error rather than throwing
+}
+
+} /* namespace triggeralgs */
@@ -0,0 +1,167 @@
+/**
+ * @file test_tp_generator.cxx
+ *
+ * This is part of the DUNE DAQ Application Framework, copyright 2024.
+ * Licensing/copyright details are in the COPYING file that you should have
+ * received with this code.
+ */
+
+// NOLINTNEXTLINE(build/define_used)
+#define BOOST_TEST_MODULE tp_generator
+
+#include "triggeralgs/Issues.hpp"
+#include "triggeralgs/TPGenerator.hpp"
+
+#include <boost/test/included/unit_test.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace triggeralgs {
+
+namespace {
+
+bool
+same_tps(const std::vector<TriggerPrimitive>& a, const std::vector<TriggerPrimitive>& b)
+{
+  return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const TriggerPrimitive& x, const TriggerPrimitive& y) {
+    return x.time_start == y.time_start && x.channel == y.channel && x.adc_integral == y.adc_integral &&
+           x.time_over_threshold == y.time_over_threshold;
+  });
+}
+
+bool
+in_time_order(const std::vector<TriggerPrimitive>& tps)
+{
+  return std::is_sorted(tps.begin(), tps.end(), [](const TriggerPrimitive& a, const TriggerPrimitive& b) {
+    return a.time_start < b.time_start;
+  });
+}
+
+// Every kind of activity, often enough to appear in a few hundred thousand TPs.
+const nlohmann::json s_busy = { { "track_rate_hz", 1000 },
+                                { "michel_rate_hz", 500 },
+                                { "supernova_rate_hz", 20000 },
+                                { "shower_rate_hz", 200 } };
+
+} // namespace
+
+BOOST_AUTO_TEST_CASE(same_seed_same_stream)
+{
+  TPGenerator first, second, other;
+  first.configure(s_busy);
+  second.configure(s_busy);
+  nlohmann::json other_config = s_busy;
+  other_config["seed"] = 2;
+  other.configure(other_config);
+
+  std::vector<TriggerPrimitive> a, b, c;
+  first.generate(200000, a);
+  second.generate(100000, b);
+  second.generate(100000, b);
+  other.generate(200000, c);
+
+  BOOST_REQUIRE_EQUAL(a.size(), 200000u);
+  BOOST_TEST(same_tps(a, b));
+  BOOST_TEST(!same_tps(a, c));
+
+  // Configuring again starts the stream again.
+  first.configure(nlohmann::json::object());
+  std::vector<TriggerPrimitive> again;
+  first.generate(200000, again);
+  BOOST_TEST(same_tps(a, again));
+}
+
+BOOST_AUTO_TEST_CASE(time_ordered_with_every_activity)
+{
+  TPGenerator generator;
+  generator.configure(s_busy);
+  std::vector<TriggerPrimitive> tps;
+  generator.generate(500000, tps);
+
+  BOOST_TEST(in_time_order(tps));
+  BOOST_TEST(generator.counters().n_tps == tps.size());
+  BOOST_TEST(generator.counters().n_noise > 0u);
+  BOOST_TEST(generator.counters().n_tracks > 0u);
+  BOOST_TEST(generator.counters().n_michels > 0u);
+  BOOST_TEST(generator.counters().n_supernova_events > 0u);
+  BOOST_TEST(generator.counters().n_showers > 0u);
+  for (const TriggerPrimitive& tp : tps) {
+    BOOST_REQUIRE_GE(tp.channel, 0);
+    BOOST_REQUIRE_LT(tp.channel, 2560);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(noise_rate)
+{
+  // 2560 channels at 1 kHz for 0.1 s of data.
+  TPGenerator generator;
+  generator.configure({ { "track_rate_hz", 0 }, { "michel_rate_hz", 0 }, { "shower_rate_hz", 0 }, { "start_time", 0 } });
+  std::vector<TriggerPrimitive> tps;
+  generator.generate_until(6'250'000, tps);
+
+  BOOST_TEST(in_time_order(tps));
+  BOOST_TEST(tps.back().time_start < 6'250'000u);
+  BOOST_TEST(tps.size() > 256000 * 0.98);
+  BOOST_TEST(tps.size() < 256000 * 1.02);
+
+  // The stream carries on from where it stopped.
+  std::vector<TriggerPrimitive> more;
+  generator.generate_until(12'500'000, more);
+  BOOST_TEST(more.front().time_start >= 6'250'000u);
+}
+
+BOOST_AUTO_TEST_CASE(horizontal_tracks)
+{
+  // Only horizontal tracks: each crosses all of its channels at the same time.
+  TPGenerator generator;
+  generator.configure({ { "noise_rate_hz", 0 },
+                        { "michel_rate_hz", 0 },
+                        { "shower_rate_hz", 0 },
+                        { "track_rate_hz", 100 },
+                        { "track_angles_deg", { 0 } },
+                        { "track_min_channels", 100 },
+                        { "track_max_channels", 100 },
+                        { "n_channels", 100000 } });
+  std::vector<TriggerPrimitive> tps;
+  generator.generate(1000, tps);
+
+  BOOST_TEST(generator.counters().n_tracks >= 10u);
+  for (size_t track = 0; track + 100 <= tps.size(); track += 100) {
+    auto [low, high] = std::minmax_element(
+      tps.begin() + track, tps.begin() + track + 100, [](const auto& a, const auto& b) { return a.channel < b.channel; });
+    BOOST_TEST(high->channel - low->channel == 99);
+    BOOST_TEST(tps[track + 99].time_start - tps[track].time_start <= 2u);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(supernova_bursts)
+{
+  TPGenerator generator;
+  generator.configure({ { "noise_rate_hz", 0 },
+                        { "track_rate_hz", 0 },
+                        { "michel_rate_hz", 0 },
+                        { "shower_rate_hz", 0 },
+                        { "start_time", 0 },
+                        { "supernova_rate_hz", 100000 },
+                        { "supernova_burst_interval", 1'000'000 },
+                        { "supernova_burst_length", 100'000 } });
+  std::vector<TriggerPrimitive> tps;
+  generator.generate_until(10'000'000, tps);
+
+  BOOST_TEST(generator.counters().n_supernova_events > 1000u);
+  for (const TriggerPrimitive& tp : tps)
+    BOOST_REQUIRE_LT(tp.time_start % 1'000'000, 100'000u + 20);
+}
+
+BOOST_AUTO_TEST_CASE(bad_configuration)
+{
+  BOOST_CHECK_THROW(TPGenerator().configure({ { "track_angles_deg", { 90 } } }), BadConfiguration);
+  BOOST_CHECK_THROW(TPGenerator().configure({ { "n_channels", 0 } }), BadConfiguration);
+  BOOST_CHECK_THROW(TPGenerator().configure({ { "supernova_burst_interval", 1000 } }), BadConfiguration);
+}
+
+} /* namespace triggeralgs */